@@ -13,11 +13,35 @@
 
 #include "vast/bitmap.hpp"
 
+#include "vast/detail/assert.hpp"
+
 namespace vast {
 
 bitmap::bitmap() : bitmap_{default_bitmap{}} {
 }
 
+bitmap::bitmap(caf::atom_value type) : bitmap{} {
+  VAST_ASSERT(valid_type(type));
+  switch (type) {
+    default:
+      break;
+    case caf::atom("null"):
+      bitmap_ = null_bitmap{};
+      break;
+    case caf::atom("wah"):
+      bitmap_ = wah_bitmap{};
+      break;
+    case caf::atom("roaring"):
+      bitmap_ = roaring_bitmap{};
+      break;
+  }
+}
+
+bool bitmap::valid_type(caf::atom_value type) {
+  return type == caf::atom("ewah") || type == caf::atom("null")
+         || type == caf::atom("wah") || type == caf::atom("roaring");
+}
+
 bitmap::bitmap(size_type n, bool bit) : bitmap{} {
   append_bits(bit, n);
 }
@@ -55,7 +79,10 @@ const bitmap::variant& bitmap::get_data() const {
 }
 
 bool operator==(const bitmap& x, const bitmap& y) {
-  return x.bitmap_ == y.bitmap_;
+  if (x.bitmap_.index() == y.bitmap_.index())
+    return x.bitmap_ == y.bitmap_;
+  // Different encodings may still represent the same bit sequence.
+  return x.size() == y.size() && !any(x ^ y);
 }
 
 bitmap_bit_range::bitmap_bit_range(const bitmap& bm) {
@@ -0,0 +1,228 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/bloom_filter_synopsis.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <typeinfo>
+
+#include <caf/atom.hpp>
+#include <caf/deserializer.hpp>
+#include <caf/serializer.hpp>
+
+#include "vast/address.hpp"
+#include "vast/columnar_table_slice.hpp"
+#include "vast/subnet.hpp"
+
+#include "vast/concept/hashable/xxhash.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/detail/overload.hpp"
+
+namespace vast {
+
+namespace {
+
+// The capacity of filters whose type does not specify one.
+std::atomic<size_t> capacity = bloom_filter_synopsis::default_capacity;
+
+// Computes the i-th bit position of a digest via double hashing, i.e.,
+// h_i(x) = h1(x) + i * h2(x) mod m, where the lower and upper half of the
+// digest act as h1 and h2.
+size_t position(uint64_t digest, size_t i, size_t num_bits) {
+  auto h1 = digest & 0xffffffff;
+  auto h2 = (digest >> 32) | 1;
+  return (h1 + i * h2) % num_bits;
+}
+
+uint64_t hash(const void* ptr, size_t size) {
+  xxhash64 h;
+  h(ptr, size);
+  return static_cast<uint64_t>(static_cast<xxhash64::result_type>(h));
+}
+
+uint64_t hash(const address& addr) {
+  return hash(addr.data().data(), addr.data().size());
+}
+
+uint64_t hash(const subnet& sn) {
+  // Append the prefix length to distinguish subnets of the same network.
+  std::array<uint8_t, 17> buf;
+  auto& bytes = sn.network().data();
+  std::copy(bytes.begin(), bytes.end(), buf.begin());
+  buf[16] = sn.length();
+  return hash(buf.data(), buf.size());
+}
+
+} // namespace <anonymous>
+
+bloom_filter_synopsis::bloom_filter_synopsis(vast::type x, size_t capacity,
+                                             double fp_rate)
+  : synopsis{std::move(x)} {
+  VAST_ASSERT(capacity > 0);
+  VAST_ASSERT(fp_rate > 0 && fp_rate < 1);
+  // The optimal number of bits is m = -n * ln(p) / ln(2)^2 and the optimal
+  // number of hash functions is k = m / n * ln(2).
+  auto ln2 = std::log(2.0);
+  auto n = static_cast<double>(capacity);
+  auto m = std::ceil(-n * std::log(fp_rate) / (ln2 * ln2));
+  auto num_blocks = std::max(size_t{1}, static_cast<size_t>(m + 63) / 64);
+  bits_.resize(num_blocks);
+  auto k = std::round(num_bits() / n * ln2);
+  num_hashes_ = std::max(size_t{1}, static_cast<size_t>(k));
+}
+
+size_t bloom_filter_synopsis::global_capacity() {
+  return capacity.load(std::memory_order_relaxed);
+}
+
+bool bloom_filter_synopsis::global_capacity(size_t n) {
+  if (n == 0)
+    return false;
+  capacity = n;
+  return true;
+}
+
+void bloom_filter_synopsis::add(data_view x) {
+  if (auto h = digest(x))
+    insert(*h);
+}
+
+void bloom_filter_synopsis::add_column(const table_slice& slice, size_t col) {
+  if (slice.implementation_id() != caf::atom("TS_Columnar")) {
+    synopsis::add_column(slice, col);
+    return;
+  }
+  auto& column = static_cast<const columnar_table_slice&>(slice).column_at(col);
+  auto& valid = column.valid.blocks();
+  auto is_valid = [&](size_t row) {
+    return ((valid[row / 64] >> (row % 64)) & 1) != 0;
+  };
+  // Hash all values first, so that the hashing of consecutive values does not
+  // stall on the random memory accesses into the filter.
+  std::vector<uint64_t> digests;
+  digests.reserve(slice.rows());
+  auto hash_all = [&](const auto& xs) {
+    for (size_t row = 0; row < xs.size(); ++row)
+      if (is_valid(row))
+        digests.push_back(hash(xs[row]));
+    return true;
+  };
+  using string_column = columnar_table_slice::string_column;
+  auto handled = caf::visit(detail::overload(
+    [&](const string_column& xs) {
+      for (size_t row = 0; row + 1 < xs.offsets.size(); ++row)
+        if (is_valid(row)) {
+          auto first = xs.offsets[row];
+          auto size = xs.offsets[row + 1] - first;
+          digests.push_back(hash(xs.blob.data() + first, size));
+        }
+      return true;
+    },
+    [&](const std::vector<address>& xs) { return hash_all(xs); },
+    [&](const std::vector<subnet>& xs) { return hash_all(xs); },
+    [](const auto&) { return false; }), column.values);
+  if (!handled) {
+    synopsis::add_column(slice, col);
+    return;
+  }
+  for (auto h : digests)
+    insert(h);
+}
+
+bool bloom_filter_synopsis::lookup(relational_operator op,
+                                   data_view rhs) const {
+  auto test = [&](data_view x) {
+    auto h = digest(x);
+    return !h || contains(*h);
+  };
+  auto test_any = [&](const auto& xs) {
+    for (auto x : *xs)
+      if (test(x))
+        return true;
+    return false;
+  };
+  switch (op) {
+    default:
+      return true;
+    case equal:
+      return test(rhs);
+    case in:
+      return caf::visit(detail::overload(
+        [&](const view<set>& xs) { return test_any(xs); },
+        [&](const view<vector>& xs) { return test_any(xs); },
+        [](const auto&) { return true; }), rhs);
+  }
+}
+
+bool bloom_filter_synopsis::equals(const synopsis& other) const noexcept {
+  if (typeid(other) != typeid(bloom_filter_synopsis))
+    return false;
+  auto& dref = static_cast<const bloom_filter_synopsis&>(other);
+  return type() == dref.type() && num_hashes_ == dref.num_hashes_
+         && bits_ == dref.bits_;
+}
+
+caf::error bloom_filter_synopsis::serialize(caf::serializer& sink) const {
+  return sink(num_hashes_, bits_);
+}
+
+caf::error bloom_filter_synopsis::deserialize(caf::deserializer& source) {
+  return source(num_hashes_, bits_);
+}
+
+size_t bloom_filter_synopsis::num_bits() const noexcept {
+  return bits_.size() * 64;
+}
+
+size_t bloom_filter_synopsis::num_hashes() const noexcept {
+  return num_hashes_;
+}
+
+optional<uint64_t> bloom_filter_synopsis::digest(data_view x) {
+  return caf::visit(detail::overload(
+    [&](std::string_view str) -> optional<uint64_t> {
+      return hash(str.data(), str.size());
+    },
+    [&](const view<address>& addr) -> optional<uint64_t> {
+      return hash(addr);
+    },
+    [&](const view<subnet>& sn) -> optional<uint64_t> {
+      return hash(sn);
+    },
+    [](const auto&) -> optional<uint64_t> {
+      return {};
+    }), x);
+}
+
+void bloom_filter_synopsis::insert(uint64_t digest) {
+  for (size_t i = 0; i < num_hashes_; ++i) {
+    auto j = position(digest, i, num_bits());
+    bits_[j / 64] |= uint64_t{1} << (j % 64);
+  }
+}
+
+bool bloom_filter_synopsis::contains(uint64_t digest) const {
+  for (size_t i = 0; i < num_hashes_; ++i) {
+    auto j = position(digest, i, num_bits());
+    if (((bits_[j / 64] >> (j % 64)) & 1) == 0)
+      return false;
+  }
+  return true;
+}
+
+} // namespace vast
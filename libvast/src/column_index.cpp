@@ -13,11 +13,19 @@
 
 #include "vast/column_index.hpp"
 
+#include <limits>
+
+#include <caf/actor_system_config.hpp>
+
+#include "vast/data.hpp"
+#include "vast/defaults.hpp"
+#include "vast/error.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/load.hpp"
 #include "vast/logger.hpp"
 #include "vast/save.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/view.hpp"
 
 namespace vast {
 
@@ -34,6 +42,42 @@ caf::expected<column_index_ptr> init_res(column_index_ptr res) {
   return res;
 }
 
+// Snapshots of version 0 start with the offset of the last flush. Later
+// versions start with a marker that no offset can take, followed by the
+// version of the mapping from types to value indexes.
+constexpr uint64_t version_marker = std::numeric_limits<uint64_t>::max();
+
+// The persistent state of a column index.
+struct column_snapshot {
+  const type& index_type;
+  std::unique_ptr<value_index>& idx;
+  value_index::size_type& last_flush;
+  uint32_t& version;
+
+  template <class Inspector>
+  friend typename Inspector::result_type
+  inspect(Inspector& f, column_snapshot& x) {
+    if constexpr (Inspector::writes_state) {
+      uint64_t first;
+      if (auto err = f(first))
+        return err;
+      x.version = 0;
+      x.last_flush = first;
+      if (first == version_marker)
+        if (auto err = f(x.version, x.last_flush))
+          return err;
+      detail::value_index_inspect_helper helper{x.index_type, x.idx,
+                                                x.version};
+      return f(helper);
+    } else {
+      auto marker = version_marker;
+      detail::value_index_inspect_helper helper{x.index_type, x.idx,
+                                                x.version};
+      return f(marker, x.version, x.last_flush, helper);
+    }
+  }
+};
+
 } // namespace <anonymous>
 
 caf::expected<column_index_ptr> make_column_index(caf::actor_system& sys,
@@ -42,8 +86,7 @@ caf::expected<column_index_ptr> make_column_index(caf::actor_system& sys,
                                                   size_t column) {
   struct impl : column_index {
     impl(caf::actor_system& sys, path&& fname, type&& ctype, size_t col)
-      : column_index(sys, std::move(ctype), std::move(fname)),
-        col_(col) {
+      : column_index(sys, std::move(ctype), std::move(fname), col) {
         // nop
     }
 
@@ -51,12 +94,32 @@ caf::expected<column_index_ptr> make_column_index(caf::actor_system& sys,
       VAST_TRACE(VAST_ARG(x));
       if (has_skip_attribute_)
         return;
-      auto offset = x->offset();
-      for (table_slice::size_type row = 0; row < x->rows(); ++row)
-        idx_->append(x->at(row, col_), offset + row);
+      if (auto res = idx_->append(*x, column_); !res) {
+        VAST_ERROR(this, "failed to append column", column_, "of slice:",
+                   sys_.render(res.error()));
+        // The index may contain part of the slice, which no log record can
+        // describe.
+        logging_ = false;
+        return;
+      }
+      if (!logging_)
+        return;
+      // Serialize the new rows right away instead of holding on to the slice
+      // until the next flush, which would keep the slice alive.
+      std::vector<data> xs;
+      xs.reserve(x->rows());
+      for (size_t row = 0; row < x->rows(); ++row)
+        xs.emplace_back(materialize(x->at(row, column_)));
+      if (auto err = journal_.append(x->offset(), xs)) {
+        VAST_ERROR(this, "failed to log column", column_, "of slice:",
+                   sys_.render(err));
+        logging_ = false;
+        return;
+      }
+      // Stop logging once writing the index costs less than the log.
+      if (journal_.needs_compaction())
+        logging_ = false;
     }
-
-    size_t col_;
   };
   return init_res(std::make_unique<impl>(sys, std::move(filename),
                                          std::move(column_type), column));
@@ -72,23 +135,51 @@ column_index::~column_index() {
 
 caf::error column_index::init() {
   VAST_TRACE("");
+  if (auto err = journal_.init())
+    return err;
+  // The bitmap type only applies to postings built from now on, so indexes
+  // persisted with another type keep their existing postings.
+  auto bitmap_type = caf::get_or(sys_.config(), "vast.bitmap-type",
+                                 defaults::system::bitmap_type);
+  if (!bitmap::valid_type(bitmap_type))
+    return make_error(ec::invalid_configuration, "invalid bitmap type:",
+                      to_string(bitmap_type));
   // Materialize the index when encountering persistent state.
-  if (exists(filename_)) {
-    detail::value_index_inspect_helper tmp{index_type_, idx_};
-    if (auto err = load(sys_, filename_, last_flush_, tmp)) {
+  if (journal_.has_snapshot()) {
+    column_snapshot tmp{index_type_, idx_, last_flush_, version_};
+    if (auto err = journal_.load_snapshot(tmp)) {
       VAST_ERROR(this, "failed to load value index from disk", sys_.render(err));
       return err;
-    } else {
-      VAST_DEBUG(this, "loaded value index with offset", idx_->offset());
     }
+    idx_->select_bitmap_type(bitmap_type);
+    auto apply = [&](id first, std::vector<data>& xs) -> caf::error {
+      // A crash during compaction leaves records in the log that the
+      // snapshot already contains.
+      if (first < idx_->offset())
+        return caf::none;
+      for (size_t i = 0; i < xs.size(); ++i)
+        if (auto res = idx_->append(make_view(xs[i]), first + i); !res)
+          return res.error();
+      return caf::none;
+    };
+    if (auto err = journal_.replay<id, std::vector<data>>(apply)) {
+      VAST_ERROR(this, "failed to replay value index log", sys_.render(err));
+      return err;
+    }
+    last_flush_ = idx_->offset();
+    logging_ = !journal_.needs_compaction();
+    VAST_DEBUG(this, "loaded value index of version", version_,
+               "with offset", idx_->offset());
     return caf::none;
   }
   // Otherwise construct a new one.
-  idx_ = value_index::make(index_type_);
+  version_ = value_index::current_version;
+  idx_ = value_index::make(index_type_, version_);
   if (idx_ == nullptr) {
     VAST_ERROR(this, "failed to construct index");
     return make_error(ec::unspecified, "failed to construct index");
   }
+  idx_->select_bitmap_type(bitmap_type);
   VAST_DEBUG(this, "constructed new value index");
   return caf::none;
 }
@@ -101,9 +192,20 @@ caf::error column_index::flush_to_disk() {
     return caf::none;
   VAST_DEBUG(this, "flushes index (" << (offset - last_flush_) << '/' << offset,
              "new/total bits)");
+  // Rewriting the index on every flush makes the cost of persisting a column
+  // quadratic in its size. Instead, we log the values of the new rows and
+  // only rewrite the index once the log outgrows it, which amortizes to
+  // linear cost.
+  if (!logging_ || !journal_.has_snapshot()) {
+    column_snapshot tmp{index_type_, idx_, offset, version_};
+    if (auto err = journal_.snapshot(tmp))
+      return err;
+  } else if (auto err = journal_.commit()) {
+    return err;
+  }
+  logging_ = !journal_.needs_compaction();
   last_flush_ = offset;
-  detail::value_index_inspect_helper tmp{index_type_, idx_};
-  return save(sys_, filename_, last_flush_, tmp);
+  return caf::none;
 }
 
 // -- properties -------------------------------------------------------------
@@ -119,11 +221,13 @@ caf::expected<bitmap> column_index::lookup(const predicate& pred) {
 // -- constructors, destructors, and assignment operators ----------------------
 
 column_index::column_index(caf::actor_system& sys, type index_type,
-                           path filename)
+                           path filename, size_t column)
   : has_skip_attribute_(vast::has_skip_attribute(index_type)),
     index_type_(std::move(index_type)),
     filename_(std::move(filename)),
-    sys_(sys) {
+    column_(column),
+    sys_(sys),
+    journal_(sys, filename_) {
   // nop
 }
 
@@ -0,0 +1,108 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/columnar_table_slice.hpp"
+
+#include <caf/deserializer.hpp>
+#include <caf/make_counted.hpp>
+#include <caf/serializer.hpp>
+
+#include "vast/columnar_table_slice_builder.hpp"
+#include "vast/detail/overload.hpp"
+
+namespace vast {
+
+namespace {
+
+using column = columnar_table_slice::column;
+
+column make_column(const type& t) {
+  auto make = [](auto values) {
+    return column{columnar_table_slice::column_values{std::move(values)}, {}};
+  };
+  return caf::visit(detail::overload(
+    [&](const boolean_type&) {
+      return make(columnar_table_slice::bitmap_type{});
+    },
+    [&](const integer_type&) { return make(std::vector<integer>{}); },
+    [&](const count_type&) { return make(std::vector<count>{}); },
+    [&](const real_type&) { return make(std::vector<real>{}); },
+    [&](const timespan_type&) { return make(std::vector<timespan>{}); },
+    [&](const timestamp_type&) { return make(std::vector<timestamp>{}); },
+    [&](const port_type&) { return make(std::vector<port>{}); },
+    [&](const address_type&) { return make(std::vector<address>{}); },
+    [&](const subnet_type&) { return make(std::vector<subnet>{}); },
+    [&](const string_type&) {
+      return make(columnar_table_slice::string_column{});
+    },
+    [&](const auto&) { return make(vector{}); }
+  ), t);
+}
+
+} // namespace <anonymous>
+
+columnar_table_slice::columnar_table_slice(record_type layout)
+  : table_slice{std::move(layout)} {
+  xs_.reserve(layout_.fields.size());
+  for (auto& field : layout_.fields)
+    xs_.emplace_back(make_column(field.type));
+}
+
+columnar_table_slice* columnar_table_slice::copy() const {
+  return new columnar_table_slice(*this);
+}
+
+caf::error columnar_table_slice::serialize(caf::serializer& sink) const {
+  return sink(offset_, rows_, xs_);
+}
+
+caf::error columnar_table_slice::deserialize(caf::deserializer& source) {
+  return source(offset_, rows_, xs_);
+}
+
+data_view columnar_table_slice::at(size_type row, size_type col) const {
+  VAST_ASSERT(row < rows_);
+  VAST_ASSERT(col < columns_);
+  VAST_ASSERT(col < xs_.size());
+  auto& x = xs_[col];
+  VAST_ASSERT(row < x.valid.size());
+  if (!x.valid[row])
+    return caf::none;
+  return caf::visit(detail::overload(
+    [&](const vector& xs) {
+      return make_view(xs[row]);
+    },
+    [&](const bitmap_type& xs) -> data_view {
+      return boolean{xs[row]};
+    },
+    [&](const string_column& xs) -> data_view {
+      auto first = xs.offsets[row];
+      auto last = xs.offsets[row + 1];
+      return std::string_view{xs.blob.data() + first, last - first};
+    },
+    [&](const auto& xs) -> data_view {
+      return xs[row];
+    }
+  ), x.values);
+}
+
+table_slice_builder_ptr columnar_table_slice::make_builder(record_type layout) {
+  return caf::make_counted<columnar_table_slice_builder>(std::move(layout));
+}
+
+caf::atom_value columnar_table_slice::implementation_id() const noexcept {
+  return caf::atom("TS_Columnar");
+}
+
+} // namespace vast
@@ -0,0 +1,148 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/columnar_table_slice_builder.hpp"
+
+#include <type_traits>
+#include <utility>
+
+#include "vast/detail/overload.hpp"
+
+namespace vast {
+
+namespace {
+
+using column = columnar_table_slice::column;
+
+void append_null(column& col) {
+  caf::visit(detail::overload(
+    [](columnar_table_slice::bitmap_type& xs) {
+      xs.push_back(false);
+    },
+    [](columnar_table_slice::string_column& xs) {
+      xs.offsets.push_back(xs.blob.size());
+    },
+    [](auto& xs) {
+      xs.emplace_back();
+    }
+  ), col.values);
+  col.valid.push_back(false);
+}
+
+bool append(column& col, const type& t, data_view x) {
+  if (caf::holds_alternative<caf::none_t>(x)) {
+    append_null(col);
+    return true;
+  }
+  auto added = caf::visit(detail::overload(
+    [&](vector& xs) {
+      auto y = materialize(x);
+      if (!type_check(t, y))
+        return false;
+      xs.push_back(std::move(y));
+      return true;
+    },
+    [&](columnar_table_slice::bitmap_type& xs) {
+      auto y = caf::get_if<view<boolean>>(&x);
+      if (y == nullptr)
+        return false;
+      xs.push_back(*y);
+      return true;
+    },
+    [&](columnar_table_slice::string_column& xs) {
+      auto y = caf::get_if<view<std::string>>(&x);
+      if (y == nullptr)
+        return false;
+      xs.blob.append(y->data(), y->size());
+      xs.offsets.push_back(xs.blob.size());
+      return true;
+    },
+    [&](auto& xs) {
+      using value_type = typename std::decay_t<decltype(xs)>::value_type;
+      auto y = caf::get_if<view<value_type>>(&x);
+      if (y == nullptr)
+        return false;
+      xs.push_back(*y);
+      return true;
+    }
+  ), col.values);
+  if (added)
+    col.valid.push_back(true);
+  return added;
+}
+
+} // namespace <anonymous>
+
+columnar_table_slice_builder::columnar_table_slice_builder(record_type layout)
+  : super{flatten(layout)},
+    col_{0},
+    rows_{0} {
+  VAST_ASSERT(!super::layout().fields.empty());
+}
+
+bool columnar_table_slice_builder::add(data_view x) {
+  lazy_init();
+  if (!append(slice_->xs_[col_], layout().fields[col_].type, x))
+    return false;
+  if (++col_ == layout().fields.size()) {
+    ++rows_;
+    col_ = 0;
+  }
+  return true;
+}
+
+table_slice_ptr columnar_table_slice_builder::finish() {
+  lazy_init();
+  // If we have an incomplete row, we fill the remaining columns with null
+  // values. Better to have incomplete than no data.
+  if (col_ != 0) {
+    for (; col_ < layout().fields.size(); ++col_)
+      append_null(slice_->xs_[col_]);
+    ++rows_;
+  }
+  // Populate slice.
+  slice_->rows_ = rows_;
+  rows_ = 0;
+  col_ = 0;
+  return table_slice_ptr{slice_.release(), false};
+}
+
+size_t columnar_table_slice_builder::rows() const noexcept {
+  return rows_;
+}
+
+void columnar_table_slice_builder::reserve(size_t num_rows) {
+  lazy_init();
+  for (auto& col : slice_->xs_) {
+    caf::visit(detail::overload(
+      [&](columnar_table_slice::string_column& xs) {
+        xs.offsets.reserve(num_rows + 1);
+      },
+      [&](auto& xs) {
+        xs.reserve(num_rows);
+      }
+    ), col.values);
+    col.valid.reserve(num_rows);
+  }
+}
+
+void columnar_table_slice_builder::lazy_init() {
+  if (slice_ == nullptr) {
+    slice_.reset(new columnar_table_slice(layout()));
+    rows_ = 0;
+    col_ = 0;
+  }
+}
+
+} // namespace vast
@@ -191,6 +191,9 @@ bool evaluate(const data& lhs, relational_operator op, const data& rhs) {
       },
       [](const auto& lhs, const set& rhs) {
         return std::find(rhs.begin(), rhs.end(), lhs) != rhs.end();
+      },
+      [](const auto& lhs, const map& rhs) {
+        return rhs.find(lhs) != rhs.end();
       }
     ), x, y);
   };
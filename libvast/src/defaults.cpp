@@ -46,7 +46,13 @@ const char* node_id = "node";
 namespace system {
 
 size_t table_slice_size = 100;
+caf::atom_value table_slice_type = caf::atom("TS_Default");
 size_t max_partition_size = 1_Mi;
+size_t archive_workers = 4;
+size_t indexer_workers = 4;
+caf::atom_value bitmap_type = caf::atom("ewah");
+size_t partition_cache_size = 1_Gi;
+size_t bloom_filter_capacity = 4_Ki;
 
 } // namespace system
 
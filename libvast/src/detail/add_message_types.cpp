@@ -24,6 +24,7 @@
 #include "vast/operator.hpp"
 #include "vast/query_options.hpp"
 #include "vast/schema.hpp"
+#include "vast/segment.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/type.hpp"
 #include "vast/uuid.hpp"
@@ -47,8 +48,11 @@ void add_message_types(caf::actor_system_config& cfg) {
   cfg.add_message_type<type>("vast::type");
   cfg.add_message_type<uuid>("vast::uuid");
   cfg.add_message_type<table_slice_ptr>("vast::table_slice_ptr");
+  cfg.add_message_type<segment_ptr>("vast::segment_ptr");
   // Containers
   cfg.add_message_type<std::vector<event>>("std::vector<vast::event>");
+  cfg.add_message_type<std::vector<table_slice_ptr>>(
+    "std::vector<vast::table_slice_ptr>");
   // Actor-specific messages
   cfg.add_message_type<system::component_map>("vast::system::component_map");
   cfg.add_message_type<system::component_map_entry>(
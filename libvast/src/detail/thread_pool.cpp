@@ -0,0 +1,107 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/detail/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+namespace vast::detail {
+
+thread_pool::thread_pool(size_t num_threads) {
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i)
+    threads_.emplace_back([this] { run(); });
+}
+
+thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> guard{mtx_};
+    done_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : threads_)
+    t.join();
+}
+
+size_t thread_pool::size() const {
+  return threads_.size();
+}
+
+void thread_pool::parallel_for(size_t n,
+                               const std::function<void(size_t)>& f) {
+  // The calling thread takes part in the work, so we only need helpers for
+  // the remaining indexes.
+  auto helpers = std::min(threads_.size(), n > 0 ? n - 1 : 0);
+  if (helpers == 0) {
+    for (size_t i = 0; i < n; ++i)
+      f(i);
+    return;
+  }
+  std::atomic<size_t> next = 0;
+  auto work = [&] {
+    for (auto i = next++; i < n; i = next++)
+      f(i);
+  };
+  // The helpers refer to the local state, so we must wait for all of them
+  // that the pool has started.
+  std::mutex mtx;
+  std::condition_variable cv;
+  auto pending = helpers;
+  auto helper = [&] {
+    work();
+    std::lock_guard<std::mutex> guard{mtx};
+    if (--pending == 0)
+      cv.notify_one();
+  };
+  {
+    std::lock_guard<std::mutex> guard{mtx_};
+    for (size_t i = 0; i < helpers; ++i)
+      tasks_.push_back({&next, helper});
+  }
+  cv_.notify_all();
+  work();
+  // All indexes are taken at this point. Helpers that did not start yet would
+  // find nothing to do, so we withdraw them instead of waiting until the pool
+  // gets to them behind the tasks of other clients.
+  size_t withdrawn = 0;
+  {
+    std::lock_guard<std::mutex> guard{mtx_};
+    auto owned = [&](const task& t) { return t.owner == &next; };
+    auto i = std::remove_if(tasks_.begin(), tasks_.end(), owned);
+    withdrawn = static_cast<size_t>(std::distance(i, tasks_.end()));
+    tasks_.erase(i, tasks_.end());
+  }
+  std::unique_lock<std::mutex> lock{mtx};
+  pending -= withdrawn;
+  cv.wait(lock, [&] { return pending == 0; });
+}
+
+void thread_pool::run() {
+  for (;;) {
+    std::function<void()> f;
+    {
+      std::unique_lock<std::mutex> lock{mtx_};
+      cv_.wait(lock, [&] { return done_ || !tasks_.empty(); });
+      if (tasks_.empty())
+        return;
+      f = std::move(tasks_.front().f);
+      tasks_.pop_front();
+    }
+    f();
+  }
+}
+
+} // namespace vast::detail
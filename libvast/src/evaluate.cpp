@@ -0,0 +1,380 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/evaluate.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include <caf/optional.hpp>
+
+#include "vast/columnar_table_slice.hpp"
+#include "vast/data.hpp"
+#include "vast/die.hpp"
+#include "vast/expression.hpp"
+#include "vast/system/atoms.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/type.hpp"
+#include "vast/view.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/detail/overload.hpp"
+
+namespace vast {
+
+namespace {
+
+// One bit per row of a table slice, beginning at the LSB of the first block.
+using selection = std::vector<uint64_t>;
+
+constexpr size_t block_width = 64;
+
+size_t num_blocks(size_t rows) {
+  return (rows + block_width - 1) / block_width;
+}
+
+// Clears all bits past the last row.
+void clear_tail(selection& xs, size_t rows) {
+  if (auto partial = rows % block_width; partial != 0)
+    xs.back() &= (uint64_t{1} << partial) - 1;
+}
+
+selection make_selection(size_t rows, bool bit) {
+  selection result(num_blocks(rows), bit ? ~uint64_t{0} : uint64_t{0});
+  if (bit)
+    clear_tail(result, rows);
+  return result;
+}
+
+void set(selection& xs, size_t row) {
+  xs[row / block_width] |= uint64_t{1} << (row % block_width);
+}
+
+// Stores `f(xs[i])` as bit *i* in *out* for all *n* values.
+template <class T, class F>
+void evaluate_blocks(const T* xs, size_t n, uint64_t* out, F f) {
+  auto full = n / block_width;
+  for (size_t i = 0; i < full; ++i) {
+    auto block = xs + i * block_width;
+    auto bits = uint64_t{0};
+    // The constant trip count allows the compiler to vectorize this loop.
+    for (size_t j = 0; j < block_width; ++j)
+      bits |= static_cast<uint64_t>(f(block[j])) << j;
+    out[i] = bits;
+  }
+  if (auto rest = n % block_width; rest > 0) {
+    auto block = xs + full * block_width;
+    auto bits = uint64_t{0};
+    for (size_t j = 0; j < rest; ++j)
+      bits |= static_cast<uint64_t>(f(block[j])) << j;
+    out[full] = bits;
+  }
+}
+
+// Compares all values of a fixed-width column with *y*.
+template <class T>
+bool compare(const std::vector<T>& xs, relational_operator op, T y,
+             selection& out) {
+  auto run = [&](auto f) {
+    evaluate_blocks(xs.data(), xs.size(), out.data(), f);
+  };
+  switch (op) {
+    default:
+      return false;
+    case equal:
+      run([y](T x) { return x == y; });
+      break;
+    case not_equal:
+      run([y](T x) { return x != y; });
+      break;
+    case less:
+      run([y](T x) { return x < y; });
+      break;
+    case less_equal:
+      run([y](T x) { return x <= y; });
+      break;
+    case greater:
+      run([y](T x) { return x > y; });
+      break;
+    case greater_equal:
+      run([y](T x) { return x >= y; });
+      break;
+  }
+  return true;
+}
+
+// The minimum number of elements on the right-hand side of `in` for which a
+// membership test probes a hash table rather than scanning the elements.
+constexpr size_t hash_probe_threshold = 16;
+
+// Collects the elements of type `T` of a vector or set as `Key`. Returns
+// `none` if *x* is not a container.
+template <class T, class Key = T>
+caf::optional<std::vector<Key>> elements_of(const data& x) {
+  auto collect = [](const auto& xs) {
+    std::vector<Key> result;
+    for (auto& y : xs) {
+      if constexpr (std::is_same_v<T, data>)
+        result.emplace_back(y);
+      else if (auto z = caf::get_if<T>(&y))
+        result.emplace_back(*z);
+    }
+    return result;
+  };
+  if (auto xs = caf::get_if<vector>(&x))
+    return collect(*xs);
+  if (auto xs = caf::get_if<set>(&x))
+    return collect(*xs);
+  return caf::none;
+}
+
+// Selects all rows whose value `get(row)` is an element of *ys*, or is not an
+// element if *negate* is true.
+template <class Key, class Get>
+void test_membership(size_t rows, Get get, const std::vector<Key>& ys,
+                     bool negate, selection& out) {
+  auto run = [&](auto contains) {
+    for (size_t row = 0; row < rows; ++row)
+      if (contains(get(row)) != negate)
+        set(out, row);
+  };
+  if (ys.size() < hash_probe_threshold) {
+    run([&](const Key& x) {
+      return std::find(ys.begin(), ys.end(), x) != ys.end();
+    });
+  } else {
+    std::unordered_set<Key> table(ys.begin(), ys.end());
+    run([&](const Key& x) { return table.count(x) > 0; });
+  }
+}
+
+// Evaluates a predicate on the storage of a columnar table slice. Returns
+// `none` for combinations of column type, operator, and operand without a
+// specialized implementation.
+caf::optional<selection>
+evaluate_column(const columnar_table_slice::column& col, size_t rows,
+                relational_operator op, const data& rhs) {
+  using bitmap_type = columnar_table_slice::bitmap_type;
+  using string_column = columnar_table_slice::string_column;
+  auto result = make_selection(rows, false);
+  auto handled = caf::visit(detail::overload(
+    [&](const bitmap_type& xs) {
+      auto y = caf::get_if<boolean>(&rhs);
+      if (!y || (op != equal && op != not_equal))
+        return false;
+      auto flip = *y != (op == equal);
+      auto& blocks = xs.blocks();
+      VAST_ASSERT(blocks.size() == result.size());
+      for (size_t i = 0; i < result.size(); ++i)
+        result[i] = flip ? ~blocks[i] : blocks[i];
+      return true;
+    },
+    [&](const string_column& xs) {
+      if (op == in || op == not_in) {
+        auto ys = elements_of<std::string, std::string_view>(rhs);
+        if (!ys)
+          return false;
+        auto get = [&](size_t row) {
+          auto first = xs.offsets[row];
+          return std::string_view{xs.blob.data() + first,
+                                  xs.offsets[row + 1] - first};
+        };
+        test_membership(rows, get, *ys, op == not_in, result);
+        return true;
+      }
+      auto y = caf::get_if<std::string>(&rhs);
+      if (!y || (op != equal && op != not_equal))
+        return false;
+      for (size_t row = 0; row < rows; ++row) {
+        auto first = xs.offsets[row];
+        auto size = xs.offsets[row + 1] - first;
+        auto eq = size == y->size()
+                  && std::memcmp(xs.blob.data() + first, y->data(), size) == 0;
+        if (eq == (op == equal))
+          set(result, row);
+      }
+      return true;
+    },
+    [&](const vector&) {
+      return false;
+    },
+    [&](const auto& xs) {
+      using value_type = typename std::decay_t<decltype(xs)>::value_type;
+      if constexpr (columnar_table_slice::is_fixed_width<value_type>) {
+        if (auto y = caf::get_if<value_type>(&rhs))
+          return compare(xs, op, *y, result);
+      }
+      if constexpr (std::is_arithmetic_v<value_type>) {
+        if (op == in || op == not_in) {
+          auto ys = elements_of<value_type>(rhs);
+          if (!ys)
+            return false;
+          auto get = [&](size_t row) { return xs[row]; };
+          test_membership(rows, get, *ys, op == not_in, result);
+          return true;
+        }
+      }
+      return false;
+    }
+  ), col.values);
+  if (!handled)
+    return caf::none;
+  // Null values behave exactly like evaluating a `nil` data instance.
+  auto& valid = col.valid.blocks();
+  VAST_ASSERT(valid.size() == result.size());
+  if (evaluate(data{}, op, rhs))
+    for (size_t i = 0; i < result.size(); ++i)
+      result[i] |= ~valid[i];
+  else
+    for (size_t i = 0; i < result.size(); ++i)
+      result[i] &= valid[i];
+  clear_tail(result, rows);
+  return result;
+}
+
+// Evaluates a predicate on a column of a table slice.
+selection evaluate_column(const table_slice& slice, size_t col,
+                          relational_operator op, const data& rhs) {
+  auto rows = slice.rows();
+  if (slice.implementation_id() == caf::atom("TS_Columnar")) {
+    auto& x = static_cast<const columnar_table_slice&>(slice);
+    if (auto result = evaluate_column(x.column_at(col), rows, op, rhs))
+      return std::move(*result);
+  }
+  // Fall back to evaluating one cell at a time.
+  auto result = make_selection(rows, false);
+  if (op == in || op == not_in) {
+    if (auto ys = elements_of<data>(rhs);
+        ys && ys->size() >= hash_probe_threshold) {
+      auto get = [&](size_t row) { return materialize(slice.at(row, col)); };
+      test_membership(rows, get, *ys, op == not_in, result);
+      return result;
+    }
+  }
+  for (size_t row = 0; row < rows; ++row)
+    if (evaluate(materialize(slice.at(row, col)), op, rhs))
+      set(result, row);
+  return result;
+}
+
+// Computes the selection of rows that satisfy an expression.
+struct evaluator {
+  evaluator(const table_slice& slice, const type& layout)
+    : slice_{slice},
+      layout_{layout} {
+    // nop
+  }
+
+  selection operator()(caf::none_t) {
+    return make_selection(slice_.rows(), false);
+  }
+
+  selection operator()(const conjunction& c) {
+    auto result = make_selection(slice_.rows(), true);
+    for (auto& operand : c) {
+      auto xs = caf::visit(*this, operand);
+      auto any = uint64_t{0};
+      for (size_t i = 0; i < result.size(); ++i)
+        any |= result[i] &= xs[i];
+      // Stop early when no row can satisfy the conjunction anymore.
+      if (any == 0)
+        break;
+    }
+    return result;
+  }
+
+  selection operator()(const disjunction& d) {
+    auto result = make_selection(slice_.rows(), false);
+    for (auto& operand : d) {
+      auto xs = caf::visit(*this, operand);
+      for (size_t i = 0; i < result.size(); ++i)
+        result[i] |= xs[i];
+    }
+    return result;
+  }
+
+  selection operator()(const negation& n) {
+    auto result = caf::visit(*this, n.expr());
+    for (auto& block : result)
+      block = ~block;
+    clear_tail(result, slice_.rows());
+    return result;
+  }
+
+  selection operator()(const predicate& p) {
+    op_ = p.op;
+    return caf::visit(*this, p.lhs, p.rhs);
+  }
+
+  selection operator()(const attribute_extractor& e, const data& d) {
+    if (e.attr == system::type_atom::value)
+      return make_selection(slice_.rows(), evaluate(layout_.name(), op_, d));
+    // The first column of a table slice holds the event timestamp.
+    if (e.attr == system::time_atom::value)
+      return evaluate_column(slice_, 0, op_, d);
+    return make_selection(slice_.rows(), false);
+  }
+
+  selection operator()(const type_extractor&, const data&) {
+    die("type extractor should have been resolved at this point");
+  }
+
+  selection operator()(const key_extractor&, const data&) {
+    die("key extractor should have been resolved at this point");
+  }
+
+  selection operator()(const data_extractor& e, const data& d) {
+    if (e.type != layout_)
+      return make_selection(slice_.rows(), false);
+    if (auto r = caf::get_if<record_type>(&layout_))
+      if (auto i = r->flat_index_at(e.offset))
+        return evaluate_column(slice_, *i + 1, op_, d);
+    return make_selection(slice_.rows(), false);
+  }
+
+  template <class T>
+  selection operator()(const data& d, const T& x) {
+    return (*this)(x, d);
+  }
+
+  template <class T, class U>
+  selection operator()(const T&, const U&) {
+    return make_selection(slice_.rows(), false);
+  }
+
+  const table_slice& slice_;
+  const type& layout_;
+  relational_operator op_;
+};
+
+} // namespace <anonymous>
+
+ids evaluate(const expression& expr, const table_slice& slice) {
+  type layout = slice.layout(1).name(slice.layout().name());
+  auto xs = caf::visit(evaluator{slice, layout}, expr);
+  ids result;
+  if (slice.offset() > 0)
+    result.append_bits(false, slice.offset());
+  auto rows = slice.rows();
+  for (size_t i = 0; i < xs.size(); ++i)
+    result.append_block(xs[i], std::min(block_width, rows - i * block_width));
+  return result;
+}
+
+} // namespace vast
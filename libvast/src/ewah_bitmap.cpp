@@ -297,4 +297,39 @@ ewah_bitmap_range bit_range(const ewah_bitmap& bm) {
   return ewah_bitmap_range{bm};
 }
 
+ewah_bitmap_cursor::ewah_bitmap_cursor(const ewah_bitmap& bm)
+  : next_{bm.blocks().data()},
+    end_{bm.blocks().data() + bm.blocks().size()} {
+  scan();
+}
+
+void ewah_bitmap_cursor::skip(size_type n) {
+  if (clean_ > 0) {
+    VAST_ASSERT(n <= clean_);
+    clean_ -= n;
+  } else {
+    VAST_ASSERT(n <= dirty_);
+    literals_ += n;
+    dirty_ -= n;
+  }
+  scan();
+}
+
+void ewah_bitmap_cursor::scan() {
+  while (clean_ == 0 && dirty_ == 0 && next_ != end_) {
+    if (next_ + 1 == end_) {
+      // The last block is always dirty and not accounted for by a marker.
+      literals_ = next_++;
+      dirty_ = 1;
+    } else {
+      auto marker = *next_++;
+      clean_ = word_type::marker_num_clean(marker);
+      fill_ = word_type::marker_type(marker);
+      dirty_ = word_type::marker_num_dirty(marker);
+      literals_ = next_;
+      next_ += dirty_;
+    }
+  }
+}
+
 } // namespace vast
@@ -26,7 +26,9 @@
 #include "vast/event.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/system/atoms.hpp"
+#include "vast/table_slice.hpp"
 #include "vast/type.hpp"
+#include "vast/view.hpp"
 
 namespace vast {
 
@@ -271,6 +273,45 @@ expected<void> validator::operator()(const key_extractor&, const data&) {
   return no_error;
 }
 
+namespace {
+
+// Replaces the names of enumeration fields in the RHS of a predicate with
+// their numeric values, because events and table slices hold the values as
+// counts. Names that are not fields of the enumeration remain strings, which
+// match no value.
+data resolve_enumeration(const type& t, const data& d) {
+  if (auto a = caf::get_if<alias_type>(&t))
+    return resolve_enumeration(a->value_type, d);
+  auto e = caf::get_if<enumeration_type>(&t);
+  if (e == nullptr)
+    return d;
+  auto resolve = [&](const data& x) -> data {
+    if (auto str = caf::get_if<std::string>(&x)) {
+      auto& fields = e->fields;
+      auto i = std::find(fields.begin(), fields.end(), *str);
+      if (i != fields.end())
+        return count{static_cast<count>(i - fields.begin())};
+    }
+    return x;
+  };
+  if (auto xs = caf::get_if<vector>(&d)) {
+    vector result;
+    result.reserve(xs->size());
+    for (auto& x : *xs)
+      result.push_back(resolve(x));
+    return result;
+  }
+  if (auto xs = caf::get_if<set>(&d)) {
+    set result;
+    for (auto& x : *xs)
+      result.insert(resolve(x));
+    return result;
+  }
+  return resolve(d);
+}
+
+} // namespace <anonymous>
+
 type_resolver::type_resolver(const type& t) : type_{t} {
 }
 
@@ -338,12 +379,14 @@ expected<expression> type_resolver::operator()(const type_extractor& ex,
       auto& value_type = f.trace.back()->type;
       if (congruent(value_type, ex.type)) {
         auto x = data_extractor{type_, f.offset};
-        dis.emplace_back(predicate{std::move(x), op_, d});
+        auto rhs = resolve_enumeration(value_type, d);
+        dis.emplace_back(predicate{std::move(x), op_, std::move(rhs)});
       }
     }
   } else if (congruent(type_, ex.type)) {
     auto x = data_extractor{type_, offset{}};
-    dis.emplace_back(predicate{std::move(x), op_, d});
+    auto rhs = resolve_enumeration(type_, d);
+    dis.emplace_back(predicate{std::move(x), op_, std::move(rhs)});
   }
   if (dis.empty())
     return expression{}; // did not resolve
@@ -373,15 +416,17 @@ expected<expression> type_resolver::operator()(const key_extractor& ex,
         return make_error(ec::type_clash, *t, op_, d);
     }
     for (auto& pair : suffixes) {
+      auto rhs = resolve_enumeration(*r->at(pair.first), d);
       auto x = data_extractor{type_, std::move(pair.first)};
-      dis.emplace_back(predicate{std::move(x), op_, d});
+      dis.emplace_back(predicate{std::move(x), op_, std::move(rhs)});
     }
   // Second, try to interpret the key as the name of a single type.
   } else if (ex.key[0] == type_.name()) {
     if (!compatible(type_, op_, d))
       return make_error(ec::type_clash, type_, op_, d);
     auto x = data_extractor{type_, {}};
-    dis.emplace_back(predicate{std::move(x), op_, d});
+    auto rhs = resolve_enumeration(type_, d);
+    dis.emplace_back(predicate{std::move(x), op_, std::move(rhs)});
   }
   if (dis.empty())
     return expression{}; // did not resolve
@@ -530,6 +575,73 @@ bool event_evaluator::operator()(const data_extractor& e, const data& d) {
   return false;
 }
 
+table_slice_row_evaluator::table_slice_row_evaluator(const table_slice& slice,
+                                                     size_t row,
+                                                     const type& layout)
+  : slice_{slice},
+    row_{row},
+    layout_{layout} {
+  VAST_ASSERT(row < slice.rows());
+}
+
+bool table_slice_row_evaluator::operator()(caf::none_t) {
+  return false;
+}
+
+bool table_slice_row_evaluator::operator()(const conjunction& c) {
+  for (auto& op : c)
+    if (!caf::visit(*this, op))
+      return false;
+  return true;
+}
+
+bool table_slice_row_evaluator::operator()(const disjunction& d) {
+  for (auto& op : d)
+    if (caf::visit(*this, op))
+      return true;
+  return false;
+}
+
+bool table_slice_row_evaluator::operator()(const negation& n) {
+  return !caf::visit(*this, n.expr());
+}
+
+bool table_slice_row_evaluator::operator()(const predicate& p) {
+  op_ = p.op;
+  return caf::visit(*this, p.lhs, p.rhs);
+}
+
+bool table_slice_row_evaluator::operator()(const attribute_extractor& e,
+                                           const data& d) {
+  if (e.attr == system::type_atom::value)
+    return evaluate(layout_.name(), op_, d);
+  if (e.attr == system::time_atom::value)
+    return evaluate(materialize(slice_.at(row_, 0)), op_, d);
+  return false;
+}
+
+bool table_slice_row_evaluator::operator()(const type_extractor&,
+                                           const data&) {
+  die("type extractor should have been resolved at this point");
+}
+
+bool table_slice_row_evaluator::operator()(const key_extractor&,
+                                           const data&) {
+  die("key extractor should have been resolved at this point");
+}
+
+bool table_slice_row_evaluator::operator()(const data_extractor& e,
+                                           const data& d) {
+  if (e.type != layout_)
+    return false;
+  auto r = caf::get_if<record_type>(&layout_);
+  if (!r)
+    return false;
+  // The first column of a table slice holds the event timestamp.
+  if (auto i = r->flat_index_at(e.offset))
+    return evaluate(materialize(slice_.at(row_, *i + 1)), op_, d);
+  return false;
+}
 
 matcher::matcher(const type& t) : type_{t} {
   // nop
@@ -431,6 +431,26 @@ bool rm(const path& p) {
   return false;
 }
 
+bool mv(const path& from, const path& to) {
+  return VAST_MOVE_FILE(from.str().data(), to.str().data());
+}
+
+size_t disk_usage(const path& p) {
+  auto t = p.kind();
+  if (t == path::type::directory) {
+    size_t result = 0;
+    for (auto& entry : directory{p})
+      result += disk_usage(entry);
+    return result;
+  }
+#ifdef VAST_POSIX
+  struct stat st;
+  if (t == path::type::regular_file && ::stat(p.str().data(), &st) == 0)
+    return static_cast<size_t>(st.st_size);
+#endif // VAST_POSIX
+  return 0;
+}
+
 expected<void> mkdir(const path& p) {
   auto components = split(p);
   if (components.empty())
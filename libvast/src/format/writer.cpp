@@ -13,12 +13,24 @@
 
 #include "vast/format/writer.hpp"
 
+#include "vast/event.hpp"
+#include "vast/ids.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/to_events.hpp"
+
 namespace vast::format {
 
 writer::~writer() {
   // nop
 }
 
+caf::expected<void> writer::write(const table_slice& x, const ids& rows) {
+  for (auto& e : to_events(x, rows))
+    if (auto r = write(e); !r)
+      return r;
+  return caf::no_error;
+}
+
 caf::expected<void> writer::flush() {
   return caf::no_error;
 }
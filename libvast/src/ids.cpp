@@ -13,6 +13,8 @@
 
 #include "vast/ids.hpp"
 
+#include "vast/bitmap_algorithms.hpp"
+
 namespace vast {
 
 ids make_ids(std::initializer_list<id_range> ranges, size_t min_size,
@@ -35,4 +37,13 @@ ids make_ids(std::initializer_list<id_range> ranges, size_t min_size,
   return result;
 }
 
+ids take(const ids& xs, size_t n) {
+  if (n == 0)
+    return {};
+  auto last = select(xs, n);
+  if (last == ids::word_type::npos)
+    return xs;
+  return xs & make_ids({{0, last + 1}});
+}
+
 } // namespace vast
@@ -0,0 +1,201 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include "vast/detail/posix.hpp"
+#include "vast/error.hpp"
+#include "vast/journal.hpp"
+#include "vast/load.hpp"
+#include "vast/save.hpp"
+
+namespace vast {
+
+namespace {
+
+// Each record in the log starts with its size as 64-bit little-endian integer.
+constexpr size_t header_size = sizeof(uint64_t);
+
+void write_header(char* out, uint64_t x) {
+  for (size_t i = 0; i < header_size; ++i)
+    out[i] = static_cast<char>((x >> (i * 8)) & 0xFF);
+}
+
+uint64_t read_header(const char* in) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < header_size; ++i)
+    result |= uint64_t{static_cast<unsigned char>(in[i])} << (i * 8);
+  return result;
+}
+
+// Writes a buffer at an offset into a file and flushes the file to disk.
+caf::error write_file(const path& filename, int flags, uint64_t offset,
+                      const std::vector<char>& buf) {
+  auto fd = ::open(filename.str().c_str(), O_WRONLY | O_CREAT | flags, 0644);
+  if (fd < 0)
+    return make_error(ec::filesystem_error, "failed to open file", filename,
+                      std::strerror(errno));
+  auto ok = detail::seek(fd, offset)
+            && detail::write(fd, buf.data(), buf.size()) && detail::fsync(fd);
+  auto closed = detail::close(fd);
+  if (!ok || !closed)
+    return make_error(ec::filesystem_error, "failed to write file", filename);
+  return caf::none;
+}
+
+// Flushes the directory that contains a file to disk, which makes creating,
+// renaming, or removing the file durable.
+caf::error sync_directory(const path& filename) {
+  auto dir = filename.parent();
+  if (dir.empty())
+    dir = ".";
+  auto fd = ::open(dir.str().c_str(), O_RDONLY);
+  if (fd < 0)
+    return make_error(ec::filesystem_error, "failed to open directory", dir,
+                      std::strerror(errno));
+  auto ok = detail::fsync(fd);
+  detail::close(fd);
+  if (!ok)
+    return make_error(ec::filesystem_error, "failed to sync directory", dir);
+  return caf::none;
+}
+
+// Writes a file under a temporary name and renames it afterwards, such that
+// readers either see the old or the new contents, even after a power loss.
+caf::error replace_file(const path& filename, const std::vector<char>& buf) {
+  auto tmp = filename;
+  tmp += ".tmp";
+  if (auto err = write_file(tmp, O_TRUNC, 0, buf))
+    return err;
+  if (!mv(tmp, filename))
+    return make_error(ec::filesystem_error, "failed to rename file", tmp,
+                      filename);
+  return sync_directory(filename);
+}
+
+} // namespace <anonymous>
+
+journal::journal(caf::actor_system& sys, path filename)
+  : sys_{sys},
+    filename_{std::move(filename)},
+    log_{filename_},
+    manifest_{filename_} {
+  log_ += ".log";
+  manifest_ += ".manifest";
+}
+
+bool journal::has_snapshot() const {
+  return exists(filename_);
+}
+
+caf::error journal::init() {
+  pending_.clear();
+  if (exists(manifest_))
+    return load(sys_, manifest_, snapshot_size_, log_size_);
+  // A snapshot without a manifest stems from an older version or a crash
+  // during the first compaction; either way, the log holds nothing of value.
+  log_size_ = 0;
+  snapshot_size_ = 0;
+  if (has_snapshot()) {
+    std::ifstream in{filename_.str(), std::ios::binary | std::ios::ate};
+    if (!in)
+      return make_error(ec::filesystem_error, "failed to open file",
+                        filename_);
+    snapshot_size_ = static_cast<uint64_t>(in.tellg());
+  }
+  return caf::none;
+}
+
+caf::error journal::commit() {
+  if (pending_.empty())
+    return caf::none;
+  // Overwrite what a crash may have left behind after the last record. The
+  // records must be on disk before the manifest references them.
+  auto created = !exists(log_);
+  if (auto err = write_file(log_, 0, log_size_, pending_))
+    return err;
+  if (created)
+    if (auto err = sync_directory(log_))
+      return err;
+  log_size_ += pending_.size();
+  pending_.clear();
+  return write_manifest();
+}
+
+caf::error journal::write_snapshot(const std::vector<char>& buf) {
+  if (auto dir = filename_.parent(); !dir.empty() && !exists(dir))
+    if (auto result = mkdir(dir); !result)
+      return result.error();
+  if (auto err = replace_file(filename_, buf))
+    return err;
+  snapshot_size_ = buf.size();
+  log_size_ = 0;
+  pending_.clear();
+  if (auto err = write_manifest())
+    return err;
+  // The manifest no longer references the log, so a failure to remove it
+  // only wastes space.
+  if (exists(log_))
+    rm(log_);
+  return caf::none;
+}
+
+void journal::write_record(const std::vector<char>& buf) {
+  auto offset = pending_.size();
+  pending_.resize(offset + header_size + buf.size());
+  write_header(pending_.data() + offset, buf.size());
+  std::copy(buf.begin(), buf.end(), pending_.begin() + offset + header_size);
+}
+
+caf::error journal::write_manifest() {
+  std::vector<char> buf;
+  if (auto err = save(sys_, buf, snapshot_size_, log_size_))
+    return err;
+  return replace_file(manifest_, buf);
+}
+
+caf::error journal::for_each_record(
+  std::function<caf::error(const std::vector<char>&)> f) {
+  if (log_size_ == 0)
+    return caf::none;
+  std::vector<char> log(log_size_);
+  std::ifstream in{log_.str(), std::ios::binary};
+  if (!in)
+    return make_error(ec::filesystem_error, "failed to open file", log_);
+  in.read(log.data(), log.size());
+  if (static_cast<uint64_t>(in.gcount()) != log_size_)
+    return make_error(ec::filesystem_error, "truncated log", log_);
+  std::vector<char> record;
+  for (size_t i = 0; i < log.size();) {
+    if (log.size() - i < header_size)
+      return make_error(ec::format_error, "incomplete record header", log_);
+    auto size = read_header(log.data() + i);
+    i += header_size;
+    if (log.size() - i < size)
+      return make_error(ec::format_error, "incomplete record", log_);
+    record.assign(log.data() + i, log.data() + i + size);
+    i += size;
+    if (auto err = f(record))
+      return err;
+  }
+  return caf::none;
+}
+
+} // namespace vast
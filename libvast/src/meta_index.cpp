@@ -13,12 +13,15 @@
 
 #include "vast/meta_index.hpp"
 
+#include <typeinfo>
+
 #include "vast/expression.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/atoms.hpp"
 #include "vast/table_index.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/time.hpp"
+#include "vast/timestamp_synopsis.hpp"
 
 #include "vast/detail/overload.hpp"
 #include "vast/detail/set_operations.hpp"
@@ -37,6 +40,7 @@ void meta_index::add(const uuid& partition, const table_slice& slice) {
   auto& layout = slice.layout();
   if (blacklisted_layouts_.count(layout) == 1)
     return;
+  dirty_partitions_.insert(partition);
   auto i = part_synopsis.find(layout);
   table_synopsis* table_syn;
   if (i != part_synopsis.end()) {
@@ -59,8 +63,7 @@ void meta_index::add(const uuid& partition, const table_slice& slice) {
   VAST_ASSERT(table_syn->size() == slice.columns());
   for (size_t col = 0; col < slice.columns(); ++col)
     if (auto& syn = (*table_syn)[col])
-      for (size_t row = 0; row < slice.rows(); ++row)
-        syn->add(slice.at(row, col));
+      syn->add_column(slice, col);
 }
 
 std::vector<uuid> meta_index::lookup(const expression& expr) const {
@@ -114,19 +117,50 @@ std::vector<uuid> meta_index::lookup(const expression& expr) const {
       // field to determine whether the synopsis should be queried.
       auto search = [&](auto match) {
         VAST_ASSERT(caf::holds_alternative<data>(x.rhs));
-        auto& rhs = caf::get<data>(x.rhs);
+        auto rhs = make_view(caf::get<data>(x.rhs));
+        // Keep the number of partitions that we have to scan small. Usually,
+        // only the active partition receives new data.
+        if (dirty_partitions_.size() > 1)
+          rebuild();
         result_type result;
         auto found_matching_synopsis = false;
-        for (auto& [part_id, part_syn] : partition_synopses_)
-          for (auto& [layout, table_syn] : part_syn)
+        auto emit = [&](const uuid& part_id) { result.push_back(part_id); };
+        for (auto& [field, syns] : fields_) {
+          if (!match(field))
+            continue;
+          found_matching_synopsis = true;
+          for (auto& [part_id, syn] : syns.synopses)
+            if (syn->lookup(x.op, rhs))
+              result.push_back(part_id);
+          if (syns.time_synopses.empty())
+            continue;
+          auto ts = caf::get_if<timestamp>(&rhs);
+          if (ts && x.op == equal)
+            syns.time_ranges.stab(*ts, emit);
+          else if (ts && (x.op == less || x.op == less_equal))
+            syns.time_ranges.starting_before(*ts, x.op == less_equal, emit);
+          else if (ts && (x.op == greater || x.op == greater_equal))
+            syns.time_ranges.ending_after(*ts, x.op == greater_equal, emit);
+          else
+            for (auto& [part_id, syn] : syns.time_synopses)
+              if (syn->lookup(x.op, rhs))
+                result.push_back(part_id);
+        }
+        // The time ranges of dirty partitions may be out of date, so we check
+        // their synopses directly.
+        for (auto& part_id : dirty_partitions_) {
+          auto part = partition_synopses_.find(part_id);
+          VAST_ASSERT(part != partition_synopses_.end());
+          for (auto& [layout, table_syn] : part->second)
             for (size_t i = 0; i < table_syn.size(); ++i)
               if (table_syn[i] && match(layout.fields[i])) {
                 found_matching_synopsis = true;
-                if (table_syn[i]->lookup(x.op, make_view(rhs)))
-                  if (result.empty() || result.back() != part_id)
-                    result.push_back(part_id);
+                if (table_syn[i]->lookup(x.op, rhs))
+                  result.push_back(part_id);
               }
+        }
         std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
         return found_matching_synopsis ? result : all_partitions();
       };
       return caf::visit(detail::overload(
@@ -166,6 +200,38 @@ std::vector<uuid> meta_index::lookup(const expression& expr) const {
   ), expr);
 }
 
+void meta_index::rebuild() const {
+  VAST_DEBUG(this, "rebuilds field synopses for",
+             partition_synopses_.size(), "partitions");
+  fields_.clear();
+  for (auto& [part_id, part_syn] : partition_synopses_)
+    for (auto& [layout, table_syn] : part_syn)
+      for (size_t i = 0; i < table_syn.size(); ++i) {
+        auto syn = table_syn[i].get();
+        if (syn == nullptr)
+          continue;
+        auto& syns = fields_[layout.fields[i]];
+        // Derived types other than our own may change the lookup semantics.
+        auto& tid = typeid(*syn);
+        if (tid == typeid(time_synopsis) || tid == typeid(timestamp_synopsis))
+          syns.time_synopses.emplace_back(
+            part_id, static_cast<const time_synopsis*>(syn));
+        else
+          syns.synopses.emplace_back(part_id, syn);
+      }
+  using interval = decltype(field_synopses::time_ranges)::interval;
+  for (auto& [field, syns] : fields_) {
+    std::vector<interval> xs;
+    xs.reserve(syns.time_synopses.size());
+    // Empty synopses have an inverted range and match no ordered predicate.
+    for (auto& [part_id, syn] : syns.time_synopses)
+      if (syn->min() <= syn->max())
+        xs.push_back({syn->min(), syn->max(), part_id});
+    syns.time_ranges = detail::interval_tree<timestamp, uuid>{std::move(xs)};
+  }
+  dirty_partitions_.clear();
+}
+
 void meta_index::factory(caf::atom_value factory_id,
                          synopsis_factory f) {
   factory_id_ = factory_id;
@@ -186,7 +252,10 @@ caf::error inspect(caf::deserializer& source, meta_index& x) {
     x.factory(ex->first, ex->second);
   else
     return std::move(ex.error());
-  return source(x.partition_synopses_);
+  if (auto err = source(x.partition_synopses_))
+    return err;
+  x.rebuild();
+  return caf::none;
 }
 
 } // namespace vast
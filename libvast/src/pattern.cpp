@@ -11,7 +11,9 @@
  * contained in the LICENSE file.                                             *
  ******************************************************************************/
 
+#include <cctype>
 #include <regex>
+#include <variant>
 
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/pattern.hpp"
@@ -20,6 +22,131 @@
 
 namespace vast {
 
+namespace {
+
+constexpr std::string_view wildcard = ".*";
+
+bool is_meta(char c) {
+  return std::string_view{"\\^$.|?*+()[]{}"}.find(c) != std::string_view::npos;
+}
+
+// Unescapes *str* if it denotes a regex that matches only a literal string.
+bool unescape_literal(std::string_view str, std::string& result) {
+  result.clear();
+  for (auto i = str.begin(); i != str.end(); ++i) {
+    if (*i == '\\') {
+      // Only escaped punctuation denotes a literal; `\w` and friends do not.
+      if (++i == str.end() || std::isalnum(static_cast<unsigned char>(*i)))
+        return false;
+    } else if (is_meta(*i)) {
+      return false;
+    }
+    result += *i;
+  }
+  return true;
+}
+
+bool starts_with(std::string_view str, std::string_view prefix) {
+  return str.substr(0, prefix.size()) == prefix;
+}
+
+bool ends_with(std::string_view str, std::string_view suffix) {
+  return str.size() >= suffix.size()
+         && str.substr(str.size() - suffix.size()) == suffix;
+}
+
+// The characters that `.` does not match in ECMAScript regexes.
+constexpr std::string_view line_terminators = "\n\r";
+
+bool has_line_terminator(std::string_view str) {
+  return str.find_first_of(line_terminators) != std::string_view::npos;
+}
+
+} // namespace <anonymous>
+
+/// The compiled form of a pattern. Literal strings with optional leading and
+/// trailing wildcards use plain string comparison, everything else goes
+/// through the regex engine.
+class pattern::matcher {
+public:
+  explicit matcher(std::string_view str) {
+    // Try to detect a literal with optional wildcards, e.g., `foo.*`.
+    auto leading = starts_with(str, wildcard);
+    if (leading)
+      str.remove_prefix(wildcard.size());
+    auto trailing = ends_with(str, wildcard);
+    if (trailing)
+      str.remove_suffix(wildcard.size());
+    // A trailing `\.*` repeats an escaped dot, which unescape_literal rejects
+    // because of the dangling backslash.
+    std::string literal;
+    if (unescape_literal(str, literal)) {
+      leading_ = leading;
+      trailing_ = trailing;
+      engine_ = std::move(literal);
+      return;
+    }
+    try {
+      engine_ = std::regex{original(str, leading, trailing),
+                           std::regex::ECMAScript | std::regex::optimize};
+    } catch (const std::regex_error&) {
+      // Invalid expressions match nothing.
+      engine_ = std::monostate{};
+    }
+  }
+
+  bool match(std::string_view str) const {
+    if (auto literal = std::get_if<std::string>(&engine_)) {
+      // The wildcards must not cover any line terminators.
+      auto n = literal->size();
+      if (leading_ && trailing_) {
+        auto first = str.find_first_of(line_terminators);
+        if (first == std::string_view::npos)
+          return str.find(*literal) != std::string_view::npos;
+        // The literal must span all line terminators.
+        auto last = str.find_last_of(line_terminators);
+        auto i = str.find(*literal, last >= n ? last - n + 1 : 0);
+        return i != std::string_view::npos && i <= first;
+      }
+      if (leading_)
+        return ends_with(str, *literal)
+               && !has_line_terminator(str.substr(0, str.size() - n));
+      if (trailing_)
+        return starts_with(str, *literal)
+               && !has_line_terminator(str.substr(n));
+      return str == *literal;
+    }
+    if (auto rx = std::get_if<std::regex>(&engine_))
+      return std::regex_match(str.begin(), str.end(), *rx);
+    return false;
+  }
+
+  bool search(std::string_view str) const {
+    // Surrounding wildcards make no difference when searching.
+    if (auto literal = std::get_if<std::string>(&engine_))
+      return str.find(*literal) != std::string_view::npos;
+    if (auto rx = std::get_if<std::regex>(&engine_))
+      return std::regex_search(str.begin(), str.end(), *rx);
+    return false;
+  }
+
+private:
+  static std::string original(std::string_view str, bool leading,
+                              bool trailing) {
+    std::string result;
+    if (leading)
+      result += wildcard;
+    result += str;
+    if (trailing)
+      result += wildcard;
+    return result;
+  }
+
+  bool leading_ = false;
+  bool trailing_ = false;
+  std::variant<std::monostate, std::string, std::regex> engine_;
+};
+
 pattern pattern::glob(std::string_view str) {
   std::string rx;
   std::regex_replace(std::back_inserter(rx), str.begin(), str.end(),
@@ -28,15 +155,21 @@ pattern pattern::glob(std::string_view str) {
   return pattern{std::regex_replace(rx, std::regex("\\?"), ".")};
 }
 
+pattern::pattern() {
+  compile();
+}
+
 pattern::pattern(std::string str) : str_(std::move(str)) {
+  compile();
 }
 
 bool pattern::match(std::string_view str) const {
-  return std::regex_match(str.begin(), str.end(), std::regex{str_});
+  // A moved-from pattern has no matcher and matches nothing.
+  return matcher_ != nullptr && matcher_->match(str);
 }
 
 bool pattern::search(std::string_view str) const {
-  return std::regex_search(str.begin(), str.end(), std::regex{str_});
+  return matcher_ != nullptr && matcher_->search(str);
 }
 
 const std::string& pattern::string() const {
@@ -49,6 +182,7 @@ pattern& pattern::operator+=(const pattern& other) {
 
 pattern& pattern::operator+=(std::string_view other) {
   str_ += other;
+  compile();
   return *this;
 }
 
@@ -61,6 +195,7 @@ pattern& pattern::operator|=(std::string_view other) {
   str_ += ")|(";
   str_.append(other.begin(), other.end());
   str_ += ')';
+  compile();
   return *this;
 }
 
@@ -73,6 +208,7 @@ pattern& pattern::operator&=(std::string_view other) {
   str_ += ")(";
   str_.append(other.begin(), other.end());
   str_ += ')';
+  compile();
   return *this;
 }
 
@@ -116,6 +252,10 @@ bool operator<(const pattern& lhs, const pattern& rhs) {
   return lhs.str_ < rhs.str_;
 }
 
+void pattern::compile() {
+  matcher_ = std::make_shared<const matcher>(str_);
+}
+
 bool convert(const pattern& p, json& j) {
   j = to_string(p);
   return true;
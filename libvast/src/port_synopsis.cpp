@@ -0,0 +1,41 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/port_synopsis.hpp"
+
+#include <limits>
+
+namespace vast {
+
+port_synopsis::port_synopsis(vast::type x)
+  : super{std::move(x), std::numeric_limits<port::number_type>::max(),
+          std::numeric_limits<port::number_type>::min()} {
+  // nop
+}
+
+void port_synopsis::add(data_view x) {
+  if (auto p = caf::get_if<view<port>>(&x))
+    update(p->number());
+}
+
+bool port_synopsis::lookup(relational_operator op, data_view rhs) const {
+  // Equal numbers do not imply equal ports, so we cannot rule out inequality.
+  if (op == not_equal)
+    return true;
+  if (auto p = caf::get_if<view<port>>(&rhs))
+    return lookup_impl(op, p->number());
+  return true;
+}
+
+} // namespace vast
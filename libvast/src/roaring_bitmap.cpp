@@ -0,0 +1,677 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include <array>
+#include <utility>
+
+#include "vast/roaring_bitmap.hpp"
+
+namespace vast {
+
+namespace {
+
+using block_type = roaring_bitmap::block_type;
+using container = roaring_bitmap::container;
+using size_type = roaring_bitmap::size_type;
+using word_type = roaring_bitmap::word_type;
+
+using buffer = std::array<block_type, roaring_bitmap::container_blocks>;
+
+constexpr auto container_bits = roaring_bitmap::container_bits;
+constexpr auto container_blocks = roaring_bitmap::container_blocks;
+constexpr auto array_capacity = roaring_bitmap::array_capacity;
+constexpr auto npos = word_type::npos;
+
+// -- truth tables -------------------------------------------------------------
+
+bool test(roaring_bitmap::truth_table op, bool x, bool y) {
+  return (op >> (2 * x + y)) & 1;
+}
+
+// Applies a bitwise operation given by its truth table on two block arrays.
+void apply(roaring_bitmap::truth_table op, const buffer& lhs,
+           const buffer& rhs, buffer& result) {
+  auto fill = [&](bool x, bool y) {
+    return test(op, x, y) ? word_type::all : word_type::none;
+  };
+  auto f00 = fill(0, 0);
+  auto f01 = fill(0, 1);
+  auto f10 = fill(1, 0);
+  auto f11 = fill(1, 1);
+  for (auto i = 0u; i < container_blocks; ++i) {
+    auto x = lhs[i];
+    auto y = rhs[i];
+    result[i] = (~x & ~y & f00) | (~x & y & f01) | (x & ~y & f10)
+                | (x & y & f11);
+  }
+}
+
+// -- block arrays -------------------------------------------------------------
+
+// Sets all bits in [first, last).
+void set_range(block_type* xs, size_type first, size_type last) {
+  for (; first < last && first % word_type::width != 0; ++first)
+    xs[first / word_type::width] |= word_type::mask(first % word_type::width);
+  for (; first + word_type::width <= last; first += word_type::width)
+    xs[first / word_type::width] = word_type::all;
+  for (; first < last; ++first)
+    xs[first / word_type::width] |= word_type::mask(first % word_type::width);
+}
+
+// Clears all bits at or after *first*.
+void clear_from(buffer& xs, size_type first) {
+  auto i = first / word_type::width;
+  if (i == container_blocks)
+    return;
+  if (first % word_type::width != 0)
+    xs[i++] &= word_type::lsb_mask(first % word_type::width);
+  for (; i < container_blocks; ++i)
+    xs[i] = word_type::none;
+}
+
+// Writes the bits of a container into a block array.
+void materialize(const container* c, buffer& xs) {
+  if (c == nullptr) {
+    xs.fill(word_type::none);
+  } else if (c->full()) {
+    xs.fill(word_type::all);
+  } else if (!c->bitset.empty()) {
+    std::copy(c->bitset.begin(), c->bitset.end(), xs.begin());
+  } else {
+    xs.fill(word_type::none);
+    for (auto x : c->array)
+      xs[x / word_type::width] |= word_type::mask(x % word_type::width);
+  }
+}
+
+// -- containers ---------------------------------------------------------------
+
+void to_bitset(container& c) {
+  c.bitset.assign(container_blocks, word_type::none);
+  for (auto x : c.array)
+    c.bitset[x / word_type::width] |= word_type::mask(x % word_type::width);
+  std::vector<uint16_t>{}.swap(c.array);
+}
+
+void check_full(container& c) {
+  if (c.full())
+    std::vector<block_type>{}.swap(c.bitset);
+}
+
+// Adds the 1-bit *x* to a container.
+// @pre *x* is greater than all 1-bits in *c*.
+void add(container& c, size_type x) {
+  VAST_ASSERT(!c.full());
+  if (c.bitset.empty()) {
+    c.array.push_back(static_cast<uint16_t>(x));
+    if (++c.cardinality > array_capacity)
+      to_bitset(c);
+  } else {
+    c.bitset[x / word_type::width] |= word_type::mask(x % word_type::width);
+    ++c.cardinality;
+    check_full(c);
+  }
+}
+
+// Adds the 1-bits *[first, last)* to a container.
+// @pre *first* is greater than all 1-bits in *c*.
+void add(container& c, size_type first, size_type last) {
+  VAST_ASSERT(first < last && last <= container_bits);
+  auto n = last - first;
+  if (c.cardinality == 0 && n == container_bits) {
+    c.cardinality = n;
+    return;
+  }
+  if (c.bitset.empty() && c.cardinality + n <= array_capacity) {
+    for (; first < last; ++first)
+      c.array.push_back(static_cast<uint16_t>(first));
+    c.cardinality += n;
+    return;
+  }
+  if (c.bitset.empty())
+    to_bitset(c);
+  set_range(c.bitset.data(), first, last);
+  c.cardinality += n;
+  check_full(c);
+}
+
+// Appends a container with the 1-bits *[0, n)* in chunk *key*.
+void push_range(std::vector<container>& xs, size_type key, size_type n) {
+  xs.emplace_back();
+  xs.back().key = key;
+  add(xs.back(), 0, n);
+}
+
+// Appends a container with the 1-bits of a block array in chunk *key*, unless
+// all bits are 0.
+void push_blocks(std::vector<container>& xs, size_type key,
+                 const buffer& blocks) {
+  auto n = size_type{0};
+  for (auto x : blocks)
+    n += word_type::popcount(x);
+  if (n == 0)
+    return;
+  xs.emplace_back();
+  auto& c = xs.back();
+  c.key = key;
+  c.cardinality = n;
+  if (n == container_bits)
+    return;
+  if (n > array_capacity) {
+    c.bitset.assign(blocks.begin(), blocks.end());
+    return;
+  }
+  c.array.reserve(n);
+  for (auto i = 0u; i < container_blocks; ++i)
+    for (auto x = blocks[i]; x != word_type::none; x &= x - 1)
+      c.array.push_back(static_cast<uint16_t>(
+        i * word_type::width + word_type::count_trailing_zeros(x)));
+}
+
+// Computes the number of 1-bits in *[0, x]* of a container.
+size_type rank_in(const container& c, size_type x) {
+  if (c.full())
+    return x + 1;
+  if (c.bitset.empty()) {
+    auto i = std::upper_bound(c.array.begin(), c.array.end(), x);
+    return static_cast<size_type>(i - c.array.begin());
+  }
+  auto result = size_type{0};
+  auto last = x / word_type::width;
+  for (auto i = 0u; i < last; ++i)
+    result += word_type::popcount(c.bitset[i]);
+  auto mask = word_type::lsb_fill(x % word_type::width + 1);
+  return result + word_type::popcount(c.bitset[last] & mask);
+}
+
+// Locates the first 1-bit at or after *x* in a container.
+size_type find_first_in(const container& c, size_type x) {
+  if (c.full())
+    return x;
+  if (c.bitset.empty()) {
+    auto i = std::lower_bound(c.array.begin(), c.array.end(), x);
+    return i == c.array.end() ? npos : *i;
+  }
+  auto i = x / word_type::width;
+  auto block = c.bitset[i] & (word_type::all << (x % word_type::width));
+  while (block == word_type::none && ++i < container_blocks)
+    block = c.bitset[i];
+  if (block == word_type::none)
+    return npos;
+  return i * word_type::width + word_type::count_trailing_zeros(block);
+}
+
+// Locates the *k*-th 1-bit in a container.
+// @pre `0 < k && k <= c.cardinality`
+size_type select_one(const container& c, size_type k) {
+  if (c.full())
+    return k - 1;
+  if (c.bitset.empty())
+    return c.array[k - 1];
+  for (auto i = 0u; i < container_blocks; ++i) {
+    auto n = word_type::popcount(c.bitset[i]);
+    if (k <= n)
+      return i * word_type::width + select<1>(c.bitset[i], k);
+    k -= n;
+  }
+  return npos;
+}
+
+// Locates the *k*-th 0-bit in a container.
+// @pre `0 < k` and *c* has at least *k* 0-bits.
+size_type select_zero(const container& c, size_type k) {
+  VAST_ASSERT(!c.full());
+  if (c.bitset.empty()) {
+    // The i-th array element has exactly *array[i] - i* 0-bits before it.
+    auto i = size_type{0};
+    while (i < c.array.size() && c.array[i] - i < k)
+      ++i;
+    return k - 1 + i;
+  }
+  for (auto i = 0u; i < container_blocks; ++i) {
+    auto n = word_type::popcount(~c.bitset[i]);
+    if (k <= n)
+      return i * word_type::width + select<0>(c.bitset[i], k);
+    k -= n;
+  }
+  return npos;
+}
+
+// Locates the last 1-bit in a container.
+size_type find_last_one(const container& c) {
+  if (c.full())
+    return container_bits - 1;
+  if (c.bitset.empty())
+    return c.array.back();
+  for (auto i = container_blocks; i > 0; --i)
+    if (c.bitset[i - 1] != word_type::none)
+      return (i - 1) * word_type::width + find_last<1>(c.bitset[i - 1]);
+  return npos;
+}
+
+// Locates the last 0-bit at or before *x* in a container.
+size_type find_last_zero(const container& c, size_type x) {
+  if (c.full())
+    return npos;
+  if (c.bitset.empty()) {
+    auto i = std::upper_bound(c.array.begin(), c.array.end(), x);
+    for (; i != c.array.begin() && *(i - 1) == x; --i, --x)
+      if (x == 0)
+        return npos;
+    return x;
+  }
+  auto i = x / word_type::width;
+  auto block = ~c.bitset[i] & word_type::lsb_fill(x % word_type::width + 1);
+  while (block == word_type::none && i > 0)
+    block = ~c.bitset[--i];
+  if (block == word_type::none)
+    return npos;
+  return i * word_type::width + find_last<1>(block);
+}
+
+// Evaluates a bitwise operation on two containers of the same chunk that
+// consist of bits which all lie in both bitmaps.
+void evaluate_chunk(roaring_bitmap::truth_table op, size_type key,
+                    const container* lhs, const container* rhs,
+                    std::vector<container>& result) {
+  // A missing or full container behaves like a constant.
+  auto constant = [](const container* c) {
+    return c == nullptr ? 0 : c->full() ? 1 : -1;
+  };
+  auto x = constant(lhs);
+  auto y = constant(rhs);
+  if (x >= 0 && y >= 0) {
+    if (test(op, x, y))
+      push_range(result, key, container_bits);
+    return;
+  }
+  buffer l;
+  buffer r;
+  if (x >= 0 || y >= 0) {
+    // With one constant side, the operation degenerates into a unary one.
+    auto& other = x >= 0 ? *rhs : *lhs;
+    auto f0 = x >= 0 ? test(op, x, 0) : test(op, 0, y);
+    auto f1 = x >= 0 ? test(op, x, 1) : test(op, 1, y);
+    if (f0 && f1) {
+      push_range(result, key, container_bits);
+    } else if (!f0 && f1) {
+      result.push_back(other);
+    } else if (f0 && !f1) {
+      materialize(&other, l);
+      for (auto& block : l)
+        block = ~block;
+      push_blocks(result, key, l);
+    }
+    return;
+  }
+  if (lhs->bitset.empty() && rhs->bitset.empty() && !test(op, 0, 0)) {
+    // Merge two array containers.
+    auto& xs = lhs->array;
+    auto& ys = rhs->array;
+    container c;
+    c.key = key;
+    auto i = xs.begin();
+    auto j = ys.begin();
+    while (i != xs.end() || j != ys.end()) {
+      if (j == ys.end() || (i != xs.end() && *i < *j)) {
+        if (test(op, 1, 0))
+          c.array.push_back(*i);
+        ++i;
+      } else if (i == xs.end() || *j < *i) {
+        if (test(op, 0, 1))
+          c.array.push_back(*j);
+        ++j;
+      } else {
+        if (test(op, 1, 1))
+          c.array.push_back(*i);
+        ++i;
+        ++j;
+      }
+    }
+    c.cardinality = c.array.size();
+    if (c.cardinality == 0)
+      return;
+    if (c.cardinality > array_capacity)
+      to_bitset(c);
+    result.push_back(std::move(c));
+    return;
+  }
+  materialize(lhs, l);
+  materialize(rhs, r);
+  apply(op, l, r, l);
+  push_blocks(result, key, l);
+}
+
+} // namespace <anonymous>
+
+roaring_bitmap::roaring_bitmap(size_type n, bool bit) {
+  append_bits(bit, n);
+}
+
+bool roaring_bitmap::empty() const {
+  return size_ == 0;
+}
+
+roaring_bitmap::size_type roaring_bitmap::size() const {
+  return size_;
+}
+
+const std::vector<roaring_bitmap::container>&
+roaring_bitmap::containers() const {
+  return containers_;
+}
+
+void roaring_bitmap::append_bit(bool bit) {
+  VAST_ASSERT(size_ < max_size);
+  if (bit)
+    add(tail(size_ / container_bits), size_ % container_bits);
+  ++size_;
+}
+
+void roaring_bitmap::append_bits(bool bit, size_type n) {
+  VAST_ASSERT(size_ + n <= max_size);
+  if (bit) {
+    auto first = size_;
+    auto last = size_ + n;
+    while (first < last) {
+      auto key = first / container_bits;
+      auto base = key * container_bits;
+      auto end = std::min(last - base, container_bits);
+      add(tail(key), first - base, end);
+      first = base + end;
+    }
+  }
+  size_ += n;
+}
+
+void roaring_bitmap::append_block(block_type bits, size_type n) {
+  VAST_ASSERT(n <= word_type::width);
+  VAST_ASSERT(size_ + n <= max_size);
+  if (n < word_type::width)
+    bits &= word_type::lsb_mask(n);
+  for (; bits != word_type::none; bits &= bits - 1) {
+    auto i = size_ + word_type::count_trailing_zeros(bits);
+    add(tail(i / container_bits), i % container_bits);
+  }
+  size_ += n;
+}
+
+void roaring_bitmap::flip() {
+  if (size_ == 0)
+    return;
+  std::vector<container> result;
+  auto last_key = (size_ - 1) / container_bits;
+  auto i = containers_.begin();
+  buffer blocks;
+  for (auto key = size_type{0}; key <= last_key; ++key) {
+    auto n = std::min(size_ - key * container_bits, container_bits);
+    if (i == containers_.end() || i->key != key) {
+      push_range(result, key, n);
+      continue;
+    }
+    if (!i->full()) {
+      materialize(&*i, blocks);
+      for (auto& block : blocks)
+        block = ~block;
+      clear_from(blocks, n);
+      push_blocks(result, key, blocks);
+    }
+    ++i;
+  }
+  containers_ = std::move(result);
+}
+
+roaring_bitmap::size_type roaring_bitmap::count() const {
+  auto result = size_type{0};
+  for (auto& c : containers_)
+    result += c.cardinality;
+  return result;
+}
+
+roaring_bitmap::size_type roaring_bitmap::count(size_type i) const {
+  VAST_ASSERT(i < size_);
+  auto key = i / container_bits;
+  auto result = size_type{0};
+  for (auto& c : containers_) {
+    if (c.key > key)
+      break;
+    if (c.key < key)
+      result += c.cardinality;
+    else
+      result += rank_in(c, i % container_bits);
+  }
+  return result;
+}
+
+roaring_bitmap::size_type roaring_bitmap::find_first(size_type i) const {
+  if (i >= size_)
+    return npos;
+  auto key = i / container_bits;
+  auto pred = [](const container& c, size_type k) { return c.key < k; };
+  auto c = std::lower_bound(containers_.begin(), containers_.end(), key, pred);
+  for (; c != containers_.end(); ++c) {
+    auto offset = c->key == key ? i % container_bits : 0;
+    auto x = find_first_in(*c, offset);
+    if (x != npos)
+      return c->key * container_bits + x;
+  }
+  return npos;
+}
+
+roaring_bitmap::size_type roaring_bitmap::find_nth(size_type i,
+                                                   bool bit) const {
+  VAST_ASSERT(i > 0);
+  if (i == npos) {
+    if (bit)
+      return containers_.empty()
+        ? npos
+        : containers_.back().key * container_bits
+          + find_last_one(containers_.back());
+    // Walk backwards over the containers until we hit a 0-bit.
+    auto c = containers_.rbegin();
+    for (auto end = size_; end > 0;) {
+      auto x = end - 1;
+      auto key = x / container_bits;
+      while (c != containers_.rend() && c->key > key)
+        ++c;
+      if (c == containers_.rend() || c->key != key)
+        return x;
+      auto base = key * container_bits;
+      auto y = find_last_zero(*c, x - base);
+      if (y != npos)
+        return base + y;
+      end = base;
+    }
+    return npos;
+  }
+  if (bit) {
+    for (auto& c : containers_) {
+      if (i <= c.cardinality)
+        return c.key * container_bits + select_one(c, i);
+      i -= c.cardinality;
+    }
+    return npos;
+  }
+  // Interleave the 0-bits in between containers with those inside.
+  auto end = size_type{0};
+  for (auto& c : containers_) {
+    auto base = c.key * container_bits;
+    if (i <= base - end)
+      return end + i - 1;
+    i -= base - end;
+    end = std::min(base + container_bits, size_);
+    auto zeros = end - base - c.cardinality;
+    if (i <= zeros)
+      return base + select_zero(c, i);
+    i -= zeros;
+  }
+  return i <= size_ - end ? end + i - 1 : npos;
+}
+
+roaring_bitmap roaring_bitmap::evaluate(const roaring_bitmap& lhs,
+                                        const roaring_bitmap& rhs,
+                                        bool fill_lhs, bool fill_rhs,
+                                        truth_table op) {
+  roaring_bitmap result;
+  result.size_ = std::max(lhs.size_, rhs.size_);
+  auto common = std::min(lhs.size_, rhs.size_);
+  auto& longer = lhs.size_ >= rhs.size_ ? lhs : rhs;
+  auto fill = lhs.size_ > rhs.size_ ? fill_lhs : fill_rhs;
+  if (lhs.size_ == rhs.size_)
+    fill = false;
+  // If the operation maps two 0-bits to 1, we must visit every chunk in the
+  // common range. Otherwise only the chunks with at least one container.
+  auto dense = test(op, 0, 0);
+  auto common_keys = (common + container_bits - 1) / container_bits;
+  auto i = lhs.containers_.begin();
+  auto j = rhs.containers_.begin();
+  for (auto key = size_type{0}; key < common_keys; ++key) {
+    if (!dense) {
+      auto next = common_keys;
+      if (i != lhs.containers_.end())
+        next = std::min(next, i->key);
+      if (j != rhs.containers_.end())
+        next = std::min(next, j->key);
+      if (next == common_keys)
+        break;
+      key = next;
+    }
+    auto l = i != lhs.containers_.end() && i->key == key ? &*i++ : nullptr;
+    auto r = j != rhs.containers_.end() && j->key == key ? &*j++ : nullptr;
+    auto base = key * container_bits;
+    auto n = common - base;
+    if (n >= container_bits) {
+      evaluate_chunk(op, key, l, r, result.containers_);
+      continue;
+    }
+    // The last chunk of the common range may continue with the bits of the
+    // longer bitmap.
+    buffer x;
+    buffer y;
+    materialize(l, x);
+    materialize(r, y);
+    buffer blocks;
+    apply(op, x, y, blocks);
+    clear_from(blocks, n);
+    if (fill) {
+      auto& rest = &longer == &lhs ? x : y;
+      for (auto k = 0u; k < container_blocks; ++k) {
+        auto first = k * word_type::width;
+        if (first + word_type::width <= n)
+          continue;
+        auto mask = first >= n ? word_type::all
+                               : ~word_type::lsb_mask(n - first);
+        blocks[k] |= rest[k] & mask;
+      }
+    }
+    push_blocks(result.containers_, key, blocks);
+  }
+  // Copy the remaining containers of the longer bitmap.
+  if (fill) {
+    auto pred = [](const container& c, size_type k) { return c.key < k; };
+    auto first = std::lower_bound(longer.containers_.begin(),
+                                  longer.containers_.end(), common_keys, pred);
+    result.containers_.insert(result.containers_.end(), first,
+                              longer.containers_.end());
+  }
+  return result;
+}
+
+bool operator==(const roaring_bitmap& x, const roaring_bitmap& y) {
+  return x.size_ == y.size_ && x.containers_ == y.containers_;
+}
+
+roaring_bitmap::container& roaring_bitmap::tail(size_type key) {
+  if (containers_.empty() || containers_.back().key != key) {
+    VAST_ASSERT(containers_.empty() || containers_.back().key < key);
+    containers_.emplace_back();
+    containers_.back().key = key;
+  }
+  return containers_.back();
+}
+
+roaring_bitmap_range::roaring_bitmap_range(const roaring_bitmap& bm)
+  : bitmap_{&bm},
+    container_{bm.containers_.begin()} {
+  scan();
+}
+
+void roaring_bitmap_range::next() {
+  scan();
+}
+
+bool roaring_bitmap_range::done() const {
+  return bits_.empty();
+}
+
+void roaring_bitmap_range::scan() {
+  auto size = bitmap_->size_;
+  auto end = bitmap_->containers_.end();
+  auto emit = [&](block_type data, size_type n) {
+    bits_ = {data, n};
+    position_ += n;
+  };
+  if (position_ == size) {
+    bits_ = {};
+    return;
+  }
+  if (container_ != end
+      && position_ >= (container_->key + 1) * container_bits)
+    ++container_;
+  // Produce a run of 0s up to the next container.
+  if (container_ == end || position_ < container_->key * container_bits) {
+    auto next = container_ == end ? size : container_->key * container_bits;
+    emit(word_type::none, next - position_);
+    return;
+  }
+  auto& c = *container_;
+  auto base = c.key * container_bits;
+  auto last = std::min(base + container_bits, size);
+  if (c.full()) {
+    emit(word_type::all, last - position_);
+    return;
+  }
+  auto offset = position_ - base;
+  auto i = offset / word_type::width;
+  if (!c.bitset.empty()) {
+    // Merge homogeneous blocks into runs.
+    auto block = c.bitset[i];
+    auto k = i + 1;
+    if (word_type::all_or_none(block))
+      while (k < container_blocks && c.bitset[k] == block)
+        ++k;
+    emit(block, std::min(k * word_type::width, last - base) - offset);
+    return;
+  }
+  auto x = std::lower_bound(c.array.begin(), c.array.end(), offset);
+  if (x == c.array.end()) {
+    emit(word_type::none, last - position_);
+    return;
+  }
+  auto k = *x / word_type::width;
+  if (k > i) {
+    emit(word_type::none, k * word_type::width - offset);
+    return;
+  }
+  auto block = word_type::none;
+  for (; x != c.array.end() && *x / word_type::width == i; ++x)
+    block |= word_type::mask(*x % word_type::width);
+  emit(block, std::min(word_type::width, last - position_));
+}
+
+roaring_bitmap_range bit_range(const roaring_bitmap& bm) {
+  return roaring_bitmap_range{bm};
+}
+
+} // namespace vast
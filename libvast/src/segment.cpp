@@ -11,6 +11,8 @@
  * contained in the LICENSE file.                                             *
  ******************************************************************************/
 
+#include <cstring>
+
 #include <caf/stream_deserializer.hpp>
 
 #include "vast/bitmap.hpp"
@@ -73,7 +75,10 @@ caf::expected<segment_ptr> segment::make(caf::actor_system& sys,
   caf::charbuf buf{chunk->data() + sizeof(header),
                    chunk->size() - sizeof(header)};
   detail::coded_deserializer<caf::charbuf&> meta_deserializer{buf};
-  if (auto error = meta_deserializer(result->meta_))
+  // Version 1 segments have no compression method in their meta data.
+  auto error = hdr.version < 2 ? meta_deserializer(result->meta_.slices)
+                               : meta_deserializer(result->meta_);
+  if (error)
     return error;
   return result;
 }
@@ -113,8 +118,25 @@ segment::lookup(const ids& xs) const {
 caf::expected<table_slice_ptr>
 segment::make_slice(const table_slice_synopsis& slice) const {
   auto payload = chunk_->data() + header_.payload_offset;
+  auto slice_data = payload + slice.start;
   auto slice_size = detail::narrow_cast<size_t>(slice.end - slice.start);
-  caf::charbuf buf{payload + slice.start, slice_size};
+  // Uncompress the slice first if necessary.
+  std::vector<char> uncompressed;
+  if (meta_.method != compression::null) {
+    uint64_t n;
+    if (slice_size < sizeof(n))
+      return make_error(ec::format_error, "truncated table slice");
+    std::memcpy(&n, slice_data, sizeof(n));
+    n = from_little_endian(n);
+    uncompressed.resize(n);
+    auto m = uncompress(meta_.method, slice_data + sizeof(n),
+                        slice_size - sizeof(n), uncompressed.data(), n);
+    if (m != n)
+      return make_error(ec::format_error, "failed to uncompress table slice");
+    slice_data = uncompressed.data();
+    slice_size = uncompressed.size();
+  }
+  caf::charbuf buf{slice_data, slice_size};
   caf::stream_deserializer<caf::charbuf&> deserializer{actor_system_, buf};
   table_slice_ptr result;
   if (auto error = deserializer(result))
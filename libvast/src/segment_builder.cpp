@@ -13,6 +13,8 @@
 
 #include "vast/segment_builder.hpp"
 
+#include <cstring>
+
 #include <caf/detail/scope_guard.hpp>
 
 #include "vast/ids.hpp"
@@ -36,8 +38,9 @@ T to_little_endian(T x) {
 
 } // namespace <anonymous>
 
-segment_builder::segment_builder(caf::actor_system& sys)
+segment_builder::segment_builder(caf::actor_system& sys, compression method)
   : actor_system_{sys},
+    method_{method},
     table_slice_streambuf_{table_slice_buffer_},
     table_slice_serializer_{actor_system_, table_slice_streambuf_} {
   reset();
@@ -53,6 +56,27 @@ caf::error segment_builder::add(table_slice_ptr x) {
   }
   auto after = table_slice_buffer_.size();
   VAST_ASSERT(before < after);
+  // Replace the serialized slice with its compressed representation, prefixed
+  // by the uncompressed size.
+  if (method_ != compression::null) {
+    compression_buffer_.assign(table_slice_buffer_.begin() + before,
+                               table_slice_buffer_.end());
+    auto size = to_little_endian(uint64_t{compression_buffer_.size()});
+    auto first = before + sizeof(size);
+    table_slice_buffer_.resize(
+      first + compress_bound(method_, compression_buffer_.size()));
+    std::memcpy(table_slice_buffer_.data() + before, &size, sizeof(size));
+    auto n = compress(method_, compression_buffer_.data(),
+                      compression_buffer_.size(),
+                      table_slice_buffer_.data() + first,
+                      table_slice_buffer_.size() - first);
+    if (n == 0) {
+      table_slice_buffer_.resize(before);
+      return make_error(ec::unspecified, "failed to compress table slice");
+    }
+    table_slice_buffer_.resize(first + n);
+    after = table_slice_buffer_.size();
+  }
   meta_.slices.push_back({
     detail::narrow_cast<int64_t>(before),
     detail::narrow_cast<int64_t>(after),
@@ -127,6 +151,7 @@ size_t segment_builder::table_slice_bytes() const {
 void segment_builder::reset() {
   min_table_slice_offset_ = 0;
   meta_ = {};
+  meta_.method = method_;
   id_ = uuid::random();
   segment_buffer_ = {};
   table_slice_buffer_.clear();
@@ -28,16 +28,34 @@
 #include "vast/table_slice.hpp"
 #include "vast/to_events.hpp"
 
+#include "vast/detail/varbyte.hpp"
+
 namespace vast {
 
+caf::expected<segment_ptr> segment_store::mmap(caf::actor_system& sys,
+                                               const path& filename) {
+  auto chk = chunk::mmap(filename);
+  if (!chk)
+    return make_error(ec::filesystem_error, "failed to mmap segment",
+                      filename);
+  if (chk->size() < sizeof(segment::header))
+    return make_error(ec::format_error, "segment file too small", filename);
+  uint64_t size;
+  auto prefix = detail::varbyte::decode(size, chk->data());
+  if (prefix + size != chk->size())
+    return make_error(ec::format_error, "segment size mismatch", filename);
+  return segment::make(sys, chk->slice(prefix));
+}
+
 segment_store_ptr segment_store::make(caf::actor_system& sys, path dir,
                                       size_t max_segment_size,
-                                      size_t in_memory_segments) {
+                                      size_t in_memory_segments,
+                                      compression method) {
   VAST_TRACE(VAST_ARG(dir), VAST_ARG(max_segment_size),
              VAST_ARG(in_memory_segments));
   VAST_ASSERT(max_segment_size > 0);
   auto x = std::make_unique<segment_store>(
-    sys, std::move(dir), max_segment_size, in_memory_segments);
+    sys, std::move(dir), max_segment_size, in_memory_segments, method);
   // Materialize meta data of existing segments.
   if (exists(x->meta_path())) {
     VAST_DEBUG_ANON(__func__, "loads segment meta data from", x->meta_path());
@@ -84,21 +102,8 @@ caf::error segment_store::flush() {
 caf::expected<std::vector<table_slice_ptr>>
 segment_store::get(const ids& xs) {
   VAST_TRACE(VAST_ARG(xs));
-  // Collect candidate segments by seeking through the ID set and
-  // probing each ID interval.
   VAST_DEBUG(this, "retrieves table slices with requested ids");
-  std::vector<uuid> candidates;
-  auto f = [](auto x) { return std::pair{x.left, x.right}; };
-  auto g = [&](auto x) {
-    auto id = x.value;
-    if (candidates.empty() || candidates.back() != id)
-      candidates.push_back(id);
-    return caf::none;
-  };
-  auto begin = segments_.begin();
-  auto end = segments_.end();
-  if (auto error = select_with(xs, begin, end, f, g))
-    return error;
+  auto candidates = this->candidates(xs);
   // Process candidates in reverse order for maximum LRU cache hits.
   std::vector<table_slice_ptr> result;
   VAST_DEBUG(this, "processes", candidates.size(), "candidates");
@@ -109,19 +114,19 @@ segment_store::get(const ids& xs) {
       VAST_DEBUG(this, "looks into the active segement");
       slices = builder_.lookup(xs);
     } else {
-      segment_ptr seg_ptr = nullptr;
-      auto i = cache_.find(id);
-      if (i != cache_.end()) {
+      auto seg_ptr = cached(id);
+      if (seg_ptr != nullptr) {
         VAST_DEBUG(this, "got cache hit for segment", id);
-        seg_ptr = i->second;
       } else {
         VAST_DEBUG(this, "got cache miss for segment", id);
-        auto fname = segment_path() / to_string(id);
-        if (auto err = load(sys_, fname, seg_ptr)) {
-          VAST_ERROR(this, "unable to load segment:", sys_.render(err));
-          return err;
+        auto seg = mmap(sys_, segment_file(id));
+        if (!seg) {
+          VAST_ERROR(this, "unable to load segment:",
+                     sys_.render(seg.error()));
+          return seg.error();
         }
-        i = cache_.emplace(id, seg_ptr).first;
+        seg_ptr = std::move(*seg);
+        cache(seg_ptr);
       }
       VAST_ASSERT(seg_ptr != nullptr);
       slices = seg_ptr->lookup(xs);
@@ -134,13 +139,57 @@ segment_store::get(const ids& xs) {
   return result;
 }
 
+std::vector<uuid> segment_store::candidates(const ids& xs) const {
+  // Collect candidate segments by seeking through the ID set and
+  // probing each ID interval.
+  std::vector<uuid> result;
+  auto f = [](auto x) { return std::pair{x.left, x.right}; };
+  auto g = [&](auto x) {
+    auto id = x.value;
+    if (result.empty() || result.back() != id)
+      result.push_back(id);
+    return caf::none;
+  };
+  auto begin = segments_.begin();
+  auto end = segments_.end();
+  if (auto error = select_with(xs, begin, end, f, g))
+    VAST_ERROR(this, "failed to collect candidate segments:",
+               sys_.render(error));
+  return result;
+}
+
+caf::expected<std::vector<table_slice_ptr>>
+segment_store::get_active(const ids& xs) const {
+  return builder_.lookup(xs);
+}
+
+const uuid& segment_store::active_segment() const {
+  return builder_.id();
+}
+
+segment_ptr segment_store::cached(const uuid& id) {
+  auto i = cache_.find(id);
+  return i != cache_.end() ? i->second : nullptr;
+}
+
+void segment_store::cache(segment_ptr x) {
+  VAST_ASSERT(x != nullptr);
+  auto id = x->id();
+  cache_.emplace(id, std::move(x));
+}
+
+path segment_store::segment_file(const uuid& id) const {
+  return segment_path() / to_string(id);
+}
+
 segment_store::segment_store(caf::actor_system& sys, path dir,
-                             uint64_t max_segment_size, size_t in_memory_segments)
+                             uint64_t max_segment_size,
+                             size_t in_memory_segments, compression method)
   : sys_{sys},
     dir_{std::move(dir)},
     max_segment_size_{max_segment_size},
     cache_{in_memory_segments},
-    builder_{sys_} {
+    builder_{sys_, method} {
   // nop
 }
 
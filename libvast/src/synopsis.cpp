@@ -13,13 +13,23 @@
 
 #include "vast/synopsis.hpp"
 
+#include <limits>
+
 #include <caf/actor_system.hpp>
 #include <caf/runtime_settings_map.hpp>
 
+#include "vast/bloom_filter_synopsis.hpp"
 #include "vast/error.hpp"
 #include "vast/logger.hpp"
+#include "vast/min_max_synopsis.hpp"
+#include "vast/port_synopsis.hpp"
+#include "vast/table_slice.hpp"
 #include "vast/timestamp_synopsis.hpp"
 
+#include "vast/concept/parseable/core.hpp"
+#include "vast/concept/parseable/numeric/integral.hpp"
+#include "vast/concept/parseable/numeric/real.hpp"
+
 #include "vast/detail/overload.hpp"
 
 namespace vast {
@@ -32,6 +42,11 @@ synopsis::~synopsis() {
   // nop
 }
 
+void synopsis::add_column(const table_slice& slice, size_t col) {
+  for (size_t row = 0; row < slice.rows(); ++row)
+    add(slice.at(row, col));
+}
+
 const vast::type& synopsis::type() const {
   return type_;
 }
@@ -78,11 +93,72 @@ caf::error inspect(caf::deserializer& source, synopsis_ptr& ptr) {
   return caf::none;
 }
 
+namespace {
+
+template <class T>
+synopsis_ptr make_min_max_synopsis(type x) {
+  using limits = std::numeric_limits<T>;
+  return caf::make_counted<min_max_synopsis<T>>(std::move(x), limits::max(),
+                                                limits::lowest());
+}
+
+// Creates a Bloom filter synopsis, sized according to an optional attribute
+// `&synopsis="bloomfilter(<capacity>,<fp-rate>)"` of the type.
+synopsis_ptr make_bloom_filter_synopsis(type x) {
+  auto capacity = uint64_t{bloom_filter_synopsis::global_capacity()};
+  auto fp_rate = bloom_filter_synopsis::default_false_positive_rate;
+  for (auto& attr : x.attributes()) {
+    if (attr.key != "synopsis" || !attr.value)
+      continue;
+    using parsers::u64;
+    using parsers::real_opt_dot;
+    auto p = "bloomfilter(" >> u64 >> ',' >> real_opt_dot >> ')';
+    uint64_t n;
+    double fp;
+    if (!p(*attr.value, n, fp) || n == 0 || fp <= 0 || fp >= 1) {
+      VAST_WARNING_ANON("synopsis", "ignores invalid attribute:",
+                        *attr.value);
+      continue;
+    }
+    capacity = n;
+    fp_rate = fp;
+  }
+  return caf::make_counted<bloom_filter_synopsis>(std::move(x), capacity,
+                                                  fp_rate);
+}
+
+} // namespace <anonymous>
+
 synopsis_ptr make_synopsis(type x) {
   return caf::visit(detail::overload(
+    [&](const count_type&) {
+      return make_min_max_synopsis<count>(std::move(x));
+    },
+    [&](const integer_type&) {
+      return make_min_max_synopsis<integer>(std::move(x));
+    },
+    [&](const real_type&) {
+      return make_min_max_synopsis<real>(std::move(x));
+    },
+    [&](const timespan_type&) -> synopsis_ptr {
+      return caf::make_counted<min_max_synopsis<timespan>>(
+        std::move(x), timespan::max(), timespan::min());
+    },
     [&](const timestamp_type&) -> synopsis_ptr {
       return caf::make_counted<timestamp_synopsis>(std::move(x));
     },
+    [&](const port_type&) -> synopsis_ptr {
+      return caf::make_counted<port_synopsis>(std::move(x));
+    },
+    [&](const string_type&) {
+      return make_bloom_filter_synopsis(std::move(x));
+    },
+    [&](const address_type&) {
+      return make_bloom_filter_synopsis(std::move(x));
+    },
+    [&](const subnet_type&) {
+      return make_bloom_filter_synopsis(std::move(x));
+    },
     [](const auto&) -> synopsis_ptr {
       return nullptr;
     }), x);
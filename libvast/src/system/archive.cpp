@@ -12,7 +12,15 @@
  ******************************************************************************/
 
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
 
+#include <caf/actor_pool.hpp>
+#include <caf/actor_system_config.hpp>
+#include <caf/event_based_actor.hpp>
+
+#include "vast/defaults.hpp"
+#include "vast/error.hpp"
 #include "vast/event.hpp"
 #include "vast/expected.hpp"
 #include "vast/logger.hpp"
@@ -22,6 +30,7 @@
 #include "vast/to_events.hpp"
 
 #include "vast/concept/printable/stream.hpp"
+#include "vast/concept/printable/vast/uuid.hpp"
 
 #include "vast/system/archive.hpp"
 
@@ -34,38 +43,228 @@ using namespace caf;
 
 namespace vast::system {
 
+namespace {
+
+using archive_actor = archive_type::stateful_pointer<archive_state>;
+
+// Loads segments from disk and extracts events or table slices from them.
+behavior archive_worker(event_based_actor* self) {
+  return {
+    [=](load_atom, const path& filename) -> result<segment_ptr> {
+      auto seg = segment_store::mmap(self->system(), filename);
+      if (!seg)
+        return seg.error();
+      return std::move(*seg);
+    },
+    [=](const segment_ptr& seg, const ids& xs) -> result<std::vector<event>> {
+      auto slices = seg->lookup(xs);
+      if (!slices)
+        return slices.error();
+      std::vector<event> result;
+      for (auto& slice : *slices)
+        to_events(result, *slice, xs);
+      return result;
+    },
+    [=](table_slice_atom, const segment_ptr& seg,
+        const ids& xs) -> result<std::vector<table_slice_ptr>> {
+      auto slices = seg->lookup(xs);
+      if (!slices)
+        return slices.error();
+      return std::move(*slices);
+    }
+  };
+}
+
+// Hands the results of a single segment over to a lookup. Completes the
+// lookup after its last segment.
+template <class T>
+void deliver(archive_actor self, uint64_t n, std::vector<T> xs) {
+  auto& lookups = self->state.lookups<T>();
+  auto i = lookups.find(n);
+  VAST_ASSERT(i != lookups.end());
+  auto& lookup = i->second;
+  VAST_ASSERT(lookup.pending > 0);
+  if (--lookup.pending > 0 && lookup.sink != nullptr) {
+    if (!xs.empty())
+      self->send(lookup.sink, std::move(xs));
+    return;
+  }
+  if (lookup.buffer.empty())
+    lookup.buffer = std::move(xs);
+  else
+    lookup.buffer.insert(lookup.buffer.end(),
+                         std::make_move_iterator(xs.begin()),
+                         std::make_move_iterator(xs.end()));
+  if (lookup.pending == 0) {
+    lookup.promise.deliver(std::move(lookup.buffer));
+    lookups.erase(i);
+  }
+}
+
+// Extracts the results of a lookup from a segment on the worker pool.
+template <class T>
+void extract(archive_actor self, uint64_t n, segment_ptr seg) {
+  auto& xs = self->state.lookups<T>()[n].xs;
+  auto on_result = [=](std::vector<T>& result) {
+    deliver(self, n, std::move(result));
+  };
+  auto on_error = [=](const error& err) {
+    VAST_ERROR(self, "failed to extract from segment:",
+               self->system().render(err));
+    deliver(self, n, std::vector<T>{});
+  };
+  auto& workers = self->state.workers;
+  if constexpr (std::is_same_v<T, event>)
+    self->request(workers, infinite, std::move(seg), xs)
+      .then(on_result, on_error);
+  else
+    self->request(workers, infinite, table_slice_atom::value, std::move(seg),
+                  xs)
+      .then(on_result, on_error);
+}
+
+// Resumes a lookup after a segment finished loading.
+void resume(archive_actor self, uint64_t n, const segment_ptr& seg) {
+  auto is_event_lookup = self->state.event_lookups.count(n) > 0;
+  if (seg == nullptr) {
+    if (is_event_lookup)
+      deliver(self, n, std::vector<event>{});
+    else
+      deliver(self, n, std::vector<table_slice_ptr>{});
+  } else if (is_event_lookup) {
+    extract<event>(self, n, seg);
+  } else {
+    extract<table_slice_ptr>(self, n, seg);
+  }
+}
+
+// Loads a segment on the worker pool and resumes all lookups that wait for it.
+void load(archive_actor self, const uuid& id) {
+  auto take_waiting = [=] {
+    auto i = self->state.loading.find(id);
+    VAST_ASSERT(i != self->state.loading.end());
+    auto result = std::move(i->second);
+    self->state.loading.erase(i);
+    return result;
+  };
+  auto filename = self->state.store->segment_file(id);
+  self->request(self->state.workers, infinite, load_atom::value, filename).then(
+    [=](segment_ptr& seg) {
+      self->state.store->cache(seg);
+      for (auto n : take_waiting())
+        resume(self, n, seg);
+    },
+    [=](const error& err) {
+      VAST_ERROR(self, "failed to load segment", id << ':',
+                 self->system().render(err));
+      for (auto n : take_waiting())
+        resume(self, n, nullptr);
+    }
+  );
+}
+
+// Starts a lookup for the IDs in *xs* with results of type `T`.
+template <class T>
+typed_response_promise<std::vector<T>> lookup(archive_actor self,
+                                              const ids& xs) {
+  VAST_ASSERT(rank(xs) > 0);
+  VAST_DEBUG(self, "got query for", rank(xs), "events in range ["
+             << select(xs, 1) << ',' << (select(xs, -1) + 1) << ')');
+  auto& st = self->state;
+  auto n = st.next_lookup++;
+  auto& lookups = st.lookups<T>();
+  auto& lookup = lookups[n];
+  lookup.xs = xs;
+  // Only asynchronous messages can receive more than one batch.
+  if (!self->current_message_id().is_request())
+    lookup.sink = actor_cast<actor>(self->current_sender());
+  lookup.promise = self->make_response_promise<std::vector<T>>();
+  // Process candidates in reverse order for maximum LRU cache hits.
+  auto candidates = st.store->candidates(xs);
+  for (auto i = candidates.rbegin(); i != candidates.rend(); ++i) {
+    auto& id = *i;
+    if (id == st.store->active_segment()) {
+      auto slices = st.store->get_active(xs);
+      if (!slices)
+        VAST_ERROR(self, "failed to lookup IDs in active segment:",
+                   self->system().render(slices.error()));
+      else if constexpr (std::is_same_v<T, event>)
+        for (auto& slice : *slices)
+          to_events(lookup.buffer, *slice, xs);
+      else
+        lookup.buffer.insert(lookup.buffer.end(), slices->begin(),
+                             slices->end());
+    } else if (auto seg = st.store->cached(id)) {
+      ++lookup.pending;
+      extract<T>(self, n, std::move(seg));
+    } else {
+      ++lookup.pending;
+      auto& waiting = st.loading[id];
+      waiting.push_back(n);
+      // Concurrent lookups share a load in progress.
+      if (waiting.size() == 1)
+        load(self, id);
+    }
+  }
+  auto rp = lookup.promise;
+  if (lookup.pending == 0) {
+    rp.deliver(std::move(lookup.buffer));
+    lookups.erase(n);
+  } else if (lookup.sink != nullptr && !lookup.buffer.empty()) {
+    self->send(lookup.sink, std::move(lookup.buffer));
+    lookup.buffer.clear();
+  }
+  return rp;
+}
+
+} // namespace <anonymous>
+
 archive_type::behavior_type
 archive(archive_type::stateful_pointer<archive_state> self,
-        path dir, size_t capacity, size_t max_segment_size) {
+        path dir, size_t capacity, size_t max_segment_size,
+        compression method) {
   // TODO: make the choice of store configurable. For most flexibility, it
   // probably makes sense to pass a unique_ptr<stor> directory to the spawn
   // arguments of the actor. This way, users can provide their own store
   // implementation conveniently.
   VAST_INFO(self, "spawned:", VAST_ARG(capacity), VAST_ARG(max_segment_size));
   self->state.store = segment_store::make(
-    self->system(), dir, max_segment_size, capacity);
+    self->system(), dir, max_segment_size, capacity, method);
   VAST_ASSERT(self->state.store != nullptr);
+  auto num_workers = get_or(self->system().config(), "vast.archive-workers",
+                            defaults::system::archive_workers);
+  if (num_workers == 0) {
+    self->quit(make_error(ec::invalid_configuration,
+                          "vast.archive-workers must be positive"));
+    return archive_type::behavior_type::make_empty_behavior();
+  }
+  auto& sys = self->system();
+  // The workers block on segment I/O and decompression, so they get their own
+  // threads instead of pinning the cooperative scheduler. The deterministic
+  // test scheduler cannot step detached actors, though.
+  auto detach = sys.config().scheduler_policy != atom("testing");
+  auto spawn_worker = [&sys, detach] {
+    return detach ? sys.spawn<detached>(archive_worker)
+                  : sys.spawn(archive_worker);
+  };
+  self->state.workers = actor_pool::make(
+    sys.dummy_execution_unit(), num_workers, spawn_worker,
+    actor_pool::round_robin());
   self->set_exit_handler(
     [=](const exit_msg& msg) {
+      self->send_exit(self->state.workers, msg.reason);
       self->state.store->flush();
       self->state.store.reset();
       self->quit(msg.reason);
     }
   );
   return {
-    [=](const ids& xs) {
-      VAST_ASSERT(rank(xs) > 0);
-      VAST_DEBUG(self, "got query for", rank(xs), "events in range ["
-                 << select(xs, 1) << ',' << (select(xs, -1) + 1) << ')');
-      std::vector<event> result;
-      auto slices = self->state.store->get(xs);
-      if (!slices)
-        VAST_DEBUG(self, "failed to lookup IDs in store:",
-                   self->system().render(slices.error()));
-      else
-        for (auto& slice : *slices)
-          to_events(result, *slice, xs);
-      return result;
+    [=](const ids& xs) -> typed_response_promise<std::vector<event>> {
+      return lookup<event>(self, xs);
+    },
+    [=](table_slice_atom, const ids& xs)
+    -> typed_response_promise<std::vector<table_slice_ptr>> {
+      return lookup<table_slice_ptr>(self, xs);
     },
     [=](stream<table_slice_ptr> in) {
       self->make_sink(
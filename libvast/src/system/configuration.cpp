@@ -52,7 +52,20 @@ configuration::configuration() {
 #endif
   opt_group{custom_options_, "vast"}
   .add<size_t>("table-slice-size",
-               "Maximum size for sources that generate table slices.");
+               "Maximum size for sources that generate table slices.")
+  .add<atom_value>("table-slice-type",
+                   "Implementation ID of table slices that sources generate.")
+  .add<size_t>("archive-workers",
+               "Number of workers that load segments for the archive.")
+  .add<size_t>("indexer-workers",
+               "Number of threads that index columns in parallel (0 = off).")
+  .add<atom_value>("bitmap-type",
+                   "Bitmap type for index postings: ewah, wah, null, or "
+                   "roaring.")
+  .add<size_t>("partition-cache-size",
+               "Memory budget in bytes for partitions cached by the index.")
+  .add<size_t>("bloom-filter-capacity",
+               "Number of distinct values that Bloom filters get sized for.");
 }
 
 configuration& configuration::parse(int argc, char** argv) {
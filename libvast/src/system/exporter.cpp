@@ -19,11 +19,12 @@
 #include "vast/concept/printable/vast/expression.hpp"
 #include "vast/concept/printable/vast/uuid.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/evaluate.hpp"
 #include "vast/event.hpp"
 #include "vast/expression_visitors.hpp"
+#include "vast/ids.hpp"
 #include "vast/logger.hpp"
 #include "vast/table_slice.hpp"
-#include "vast/to_events.hpp"
 
 #include "vast/system/archive.hpp"
 #include "vast/system/atoms.hpp"
@@ -42,29 +43,39 @@ namespace {
 
 void ship_results(stateful_actor<exporter_state>* self) {
   VAST_TRACE("");
-  if (self->state.results.empty() || self->state.stats.requested == 0) {
+  auto& st = self->state;
+  if (st.results.empty() || st.stats.requested == 0) {
     return;
   }
-  VAST_INFO(self, "relays", self->state.results.size(), "events");
-  message msg;
-  if (self->state.results.size() <= self->state.stats.requested) {
-    self->state.stats.requested -= self->state.results.size();
-    self->state.stats.shipped += self->state.results.size();
-    msg = make_message(std::move(self->state.results));
-    self->state.results = {};
-  } else {
-    std::vector<event> remainder;
-    remainder.reserve(self->state.results.size() - self->state.stats.requested);
-    auto begin = self->state.results.begin() + self->state.stats.requested;
-    auto end = self->state.results.end();
-    std::move(begin, end, std::back_inserter(remainder));
-    self->state.results.resize(self->state.stats.requested);
-    msg = make_message(std::move(self->state.results));
-    self->state.results = std::move(remainder);
-    self->state.stats.shipped += self->state.stats.requested;
-    self->state.stats.requested = 0;
+  // Collect result rows until we reach the number of requested events. A
+  // table slice stays in the results as long as it has unshipped rows.
+  std::vector<table_slice_ptr> slices;
+  ids rows;
+  uint64_t n = 0;
+  auto i = st.results.begin();
+  for (; i != st.results.end() && n < st.stats.requested; ++i) {
+    auto first = (*i)->offset();
+    auto selection = st.result_ids & make_ids({{first, first + (*i)->rows()}});
+    auto k = rank(selection);
+    if (k == 0)
+      continue;
+    slices.push_back(*i);
+    if (n + k > st.stats.requested) {
+      rows |= take(selection, st.stats.requested - n);
+      n = st.stats.requested;
+      break;
+    }
+    rows |= selection;
+    n += k;
   }
-  self->send(self->state.sink, msg);
+  st.results.erase(st.results.begin(), i);
+  if (n == 0)
+    return;
+  VAST_INFO(self, "relays", n, "events");
+  st.result_ids -= rows;
+  st.stats.requested -= n;
+  st.stats.shipped += n;
+  self->send(st.sink, std::move(slices), std::move(rows));
 }
 
 void report_statistics(stateful_actor<exporter_state>* self) {
@@ -76,7 +87,7 @@ void report_statistics(stateful_actor<exporter_state>* self) {
     auto hits = rank(self->state.hits);
     auto processed = self->state.stats.processed;
     auto shipped = self->state.stats.shipped;
-    auto results = shipped + self->state.results.size();
+    auto results = shipped + rank(self->state.result_ids);
     auto selectivity = double(results) / hits;
     self->send(self->state.accountant, "exporter.hits", hits);
     self->send(self->state.accountant, "exporter.processed", processed);
@@ -93,7 +104,7 @@ void shutdown(stateful_actor<exporter_state>* self, caf::error err) {
 }
 
 void shutdown(stateful_actor<exporter_state>* self) {
-  if (rank(self->state.unprocessed) > 0 || !self->state.results.empty()
+  if (rank(self->state.unprocessed) > 0 || rank(self->state.result_ids) > 0
       || has_continuous_option(self->state.options))
     return;
   VAST_DEBUG(self, "initiates shutdown");
@@ -151,43 +162,48 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
         report_statistics(self);
     }
   );
-  auto handle_batch = [=](std::vector<event>& candidates) {
-    VAST_DEBUG(self, "got batch of", candidates.size(), "events");
-    // Events can arrive in any order: sort them by ID first. Otherwise, we
-    // can't compute the bitmap mask as easily.
-    std::sort(candidates.begin(), candidates.end(),
-              [](auto& x, auto& y) { return x.id() < y.id(); });
-    bitmap mask;
-    auto sender = self->current_sender();
-    for (auto& candidate : candidates) {
-      auto& checker = self->state.checkers[candidate.type()];
-      // Construct a candidate checker if we don't have one for this type.
-      if (caf::holds_alternative<caf::none_t>(checker)) {
-        auto x = tailor(expr, candidate.type());
-        if (!x) {
-          VAST_ERROR(self, "failed to tailor expression:",
-                     self->system().render(x.error()));
-          ship_results(self);
-          self->send_exit(self, exit_reason::normal);
-          return;
-        }
-        checker = std::move(*x);
-        VAST_DEBUG(self, "tailored AST to", candidate.type() << ':', checker);
+  // Evaluates the candidate rows of a table slice and keeps the matching rows
+  // as results. The candidates must lie within the ID range of the slice.
+  auto handle_slice = [=](const table_slice_ptr& slice, const ids& candidates) {
+    type layout = slice->layout(1).name(slice->layout().name());
+    auto& checker = self->state.checkers[layout];
+    // Construct a candidate checker if we don't have one for this type.
+    if (caf::holds_alternative<caf::none_t>(checker)) {
+      auto x = tailor(expr, layout);
+      if (!x) {
+        VAST_ERROR(self, "failed to tailor expression:",
+                   self->system().render(x.error()));
+        return false;
       }
-      // Append ID to our bitmap mask.
-      if (sender == self->state.archive) {
-        mask.append_bits(false, candidate.id() - mask.size());
-        mask.append_bit(true);
+      checker = std::move(*x);
+      VAST_DEBUG(self, "tailored AST to", layout << ':', checker);
+    }
+    self->state.stats.processed += rank(candidates);
+    auto hits = evaluate(checker, *slice) & candidates;
+    if (any<1>(hits)) {
+      self->state.results.push_back(slice);
+      self->state.result_ids |= hits;
+    }
+    return true;
+  };
+  auto handle_batch = [=](std::vector<table_slice_ptr>& slices) {
+    VAST_DEBUG(self, "got batch of", slices.size(), "table slices");
+    // Slices from the archive contain the rows of our index hits. All other
+    // slices come from a continuous query, where every row is a candidate.
+    auto from_archive = self->current_sender() == self->state.archive;
+    for (auto& slice : slices) {
+      auto first = slice->offset();
+      auto candidates = make_ids({{first, first + slice->rows()}});
+      if (from_archive)
+        candidates &= self->state.unprocessed;
+      if (!handle_slice(slice, candidates)) {
+        ship_results(self);
+        self->send_exit(self, exit_reason::normal);
+        return;
       }
-      // Perform candidate check and keep event as result on success.
-      if (caf::visit(event_evaluator{candidate}, checker))
-        self->state.results.push_back(std::move(candidate));
-      else
-        VAST_DEBUG(self, "ignores false positive:", candidate);
+      if (from_archive)
+        self->state.unprocessed -= candidates;
     }
-    self->state.stats.processed += candidates.size();
-    if (sender == self->state.archive)
-      self->state.unprocessed -= mask;
     ship_results(self);
     request_more_hits(self);
     if (self->state.stats.received == self->state.stats.expected)
@@ -212,7 +228,8 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
         self->state.unprocessed |= hits;
         VAST_DEBUG(self, "forwards hits to archive");
         // FIXME: restrict according to configured limit.
-        self->send(self->state.archive, std::move(hits));
+        self->send(self->state.archive, table_slice_atom::value,
+                   std::move(hits));
       }
       // Figure out if we're done.
       ++self->state.stats.received;
@@ -229,8 +246,8 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
         shutdown(self);
       }
     },
-    [=](std::vector<event>& candidates) {
-      handle_batch(candidates);
+    [=](std::vector<table_slice_ptr>& slices) {
+      handle_batch(slices);
     },
     [=](extract_atom) {
       if (self->state.stats.requested == max_events) {
@@ -304,10 +321,8 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
         [](caf::unit_t&) {
           // nop
         },
-        [=](caf::unit_t&, const table_slice_ptr& slice) {
-          // TODO: port to new table slice API
-          auto candidates = to_events(*slice);
-          handle_batch(candidates);
+        [=](caf::unit_t&, std::vector<table_slice_ptr>& batch) {
+          handle_batch(batch);
         },
         [=](caf::unit_t&, const error& err) {
           VAST_IGNORE_UNUSED(err);
@@ -18,13 +18,17 @@
 #include <caf/all.hpp>
 #include <caf/detail/unordered_flat_map.hpp>
 
+#include "vast/bitmap.hpp"
+#include "vast/bloom_filter_synopsis.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/bitmap.hpp"
 #include "vast/concept/printable/vast/error.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
 #include "vast/concept/printable/vast/uuid.hpp"
+#include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
 #include "vast/event.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/ids.hpp"
@@ -100,6 +104,12 @@ behavior collector(stateful_actor<collector_state>* self, actor master) {
     }};
 }
 
+// Estimates the memory of a partition from the size of its persistent state,
+// which roughly matches the size of its deserialized bitmaps.
+size_t estimate_memory_usage(const partition& part) {
+  return disk_usage(part.dir());
+}
+
 } // namespace <anonymous>
 
 partition_ptr index_state::partition_factory::operator()(const uuid& id) const {
@@ -113,12 +123,14 @@ partition_ptr index_state::partition_factory::operator()(const uuid& id) const {
   if (auto i = std::find_if(xs.begin(), xs.end(), pred); i != xs.end())
     return i->first;
   VAST_DEBUG(st_->self, "loads partition", id);
-  return make_partition(st_->self->system(), st_->self, st_->dir, id);
+  return make_partition(st_->self->system(), st_->self, st_->dir, id,
+                        st_->indexer_workers);
 }
 
 index_state::index_state()
   // Arbitrary default value, overridden in ::init.
-  : lru_partitions(10, partition_lookup{}, partition_factory{this}) {
+  : lru_partitions(10, defaults::system::partition_cache_size,
+                   partition_factory{this}, estimate_memory_usage) {
   // nop
 }
 
@@ -149,8 +161,29 @@ caf::error index_state::init(event_based_actor* self, const path& dir,
   this->self = self;
   this->dir = dir;
   this->max_partition_size = max_partition_size;
-  this->lru_partitions.size(in_mem_partitions);
+  this->lru_partitions.max_partitions(in_mem_partitions);
+  auto cache_size = get_or(self->system().config(),
+                           "vast.partition-cache-size",
+                           defaults::system::partition_cache_size);
+  this->lru_partitions.max_bytes(cache_size);
   this->taste_partitions = taste_partitions;
+  auto num_indexer_workers = get_or(self->system().config(),
+                                    "vast.indexer-workers",
+                                    defaults::system::indexer_workers);
+  if (num_indexer_workers > 0)
+    indexer_workers
+      = std::make_shared<detail::thread_pool>(num_indexer_workers);
+  auto bitmap_type = get_or(self->system().config(), "vast.bitmap-type",
+                            defaults::system::bitmap_type);
+  if (!bitmap::valid_type(bitmap_type))
+    return make_error(ec::invalid_configuration, "invalid bitmap type:",
+                      to_string(bitmap_type));
+  auto bloom_filter_capacity = get_or(self->system().config(),
+                                      "vast.bloom-filter-capacity",
+                                      defaults::system::bloom_filter_capacity);
+  if (!bloom_filter_synopsis::global_capacity(bloom_filter_capacity))
+    return make_error(ec::invalid_configuration,
+                      "vast.bloom-filter-capacity must be positive");
   // Read persistent state.
   if (auto err = load_from_disk())
     return err;
@@ -186,7 +219,8 @@ caf::error index_state::init(event_based_actor* self, const path& dir,
     // Create a new active partition.
     auto id = uuid::random();
     VAST_DEBUG(this->self, "starts a new partition:", id);
-    active = make_partition(this->self->system(), this->self, this->dir, id);
+    active = make_partition(this->self->system(), this->self, this->dir, id,
+                            indexer_workers);
     // Register the new active partition at the stream manager.
     return active;
   };
@@ -255,14 +289,28 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
   auto accountant = accountant_type{};
   if (auto a = self->system().registry().get(accountant_atom::value))
     accountant = actor_cast<accountant_type>(a);
+  auto report_cache_statistics = [=] {
+    if (!accountant)
+      return;
+    auto& cache = self->state.lru_partitions;
+    auto& stats = cache.stats();
+    self->send(accountant, "index.partition-cache.hits", stats.hits);
+    self->send(accountant, "index.partition-cache.misses", stats.misses);
+    self->send(accountant, "index.partition-cache.evictions", stats.evictions);
+    self->send(accountant, "index.partition-cache.bytes",
+               uint64_t{cache.bytes()});
+  };
   auto locate_indexers = [=](const expression& expr, auto begin, auto end) {
     query_map result;
     for (; begin != end; ++begin) {
+      // Holding on to the INDEXER actors keeps them alive for this query,
+      // even if loading later partitions evicts their partition.
       auto& part = self->state.lru_partitions.get_or_add(*begin);
       auto indexers = part->get_indexers(expr);
       VAST_ASSERT(!indexers.empty());
       result.emplace(part->id(), std::move(indexers));
     }
+    report_cache_statistics();
     return result;
   };
   // Launch workers for resolving queries.
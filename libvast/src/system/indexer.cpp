@@ -47,13 +47,17 @@ void indexer_state::init(table_index&& from) {
 }
 
 behavior indexer(stateful_actor<indexer_state>* self, path dir,
-                 record_type layout) {
+                 record_type layout,
+                 std::shared_ptr<detail::thread_pool> pool) {
   auto maybe_tbl = make_table_index(self->system(), std::move(dir), layout);
   if (!maybe_tbl) {
     VAST_ERROR(self, "unable to generate table layout for", layout);
     return {};
   }
   self->state.init(std::move(*maybe_tbl));
+  self->state.tbl.parallelize(std::move(pool));
+  if (auto a = self->system().registry().get(accountant_atom::value))
+    self->state.accountant = actor_cast<accountant_type>(a);
   VAST_DEBUG(self, "operates for layout", layout);
   return {
     [=](const predicate& pred) {
@@ -76,8 +80,18 @@ behavior indexer(stateful_actor<indexer_state>* self, path dir,
           // nop
         },
         [=](unit_t&, const std::vector<table_slice_ptr>& xs) {
+          auto& st = self->state;
           for (auto& x : xs)
-            self->state.tbl.add(x);
+            st.tbl.add(x);
+          if (st.accountant) {
+            auto& layout = st.tbl.layout();
+            auto times = st.tbl.take_append_times();
+            for (size_t i = 0; i < times.size(); ++i)
+              if (times[i] > timespan::zero())
+                self->send(st.accountant, "indexer.append." + layout.name()
+                                            + '.' + layout.fields[i].name,
+                           times[i]);
+          }
         },
         [=](unit_t&, const error& err) {
           if (err && err != caf::exit_reason::user_shutdown) {
@@ -107,12 +107,13 @@ partition_ptr make_partition(caf::actor_system& sys, const path& base_dir,
 }
 
 partition_ptr make_partition(caf::actor_system& sys, caf::local_actor* self,
-                             const path& base_dir, uuid id) {
+                             const path& base_dir, uuid id,
+                             std::shared_ptr<detail::thread_pool> pool) {
   auto f = [=](path indexer_path, record_type indexer_type) {
     VAST_DEBUG(self, "creates INDEXER in partition", id, "for type",
                indexer_type);
     return self->spawn<caf::lazy_init>(indexer, std::move(indexer_path),
-                                       std::move(indexer_type));
+                                       std::move(indexer_type), pool);
   };
   return make_partition(sys, base_dir, std::move(id), f);
 }
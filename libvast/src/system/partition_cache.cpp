@@ -0,0 +1,76 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include "vast/system/partition_cache.hpp"
+
+#include "vast/detail/assert.hpp"
+
+namespace vast::system {
+
+partition_cache::partition_cache(size_t max_partitions, size_t max_bytes,
+                                 factory_type factory,
+                                 estimator_type estimator)
+  : max_partitions_{max_partitions},
+    max_bytes_{max_bytes},
+    factory_{std::move(factory)},
+    estimator_{std::move(estimator)} {
+  VAST_ASSERT(max_partitions_ > 0);
+}
+
+bool partition_cache::contains(const uuid& id) const {
+  return positions_.count(id) > 0;
+}
+
+void partition_cache::max_partitions(size_t n) {
+  VAST_ASSERT(n > 0);
+  max_partitions_ = n;
+  shrink();
+}
+
+void partition_cache::max_bytes(size_t n) {
+  max_bytes_ = n;
+  shrink();
+}
+
+partition_ptr& partition_cache::get_or_add(const uuid& id) {
+  if (auto i = positions_.find(id); i != positions_.end()) {
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, i->second);
+    return entries_.front().part;
+  }
+  ++stats_.misses;
+  auto part = factory_(id);
+  VAST_ASSERT(part != nullptr);
+  auto bytes = estimator_(*part);
+  entries_.push_front(entry{std::move(part), bytes});
+  positions_.emplace(id, entries_.begin());
+  bytes_ += bytes;
+  shrink();
+  return entries_.front().part;
+}
+
+void partition_cache::shrink() {
+  auto over_limit = [&] {
+    return entries_.size() > max_partitions_ || bytes_ > max_bytes_;
+  };
+  while (entries_.size() > 1 && over_limit()) {
+    auto& victim = entries_.back();
+    positions_.erase(victim.part->id());
+    bytes_ -= victim.bytes;
+    entries_.pop_back();
+    ++stats_.evictions;
+  }
+}
+
+} // namespace vast::system
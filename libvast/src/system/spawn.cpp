@@ -46,15 +46,33 @@ expected<actor> spawn_archive(local_actor* self, options& opts) {
   using namespace vast::binary_byte_literals;
   auto mss = size_t{128};
   auto segments = size_t{10};
+  auto method_name = std::string{"lz4"};
   auto r = opts.params.extract_opts({
     {"segments,s", "number of cached segments", segments},
-    {"max-segment-size,m", "maximum segment size in MB", mss}
+    {"max-segment-size,m", "maximum segment size in MB", mss},
+    {"compression,c", "table slice compression (null, lz4, snappy)",
+     method_name}
   });
   opts.params = r.remainder;
   if (!r.error.empty())
     return make_error(ec::syntax_error, r.error);
   mss *= 1_MiB;
-  auto a = self->spawn(archive, opts.dir / opts.label, segments, mss);
+  auto method = compression::lz4;
+  if (method_name == "null")
+    method = compression::null;
+#ifdef VAST_HAVE_SNAPPY
+  else if (method_name == "snappy")
+    method = compression::snappy;
+#endif
+  else if (method_name != "lz4")
+    return make_error(ec::syntax_error, "invalid compression method",
+                      method_name);
+  auto workers = get_or(self->system().config(), "vast.archive-workers",
+                        defaults::system::archive_workers);
+  if (workers == 0)
+    return make_error(ec::invalid_configuration,
+                      "vast.archive-workers must be positive");
+  auto a = self->spawn(archive, opts.dir / opts.label, segments, mss, method);
   return actor_cast<actor>(a);
 }
 
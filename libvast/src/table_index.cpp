@@ -13,6 +13,8 @@
 
 #include "vast/table_index.hpp"
 
+#include <algorithm>
+
 #include "vast/detail/overload.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/load.hpp"
@@ -32,6 +34,54 @@ auto key_to_dir(std::string key, const path& prefix) {
   return prefix / detail::replace_all(std::move(key), ".", path::separator);
 }
 
+// Appends all bits of `xs` starting at position `first` to `result`.
+void append_tail(ids& result, const ids& xs, ids::size_type first = 0) {
+  ids::size_type n = 0;
+  for (auto b : bit_range(xs)) {
+    if (n + b.size() > first) {
+      auto x = n < first ? drop(b, first - n) : b;
+      if (x.is_run())
+        result.append_bits(x.data(), x.size());
+      else
+        result.append_block(x.data(), x.size());
+    }
+    n += b.size();
+  }
+}
+
+// The relative cost of looking up a predicate in a column index, depending on
+// whether we must load the index from disk first.
+constexpr size_t loaded_column_cost = 1;
+constexpr size_t unloaded_column_cost = 4;
+
+// Scales the cost of a column lookup by the work for the operator. Equality
+// needs few bitmaps, ranges need more, and pattern matching or substring
+// search may need to consider every value.
+size_t operator_weight(relational_operator op, const data& rhs) {
+  switch (op) {
+    default:
+      return 1;
+    case less:
+    case less_equal:
+    case greater:
+    case greater_equal:
+      return 2;
+    case match:
+    case not_match:
+    case ni:
+    case not_ni:
+      return 8;
+    case in:
+    case not_in:
+      // Membership in a container requires one lookup per element.
+      if (auto xs = caf::get_if<vector>(&rhs))
+        return std::max(xs->size(), size_t{1});
+      if (auto xs = caf::get_if<set>(&rhs))
+        return std::max(xs->size(), size_t{1});
+      return 8;
+  }
+}
+
 } // namespace <anonymous>
 
 caf::expected<table_index> make_table_index(caf::actor_system& sys,
@@ -48,7 +98,9 @@ caf::expected<table_index> make_table_index(caf::actor_system& sys,
 
 // -- constructors, destructors, and assignment operators ----------------------
 
-table_index::table_index(caf::actor_system& sys) : sys_(sys) {
+table_index::table_index(caf::actor_system& sys)
+  : row_ids_journal_(sys, path{}),
+    sys_(sys) {
   // nop
 }
 
@@ -62,9 +114,24 @@ table_index::~table_index() noexcept {
 caf::error table_index::init() {
   VAST_TRACE("");
   columns_.resize(layout().fields.size());
-  auto filename = base_dir_ / "row_ids";
-  if (exists(filename))
-    return load(sys_, filename, row_ids_);
+  append_times_.resize(columns_.size());
+  if (auto err = row_ids_journal_.init())
+    return err;
+  if (!row_ids_journal_.has_snapshot())
+    return caf::none;
+  if (auto err = row_ids_journal_.load_snapshot(row_ids_))
+    return err;
+  auto apply = [&](ids::size_type first, ids& xs) -> caf::error {
+    // Skip records that a snapshot from an interrupted compaction contains.
+    if (first < row_ids_.size())
+      return caf::none;
+    row_ids_.append_bits(false, first - row_ids_.size());
+    append_tail(row_ids_, xs);
+    return caf::none;
+  };
+  if (auto err = row_ids_journal_.replay<ids::size_type, ids>(apply))
+    return err;
+  last_flush_ = row_ids_.size();
   return caf::none;
 }
 
@@ -73,8 +140,18 @@ caf::error table_index::flush_to_disk() {
   VAST_TRACE("");
   if (!dirty_)
     return caf::none;
-  if (auto err = save(sys_, base_dir_ / "row_ids", row_ids_))
-    return err;
+  if (!row_ids_journal_.has_snapshot() || row_ids_journal_.needs_compaction()) {
+    if (auto err = row_ids_journal_.snapshot(row_ids_))
+      return err;
+  } else if (row_ids_.size() > last_flush_) {
+    ids xs;
+    append_tail(xs, row_ids_, last_flush_);
+    if (auto err = row_ids_journal_.append(last_flush_, xs))
+      return err;
+    if (auto err = row_ids_journal_.commit())
+      return err;
+  }
+  last_flush_ = row_ids_.size();
   for (auto& col : columns_) {
     VAST_ASSERT(col != nullptr);
     if (auto err = col->flush_to_disk())
@@ -101,6 +178,16 @@ column_index* table_index::by_name(std::string_view column_name) {
   return i != columns_.end() ? i->get() : nullptr;
 }
 
+std::vector<timespan> table_index::take_append_times() {
+  std::vector<timespan> result(append_times_.size());
+  result.swap(append_times_);
+  return result;
+}
+
+void table_index::parallelize(std::shared_ptr<detail::thread_pool> pool) {
+  pool_ = std::move(pool);
+}
+
 caf::error table_index::add(const table_slice_ptr& x) {
   VAST_ASSERT(x != nullptr);
   VAST_ASSERT(x->layout() == layout());
@@ -112,43 +199,45 @@ caf::error table_index::add(const table_slice_ptr& x) {
   VAST_ASSERT(first >= row_ids_.size());
   row_ids_.append_bits(false, first - row_ids_.size());
   row_ids_.append_bits(true, last - first);
-  // Iterate columns directly if all columns are present in memory.
-  if (dirty_) {
-    for (auto& col : columns_) {
-      VAST_ASSERT(col != nullptr);
-      col->add(x);
+  // Create columns on-the-fly unless all columns are present in memory. This
+  // touches the file system, so we do it up front on the calling thread.
+  if (!dirty_) {
+    auto nop = [](column_index&) -> caf::error { return caf::none; };
+    // Iterate all types of the record.
+    size_t i = 0;
+    for (auto&& f : record_type::each{layout()}) {
+      auto& value_type = f.trace.back()->type;
+      if (!has_skip_attribute(layout())) {
+        auto fac = [&] {
+          VAST_DEBUG(this, "makes field indexer at offset", f.offset,
+                     "with type", value_type);
+          auto dir = key_to_dir(f.key(), data_dir());
+          return make_column_index(sys_, dir, value_type, i);
+        };
+        if (auto err = with_column(i, fac, nop))
+          return err;
+        ++i;
+      }
     }
-    return caf::none;
   }
-  // Create columns on-the-fly.
-  auto fun = [&](column_index& col) -> caf::error {
-    col.add(x);
-    return caf::none;
+  // Columns are independent of each other. Since we return only after all
+  // columns have processed the slice, each column sees slices in order.
+  auto append = [&](size_t i) {
+    auto& col = columns_[i];
+    if (col == nullptr)
+      return;
+    auto start = std::chrono::steady_clock::now();
+    col->add(x);
+    auto stop = std::chrono::steady_clock::now();
+    append_times_[i] += std::chrono::duration_cast<timespan>(stop - start);
   };
-  return caf::error::eval(
-    [&]() -> caf::error {
-      // Iterate all types of the record.
-      size_t i = 0;
-      for (auto&& f : record_type::each{layout()}) {
-        auto& value_type = f.trace.back()->type;
-        if (!has_skip_attribute(layout())) {
-          auto fac = [&] {
-            VAST_DEBUG(this, "makes field indexer at offset", f.offset,
-                       "with type", value_type);
-            auto dir = key_to_dir(f.key(), data_dir());
-            return make_column_index(sys_, dir, value_type, i);
-          };
-          if (auto err = with_column(i, fac, fun))
-            return err;
-          ++i;
-        }
-      }
-      return caf::none;
-    },
-    [&]() -> caf::error {
-      dirty_ = true;
-      return caf::none;
-    });
+  if (pool_ != nullptr)
+    pool_->parallel_for(columns_.size(), append);
+  else
+    for (size_t i = 0; i < columns_.size(); ++i)
+      append(i);
+  dirty_ = true;
+  return caf::none;
 }
 
 path table_index::meta_dir() const {
@@ -192,23 +281,32 @@ caf::expected<bitmap> table_index::lookup_impl(const expression& expr) {
         static_assert(is_disjunction
                       || std::is_same_v<decltype(seq), const conjunction&>);
         VAST_ASSERT(!seq.empty());
+        // Evaluate the cheapest operands first, so that we short-circuit
+        // before reaching the expensive ones where possible.
+        std::vector<std::pair<size_t, const expression*>> operands;
+        operands.reserve(seq.size());
+        for (auto& x : seq)
+          operands.emplace_back(estimate_cost(x), &x);
+        std::stable_sort(operands.begin(), operands.end(),
+                         [](auto& x, auto& y) { return x.first < y.first; });
         bitmap result;
         {
-          auto r0 = lookup_impl(seq.front());
+          auto r0 = lookup_impl(*operands.front().second);
           if (!r0)
             return r0.error();
           result = std::move(*r0);
         }
-        for (auto i = seq.begin() + 1; i != seq.end(); ++i) {
+        for (auto i = operands.begin() + 1; i != operands.end(); ++i) {
           // short-circuit
           if constexpr (is_disjunction) {
             if (all<1>(result))
               return result;
           } else {
-            if (all<0>(result))
+            // An empty bitmap, e.g., from a mismatching type, has no bit set.
+            if (!any<1>(result))
               return result;
           }
-          auto sub_result = lookup_impl(*i);
+          auto sub_result = lookup_impl(*i->second);
           if (!sub_result)
             return sub_result.error();
           if constexpr (is_disjunction)
@@ -300,6 +398,58 @@ caf::expected<bitmap> table_index::lookup_impl(const predicate& pred,
   return bitmap{};
 }
 
+size_t table_index::estimate_cost(const expression& expr) const {
+  auto column_cost = [&](const data_extractor& dx, relational_operator op,
+                         const data& x) -> size_t {
+    caf::optional<size_t> index;
+    if (auto r = caf::get_if<record_type>(&dx.type))
+      index = r->flat_index_at(dx.offset);
+    if (!index || *index >= columns_.size())
+      return 0;
+    auto base = columns_[*index] != nullptr ? loaded_column_cost
+                                            : unloaded_column_cost;
+    return base * operator_weight(op, x);
+  };
+  return caf::visit(detail::overload(
+    [&](const conjunction& xs) {
+      size_t result = 0;
+      for (auto& x : xs)
+        result += estimate_cost(x);
+      return result;
+    },
+    [&](const disjunction& xs) {
+      size_t result = 0;
+      for (auto& x : xs)
+        result += estimate_cost(x);
+      return result;
+    },
+    [&](const negation& x) {
+      return estimate_cost(x.expr());
+    },
+    [&](const predicate& p) {
+      return caf::visit(detail::overload(
+        [&](const attribute_extractor& ex, const data& x) -> size_t {
+          // Type queries never touch a column index.
+          if (ex.attr == system::type_atom::value)
+            return 0;
+          // Time queries go to the first column.
+          auto base = !columns_.empty() && columns_[0] != nullptr
+                        ? loaded_column_cost
+                        : unloaded_column_cost;
+          return base * operator_weight(p.op, x);
+        },
+        [&](const data_extractor& dx, const data& x) {
+          return column_cost(dx, p.op, x);
+        },
+        [&](const auto&, const auto&) -> size_t {
+          return 0;
+        }), p.lhs, p.rhs);
+    },
+    [](caf::none_t) -> size_t {
+      return 0;
+    }), expr);
+}
+
 // -- constructors, destructors, and assignment operators ----------------------
 
 table_index::table_index(caf::actor_system& sys, record_type layout,
@@ -307,6 +457,7 @@ table_index::table_index(caf::actor_system& sys, record_type layout,
   : type_erased_layout_(std::move(layout)),
     base_dir_(std::move(base_dir)),
     dirty_(false),
+    row_ids_journal_(sys, base_dir_ / "row_ids"),
     sys_(sys) {
   VAST_TRACE(VAST_ARG(type_erased_layout_), VAST_ARG(base_dir_));
 }
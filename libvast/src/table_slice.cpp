@@ -23,6 +23,7 @@
 #include <caf/serializer.hpp>
 #include <caf/sum_type.hpp>
 
+#include "vast/columnar_table_slice.hpp"
 #include "vast/default_table_slice.hpp"
 #include "vast/default_table_slice_builder.hpp"
 #include "vast/defaults.hpp"
@@ -106,6 +107,9 @@ table_slice_ptr make_table_slice(record_type layout, caf::actor_system& sys,
   if (impl == caf::atom("TS_Default")) {
     return caf::make_copy_on_write<default_table_slice>(std::move(layout));
   }
+  if (impl == caf::atom("TS_Columnar")) {
+    return caf::make_copy_on_write<columnar_table_slice>(std::move(layout));
+  }
   using generic_fun = caf::runtime_settings_map::generic_function_pointer;
   using factory_fun = table_slice_ptr (*)(record_type);
   auto val = sys.runtime_settings().get(impl);
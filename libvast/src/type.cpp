@@ -741,6 +741,12 @@ bool type_check(const type& t, const data& d) {
       auto e = get_if<enumeration_type>(&t);
       return e && x < e->fields.size();
     },
+    [&](const count& x) {
+      // Views represent enumeration values as counts.
+      if (auto e = get_if<enumeration_type>(&t))
+        return x < e->fields.size();
+      return holds_alternative<count_type>(t);
+    },
     [&](const vector& xs) {
       auto r = get_if<record_type>(&t);
       if (r) {
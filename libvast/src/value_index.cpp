@@ -19,6 +19,9 @@
 #include "vast/concept/parseable/vast/base.hpp"
 #include "vast/value_index.hpp"
 
+#include "vast/detail/varbyte.hpp"
+#include "vast/detail/zigzag.hpp"
+
 namespace vast {
 namespace {
 
@@ -48,7 +51,8 @@ value_index::~value_index() {
   // nop
 }
 
-std::unique_ptr<value_index> value_index::make(const type& t) {
+std::unique_ptr<value_index>
+value_index::make(const type& t, uint32_t version) {
   struct factory {
     using result_type = std::unique_ptr<value_index>;
     result_type operator()(const none_type&) const {
@@ -82,12 +86,16 @@ std::unique_ptr<value_index> value_index::make(const type& t) {
       return std::make_unique<arithmetic_index<timespan>>(std::move(*b));
     }
     result_type operator()(const timestamp_type& t) const {
+      if (detail::has_time_index(t, version))
+        return std::make_unique<time_index>();
       auto b = parse_base(t);
       if (!b)
         return nullptr;
       return std::make_unique<arithmetic_index<timestamp>>(std::move(*b));
     }
     result_type operator()(const string_type& t) const {
+      if (detail::has_dictionary_index(t, version))
+        return std::make_unique<dictionary_index>();
       auto max_length = size_t{1024};
       if (auto a = extract_attribute(t, "max_length")) {
         if (auto x = to<size_t>(*a))
@@ -98,21 +106,29 @@ std::unique_ptr<value_index> value_index::make(const type& t) {
       return std::make_unique<string_index>(max_length);
     }
     result_type operator()(const pattern_type&) const {
-      return nullptr;
+      if (version < 2)
+        return nullptr;
+      return std::make_unique<pattern_index>();
     }
-    result_type operator()(const address_type&) const {
+    result_type operator()(const address_type& t) const {
+      if (detail::has_radix_index(t, version))
+        return std::make_unique<radix_address_index>();
       return std::make_unique<address_index>();
     }
     result_type operator()(const subnet_type&) const {
-      return std::make_unique<subnet_index>();
+      return std::make_unique<subnet_index>(version);
     }
     result_type operator()(const port_type&) const {
       return std::make_unique<port_index>();
     }
-    result_type operator()(const enumeration_type&) const {
-      return nullptr;
+    result_type operator()(const enumeration_type& t) const {
+      if (version == 0)
+        return nullptr;
+      return std::make_unique<enumeration_index>(t.fields);
     }
     result_type operator()(const vector_type& t) const {
+      if (!detail::has_sequence_index(t, version))
+        return std::make_unique<membership_index>();
       auto max_size = size_t{1024};
       if (auto a = extract_attribute(t, "max_size")) {
         if (auto x = to<size_t>(*a))
@@ -120,9 +136,12 @@ std::unique_ptr<value_index> value_index::make(const type& t) {
         else
           return nullptr;
       }
-      return std::make_unique<sequence_index>(t.value_type, max_size);
+      return std::make_unique<sequence_index>(t.value_type, max_size,
+                                              version);
     }
     result_type operator()(const set_type& t) const {
+      if (!detail::has_sequence_index(t, version))
+        return std::make_unique<membership_index>();
       auto max_size = size_t{1024};
       if (auto a = extract_attribute(t, "max_size")) {
         if (auto x = to<size_t>(*a))
@@ -130,10 +149,13 @@ std::unique_ptr<value_index> value_index::make(const type& t) {
         else
           return nullptr;
       }
-      return std::make_unique<sequence_index>(t.value_type, max_size);
+      return std::make_unique<sequence_index>(t.value_type, max_size,
+                                              version);
     }
     result_type operator()(const map_type&) const {
-      return nullptr;
+      if (version == 0)
+        return nullptr;
+      return std::make_unique<membership_index>();
     }
     result_type operator()(const record_type&) const {
       return nullptr;
@@ -141,8 +163,9 @@ std::unique_ptr<value_index> value_index::make(const type& t) {
     result_type operator()(const alias_type& t) const {
       return caf::visit(*this, t.value_type);
     }
+    uint32_t version;
   };
-  return caf::visit(factory{}, t);
+  return caf::visit(factory{version}, t);
 }
 
 expected<void> value_index::append(data_view x) {
@@ -165,6 +188,33 @@ expected<void> value_index::append(data_view x, id pos) {
   return {};
 }
 
+expected<void> value_index::append(const table_slice& slice, size_t column) {
+  VAST_ASSERT(column < slice.columns());
+  auto first = slice.offset();
+  auto off = mask_.size();
+  if (first < off)
+    // Can only append at the end
+    return make_error(ec::unspecified, first, '<', off);
+  if (!append_column_impl(slice, column))
+    return make_error(ec::unspecified, "append_column_impl");
+  mask_.append_bits(false, first + slice.rows() - mask_.size());
+  return {};
+}
+
+bool value_index::append_column_impl(const table_slice& slice,
+                                     size_t column) {
+  // Only whole runs extend the mask, so a run must either succeed or fail
+  // entirely. Appending equal values has the same outcome, hence only the
+  // first value of a run can fail.
+  return for_each_run(slice, column, [&](data_view x, id pos, size_t n) {
+    if (!append_impl(x, pos))
+      return false;
+    for (size_t i = 1; i < n; ++i)
+      append_impl(x, pos + i);
+    return true;
+  });
+}
+
 expected<ids> value_index::lookup(relational_operator op, data_view x) const {
   if (caf::holds_alternative<caf::none_t>(x)) {
     if (op == equal)
@@ -176,13 +226,29 @@ expected<ids> value_index::lookup(relational_operator op, data_view x) const {
   auto result = lookup_impl(op, x);
   if (!result)
     return result;
-  return (*result - none_) & mask_;
+  // Skip operations without effect. Besides saving work, this keeps the
+  // concrete bitmap type of the result when it differs from the EWAH
+  // bitmaps of the masks.
+  if (any(none_))
+    *result -= none_;
+  if (result->size() != mask_.size() || !all(mask_))
+    *result &= mask_;
+  return result;
 }
 
 value_index::size_type value_index::offset() const {
   return mask_.size();
 }
 
+void value_index::select_bitmap_type(caf::atom_value type) {
+  VAST_ASSERT(bitmap::valid_type(type));
+  bitmap_type_ = type;
+}
+
+caf::atom_value value_index::bitmap_type() const {
+  return bitmap_type_;
+}
+
 // -- string_index -------------------------------------------------------------
 
 string_index::string_index(size_t max_length) : max_length_{max_length} {
@@ -198,6 +264,17 @@ void string_index::init() {
 }
 
 bool string_index::append_impl(data_view x, id pos) {
+  return append_run(x, pos, 1);
+}
+
+bool string_index::append_column_impl(const table_slice& slice,
+                                      size_t column) {
+  return for_each_run(slice, column, [&](data_view x, id pos, size_t n) {
+    return append_run(x, pos, n);
+  });
+}
+
+bool string_index::append_run(data_view x, id pos, size_t n) {
   auto str = caf::get_if<view<std::string>>(&x);
   if (!str)
     return false;
@@ -209,10 +286,10 @@ bool string_index::append_impl(data_view x, id pos) {
     chars_.resize(length, char_bitmap_index{8});
   for (auto i = 0u; i < length; ++i) {
     chars_[i].skip(pos - chars_[i].size());
-    chars_[i].append(static_cast<uint8_t>((*str)[i]));
+    chars_[i].append(static_cast<uint8_t>((*str)[i]), n);
   }
   length_.skip(pos - length_.size());
-  length_.append(length);
+  length_.append(length, n);
   return true;
 }
 
@@ -285,6 +362,403 @@ string_index::lookup_impl(relational_operator op, data_view x) const {
   ), x);
 }
 
+// -- dictionary_index ---------------------------------------------------------
+
+size_t dictionary_index::find(std::string_view x) const {
+  auto [first, last] = codes_.equal_range(std::hash<std::string_view>{}(x));
+  for (auto i = first; i != last; ++i)
+    if (values_[i->second] == x)
+      return i->second;
+  return values_.size();
+}
+
+void dictionary_index::rebuild_codes() {
+  codes_.clear();
+  codes_.reserve(values_.size());
+  for (size_t i = 0; i < values_.size(); ++i)
+    codes_.emplace(std::hash<std::string_view>{}(values_[i]), i);
+}
+
+bool dictionary_index::append_impl(data_view x, id pos) {
+  return append_run(x, pos, 1);
+}
+
+bool dictionary_index::append_column_impl(const table_slice& slice,
+                                          size_t column) {
+  return for_each_run(slice, column, [&](data_view x, id pos, size_t n) {
+    return append_run(x, pos, n);
+  });
+}
+
+bool dictionary_index::append_run(data_view x, id pos, size_t n) {
+  auto str = caf::get_if<view<std::string>>(&x);
+  if (!str)
+    return false;
+  auto code = find(*str);
+  if (code == values_.size()) {
+    codes_.emplace(std::hash<std::string_view>{}(*str), code);
+    values_.emplace_back(*str);
+    postings_.emplace_back(bitmap_type());
+  }
+  auto& bm = postings_[code];
+  bm.append_bits(false, pos - bm.size());
+  bm.append_bits(true, n);
+  return true;
+}
+
+expected<ids>
+dictionary_index::lookup_impl(relational_operator op, data_view x) const {
+  auto bulk = [&](const std::vector<data_view>& xs) { return bulk_lookup(xs); };
+  // Brings a bitmap of occurrences up to the size of the index.
+  auto finish = [&](ids result, bool flip) {
+    result.append_bits(false, offset() - result.size());
+    if (flip)
+      result.flip();
+    return result;
+  };
+  return caf::visit(detail::overload(
+    [&](auto x) -> expected<ids> {
+      return make_error(ec::type_clash, materialize(x));
+    },
+    [&](view<std::string> str) -> expected<ids> {
+      switch (op) {
+        default:
+          return make_error(ec::unsupported_operator, op);
+        case equal:
+        case not_equal: {
+          auto code = find(str);
+          if (code == values_.size())
+            return ids{offset(), op == not_equal};
+          return finish(postings_[code], op == not_equal);
+        }
+        case ni:
+        case not_ni: {
+          ids result{offset(), false};
+          for (size_t i = 0; i < values_.size(); ++i)
+            if (values_[i].find(str) != std::string::npos)
+              result |= postings_[i];
+          return finish(std::move(result), op == not_ni);
+        }
+      }
+    },
+    [&](view<vector> xs) {
+      return detail::container_lookup(*this, op, xs, bulk);
+    },
+    [&](view<set> xs) {
+      return detail::container_lookup(*this, op, xs, bulk);
+    }
+  ), x);
+}
+
+expected<ids>
+dictionary_index::bulk_lookup(const std::vector<data_view>& xs) const {
+  // Collect the occurrences of every distinct value only once.
+  std::vector<bool> selected(values_.size(), false);
+  std::vector<ids> hits;
+  for (auto x : xs) {
+    auto str = caf::get_if<view<std::string>>(&x);
+    if (!str)
+      return make_error(ec::type_clash, materialize(x));
+    auto code = find(*str);
+    if (code < values_.size() && !selected[code]) {
+      selected[code] = true;
+      hits.push_back(postings_[code]);
+    }
+  }
+  return ids{nary_or(hits.begin(), hits.end())};
+}
+
+// -- pattern_index ------------------------------------------------------------
+
+bool pattern_index::append_impl(data_view x, id pos) {
+  if (auto p = caf::get_if<view<pattern>>(&x))
+    return static_cast<bool>(dictionary_.append(data_view{p->string()}, pos));
+  return false;
+}
+
+void pattern_index::select_bitmap_type(caf::atom_value type) {
+  value_index::select_bitmap_type(type);
+  dictionary_.select_bitmap_type(type);
+}
+
+expected<ids>
+pattern_index::lookup_impl(relational_operator op, data_view x) const {
+  return caf::visit(detail::overload(
+    [&](auto x) -> expected<ids> {
+      return make_error(ec::type_clash, materialize(x));
+    },
+    [&](view<pattern> p) -> expected<ids> {
+      if (!(op == equal || op == not_equal))
+        return make_error(ec::unsupported_operator, op);
+      auto result = dictionary_.lookup(op, data_view{p.string()});
+      if (result)
+        result->append_bits(op == not_equal, offset() - result->size());
+      return result;
+    },
+    [&](view<vector> xs) { return detail::container_lookup(*this, op, xs); },
+    [&](view<set> xs) { return detail::container_lookup(*this, op, xs); }
+  ), x);
+}
+
+// -- time_index ---------------------------------------------------------------
+
+namespace {
+
+// Appends the IDs of value ranges to a bitmap. The ranges must arrive in
+// ascending order.
+class id_emitter {
+public:
+  id_emitter(const std::vector<std::pair<id, uint64_t>>& runs, ids& result)
+    : runs_{runs},
+      result_{result} {
+    // nop
+  }
+
+  // Appends the IDs of the values in [first, last).
+  void operator()(uint64_t first, uint64_t last) {
+    while (first < last) {
+      while (run_begin_ + runs_[run_].second <= first)
+        run_begin_ += runs_[run_++].second;
+      auto run_end = run_begin_ + runs_[run_].second;
+      auto n = std::min(last, run_end) - first;
+      auto pos = runs_[run_].first + (first - run_begin_);
+      result_.append_bits(false, pos - result_.size());
+      result_.append_bits(true, n);
+      first += n;
+    }
+  }
+
+private:
+  const std::vector<std::pair<id, uint64_t>>& runs_;
+  ids& result_;
+  size_t run_ = 0;
+  uint64_t run_begin_ = 0;
+};
+
+} // namespace <anonymous>
+
+bool time_index::append_impl(data_view x, id pos) {
+  return append_run(x, pos, 1);
+}
+
+bool time_index::append_column_impl(const table_slice& slice, size_t column) {
+  return for_each_run(slice, column, [&](data_view x, id pos, size_t n) {
+    return append_run(x, pos, n);
+  });
+}
+
+bool time_index::append_run(data_view x, id pos, size_t n) {
+  auto t = caf::get_if<view<timestamp>>(&x);
+  if (!t)
+    return false;
+  auto value = t->time_since_epoch().count();
+  for (size_t i = 0; i < n; ++i) {
+    if (blocks_.empty() || blocks_.back().size == block_size) {
+      auto& b = blocks_.emplace_back();
+      b.min = value;
+      b.max = value;
+    }
+    auto& b = blocks_.back();
+    b.min = std::min(b.min, value);
+    b.max = std::max(b.max, value);
+    if (b.size > 0 && value < b.last)
+      b.ascending = false;
+    // Compute the difference in unsigned arithmetic to avoid overflows.
+    auto delta = static_cast<uint64_t>(value) - static_cast<uint64_t>(b.last);
+    auto code = detail::zigzag::encode(static_cast<int64_t>(delta));
+    uint8_t buf[detail::varbyte::max_size<uint64_t>()];
+    auto size = detail::varbyte::encode(code, buf);
+    b.bytes.insert(b.bytes.end(), buf, buf + size);
+    b.last = value;
+    ++b.size;
+  }
+  if (!runs_.empty() && runs_.back().first + runs_.back().second == pos)
+    runs_.back().second += n;
+  else
+    runs_.emplace_back(pos, n);
+  return true;
+}
+
+void time_index::decode(const block& x, std::vector<rep>& out) {
+  out.resize(x.size);
+  auto ptr = x.bytes.data();
+  auto value = uint64_t{0};
+  for (size_t i = 0; i < x.size; ++i) {
+    uint64_t code;
+    ptr += detail::varbyte::decode(code, ptr);
+    value += static_cast<uint64_t>(detail::zigzag::decode(code));
+    out[i] = static_cast<rep>(value);
+  }
+}
+
+expected<ids>
+time_index::lookup_impl(relational_operator op, data_view x) const {
+  auto bulk = [&](const std::vector<data_view>& xs) { return bulk_lookup(xs); };
+  auto lookup_time = [&](rep y) -> expected<ids> {
+    // Decides whether a range [lo, hi] of values matches entirely (1), not at
+    // all (0), or partially (-1).
+    auto classify = [&](rep lo, rep hi) {
+      switch (op) {
+        default:
+          return -1;
+        case equal:
+          return y < lo || y > hi ? 0 : lo == hi ? 1 : -1;
+        case not_equal:
+          return y < lo || y > hi ? 1 : lo == hi ? 0 : -1;
+        case less:
+          return hi < y ? 1 : lo >= y ? 0 : -1;
+        case less_equal:
+          return hi <= y ? 1 : lo > y ? 0 : -1;
+        case greater:
+          return lo > y ? 1 : hi <= y ? 0 : -1;
+        case greater_equal:
+          return lo >= y ? 1 : hi < y ? 0 : -1;
+      }
+    };
+    auto pred = [&](rep v) {
+      switch (op) {
+        default:
+          return false;
+        case equal:
+          return v == y;
+        case not_equal:
+          return v != y;
+        case less:
+          return v < y;
+        case less_equal:
+          return v <= y;
+        case greater:
+          return v > y;
+        case greater_equal:
+          return v >= y;
+      }
+    };
+    switch (op) {
+      default:
+        return make_error(ec::unsupported_operator, op);
+      case equal:
+      case not_equal:
+      case less:
+      case less_equal:
+      case greater:
+      case greater_equal:
+        break;
+    }
+    ids result;
+    id_emitter emit{runs_, result};
+    std::vector<rep> values;
+    uint64_t first = 0;
+    for (auto& b : blocks_) {
+      auto last = first + b.size;
+      auto c = classify(b.min, b.max);
+      if (c == 1) {
+        emit(first, last);
+      } else if (c == -1) {
+        decode(b, values);
+        if (b.ascending) {
+          auto begin = values.begin();
+          auto end = values.end();
+          auto lb = first + static_cast<uint64_t>(
+                                std::lower_bound(begin, end, y) - begin);
+          auto ub = first + static_cast<uint64_t>(
+                                std::upper_bound(begin, end, y) - begin);
+          switch (op) {
+            default:
+              break;
+            case equal:
+              emit(lb, ub);
+              break;
+            case not_equal:
+              emit(first, lb);
+              emit(ub, last);
+              break;
+            case less:
+              emit(first, lb);
+              break;
+            case less_equal:
+              emit(first, ub);
+              break;
+            case greater:
+              emit(ub, last);
+              break;
+            case greater_equal:
+              emit(lb, last);
+              break;
+          }
+        } else {
+          for (size_t i = 0; i < values.size(); ++i)
+            if (pred(values[i]))
+              emit(first + i, first + i + 1);
+        }
+      }
+      first = last;
+    }
+    result.append_bits(false, offset() - result.size());
+    return result;
+  };
+  return caf::visit(detail::overload(
+    [&](auto x) -> expected<ids> {
+      return make_error(ec::type_clash, materialize(x));
+    },
+    [&](view<timestamp> x) -> expected<ids> {
+      return lookup_time(x.time_since_epoch().count());
+    },
+    [&](view<vector> xs) {
+      return detail::container_lookup(*this, op, xs, bulk);
+    },
+    [&](view<set> xs) {
+      return detail::container_lookup(*this, op, xs, bulk);
+    }
+  ), x);
+}
+
+expected<ids> time_index::bulk_lookup(const std::vector<data_view>& xs) const {
+  std::vector<rep> ys;
+  ys.reserve(xs.size());
+  for (auto x : xs) {
+    auto t = caf::get_if<view<timestamp>>(&x);
+    if (!t)
+      return make_error(ec::type_clash, materialize(x));
+    ys.push_back(t->time_since_epoch().count());
+  }
+  std::sort(ys.begin(), ys.end());
+  ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+  ids result;
+  id_emitter emit{runs_, result};
+  std::vector<rep> values;
+  uint64_t first = 0;
+  for (auto& b : blocks_) {
+    auto last = first + b.size;
+    // Restrict the probes to the timestamps within the bounds of the block.
+    auto lo = std::lower_bound(ys.begin(), ys.end(), b.min);
+    auto hi = std::upper_bound(lo, ys.end(), b.max);
+    if (lo != hi) {
+      if (b.min == b.max) {
+        emit(first, last);
+      } else {
+        decode(b, values);
+        if (b.ascending) {
+          // Merge the sorted probes with the sorted values.
+          auto begin = values.begin();
+          for (auto y = lo; y != hi; ++y) {
+            auto [l, u] = std::equal_range(begin, values.end(), *y);
+            emit(first + static_cast<uint64_t>(l - values.begin()),
+                 first + static_cast<uint64_t>(u - values.begin()));
+            begin = u;
+          }
+        } else {
+          for (size_t i = 0; i < values.size(); ++i)
+            if (std::binary_search(lo, hi, values[i]))
+              emit(first + i, first + i + 1);
+        }
+      }
+    }
+    first = last;
+  }
+  result.append_bits(false, offset() - result.size());
+  return result;
+}
+
 // -- address_index ------------------------------------------------------------
 
 void address_index::init() {
@@ -294,6 +768,17 @@ void address_index::init() {
 }
 
 bool address_index::append_impl(data_view x, id pos) {
+  return append_run(x, pos, 1);
+}
+
+bool address_index::append_column_impl(const table_slice& slice,
+                                       size_t column) {
+  return for_each_run(slice, column, [&](data_view x, id pos, size_t n) {
+    return append_run(x, pos, n);
+  });
+}
+
+bool address_index::append_run(data_view x, id pos, size_t n) {
   init();
   auto addr = caf::get_if<view<address>>(&x);
   if (!addr)
@@ -301,10 +786,10 @@ bool address_index::append_impl(data_view x, id pos) {
   auto& bytes = addr->data();
   for (auto i = 0u; i < 16; ++i) {
     bytes_[i].skip(pos - bytes_[i].size());
-    bytes_[i].append(bytes[i]);
+    bytes_[i].append(bytes[i], n);
   }
   v4_.skip(pos - v4_.size());
-  v4_.append(addr->is_v4());
+  v4_.append(addr->is_v4(), n);
   return true;
 }
 
@@ -357,8 +842,177 @@ address_index::lookup_impl(relational_operator op, data_view d) const {
   ), d);
 }
 
+// -- radix_address_index ------------------------------------------------------
+
+void radix_address_index::rebuild_trees() {
+  for (auto& lvl : levels_) {
+    lvl.tree.clear();
+    for (size_t i = 0; i < lvl.prefixes.size(); ++i)
+      lvl.tree.insert({lvl.prefixes[i], i});
+  }
+}
+
+bool radix_address_index::append_impl(data_view x, id pos) {
+  return append_run(x, pos, 1);
+}
+
+bool radix_address_index::append_column_impl(const table_slice& slice,
+                                             size_t column) {
+  return for_each_run(slice, column, [&](data_view x, id pos, size_t n) {
+    return append_run(x, pos, n);
+  });
+}
+
+bool radix_address_index::append_run(data_view x, id pos, size_t n) {
+  auto addr = caf::get_if<view<address>>(&x);
+  if (!addr)
+    return false;
+  auto bytes = reinterpret_cast<const char*>(addr->data().data());
+  for (size_t i = 0; i < levels_.size(); ++i) {
+    auto length = i + 1;
+    auto& lvl = levels_[i];
+    auto [it, inserted] = lvl.tree.insert({{bytes, length}, 0});
+    if (inserted) {
+      it->second = lvl.prefixes.size();
+      lvl.prefixes.emplace_back(bytes, length);
+      lvl.postings.emplace_back(bitmap_type());
+    }
+    auto& bm = lvl.postings[it->second];
+    bm.append_bits(false, pos - bm.size());
+    bm.append_bits(true, n);
+  }
+  return true;
+}
+
+ids radix_address_index::lookup_prefix(const std::array<uint8_t, 16>& bytes,
+                                       size_t bits) const {
+  VAST_ASSERT(bits <= 128);
+  if (bits == 0)
+    return ids{offset(), true};
+  // The shortest level covering the subnet leaves fewer than 8 bits open, so
+  // we enumerate the at most 128 prefixes within its last byte.
+  auto length = (bits + 7) / 8;
+  auto& lvl = levels_[length - 1];
+  auto gap = length * 8 - bits;
+  std::string key{reinterpret_cast<const char*>(bytes.data()), length};
+  auto fixed = (static_cast<uint8_t>(key.back()) >> gap) << gap;
+  std::vector<ids> hits;
+  for (auto suffix = 0u; suffix < (1u << gap); ++suffix) {
+    key.back() = static_cast<char>(fixed | suffix);
+    auto it = lvl.tree.find(key);
+    if (it != lvl.tree.end())
+      hits.push_back(lvl.postings[it->second]);
+  }
+  return ids{nary_or(hits.begin(), hits.end())};
+}
+
+expected<ids>
+radix_address_index::lookup_impl(relational_operator op, data_view d) const {
+  auto bulk = [&](const std::vector<data_view>& xs) { return bulk_lookup(xs); };
+  // Brings a bitmap up to the size of the index.
+  auto finish = [&](ids result, bool flip) {
+    result.append_bits(false, offset() - result.size());
+    if (flip)
+      result.flip();
+    return result;
+  };
+  // Unions the subnets that make up all addresses less than *x*: for every
+  // bit set in *x*, the subnet that shares the bits before it and has a 0
+  // in its place.
+  auto less_than = [&](const address& x) {
+    std::vector<ids> hits;
+    auto bytes = x.data();
+    for (size_t bit = 0; bit < 128; ++bit) {
+      auto mask = static_cast<uint8_t>(0x80 >> (bit % 8));
+      auto& byte = bytes[bit / 8];
+      if (byte & mask) {
+        byte &= ~mask;
+        hits.push_back(lookup_prefix(bytes, bit + 1));
+        byte |= mask;
+      }
+    }
+    return nary_or(hits.begin(), hits.end());
+  };
+  return caf::visit(detail::overload(
+    [&](auto x) -> expected<ids> {
+      return make_error(ec::type_clash, materialize(x));
+    },
+    [&](view<address> x) -> expected<ids> {
+      switch (op) {
+        default:
+          return make_error(ec::unsupported_operator, op);
+        case equal:
+        case not_equal:
+          return finish(lookup_prefix(x.data(), 128), op == not_equal);
+        case less:
+        case greater_equal:
+          return finish(less_than(x), op == greater_equal);
+        case less_equal:
+        case greater:
+          return finish(less_than(x) | lookup_prefix(x.data(), 128),
+                        op == greater);
+      }
+    },
+    [&](view<subnet> x) -> expected<ids> {
+      if (!(op == in || op == not_in))
+        return make_error(ec::unsupported_operator, op);
+      auto bits = x.length() + (x.network().is_v4() ? 96u : 0u);
+      return finish(lookup_prefix(x.network().data(), bits), op == not_in);
+    },
+    [&](view<vector> xs) {
+      return detail::container_lookup(*this, op, xs, bulk);
+    },
+    [&](view<set> xs) {
+      return detail::container_lookup(*this, op, xs, bulk);
+    }
+  ), d);
+}
+
+expected<ids>
+radix_address_index::bulk_lookup(const std::vector<data_view>& xs) const {
+  auto& lvl = levels_.back();
+  std::vector<bool> selected(lvl.prefixes.size(), false);
+  std::vector<ids> hits;
+  for (auto x : xs) {
+    auto addr = caf::get_if<view<address>>(&x);
+    if (!addr)
+      return make_error(ec::type_clash, materialize(x));
+    auto bytes = reinterpret_cast<const char*>(addr->data().data());
+    auto it = lvl.tree.find({bytes, 16});
+    if (it != lvl.tree.end() && !selected[it->second]) {
+      selected[it->second] = true;
+      hits.push_back(lvl.postings[it->second]);
+    }
+  }
+  return ids{nary_or(hits.begin(), hits.end())};
+}
+
 // -- subnet_index -------------------------------------------------------------
 
+subnet_index::subnet_index(uint32_t version) : version_{version} {
+  // nop
+}
+
+std::string subnet_index::key(const subnet& x) {
+  auto bits = x.length() + (x.network().is_v4() ? 96u : 0u);
+  auto& bytes = x.network().data();
+  std::string result(bits, '0');
+  for (size_t i = 0; i < bits; ++i)
+    if (bytes[i / 8] & (0x80 >> (i % 8)))
+      result[i] = '1';
+  return result;
+}
+
+bool subnet_index::has_tree() const {
+  return version_ >= 2;
+}
+
+void subnet_index::rebuild_tree() {
+  tree_.clear();
+  for (size_t i = 0; i < prefixes_.size(); ++i)
+    tree_.insert({prefixes_[i], i});
+}
+
 void subnet_index::init() {
   if (length_.coder().storage().empty())
     length_ = prefix_index{128 + 1}; // Valid prefixes range from /0 to /128.
@@ -369,7 +1023,20 @@ bool subnet_index::append_impl(data_view x, id pos) {
     init();
     length_.skip(pos - length_.size());
     length_.append(sn->length());
-    return static_cast<bool>(network_.append(sn->network(), pos));
+    if (!network_.append(sn->network(), pos))
+      return false;
+    if (has_tree()) {
+      auto [it, inserted] = tree_.insert({key(*sn), 0});
+      if (inserted) {
+        it->second = prefixes_.size();
+        prefixes_.push_back(it->first);
+        postings_.emplace_back(bitmap_type());
+      }
+      auto& bm = postings_[it->second];
+      bm.append_bits(false, pos - bm.size());
+      bm.append_bit(true);
+    }
+    return true;
   }
   return false;
 }
@@ -414,11 +1081,26 @@ subnet_index::lookup_impl(relational_operator op, data_view d) const {
           // subset relationship such that `U ni x` translates to U ⊇ x, i.e.,
           // the lookup returns all subnets in U that include x.
           ids result;
+          if (has_tree()) {
+            // The subnets that include x are the prefixes of x.
+            std::vector<ids> hits;
+            for (auto& it : tree_.prefix_of(key(x)))
+              hits.push_back(postings_[it->second]);
+            result = ids{nary_or(hits.begin(), hits.end())};
+            result.append_bits(false, offset() - result.size());
+            if (op == not_ni)
+              result.flip();
+            return result;
+          }
           for (auto i = uint8_t{1}; i <= x.length(); ++i) {
+            // Skip prefix lengths without any subnets.
+            auto n = length_.lookup(equal, i);
+            if (all<0>(n))
+              continue;
             auto xs = network_.lookup(in, subnet{x.network(), i});
             if (!xs)
               return xs;
-            *xs &= length_.lookup(equal, i);
+            *xs &= n;
             result |= *xs;
           }
           if (op == not_ni)
@@ -442,12 +1124,22 @@ void port_index::init() {
 }
 
 bool port_index::append_impl(data_view x, id pos) {
+  return append_run(x, pos, 1);
+}
+
+bool port_index::append_column_impl(const table_slice& slice, size_t column) {
+  return for_each_run(slice, column, [&](data_view x, id pos, size_t n) {
+    return append_run(x, pos, n);
+  });
+}
+
+bool port_index::append_run(data_view x, id pos, size_t n) {
   if (auto p = caf::get_if<view<port>>(&x)) {
     init();
     num_.skip(pos - num_.size());
-    num_.append(p->number());
+    num_.append(p->number(), n);
     proto_.skip(pos - proto_.size());
-    proto_.append(p->type());
+    proto_.append(p->type(), n);
     return true;
   }
   return false;
@@ -476,11 +1168,77 @@ port_index::lookup_impl(relational_operator op, data_view d) const {
   ), d);
 }
 
+// -- enumeration_index --------------------------------------------------------
+
+enumeration_index::enumeration_index(std::vector<std::string> fields)
+  : fields_{std::move(fields)},
+    index_{fields_.size()} {
+  // nop
+}
+
+bool enumeration_index::append_impl(data_view x, id pos) {
+  return append_run(x, pos, 1);
+}
+
+bool enumeration_index::append_column_impl(const table_slice& slice,
+                                           size_t column) {
+  return for_each_run(slice, column, [&](data_view x, id pos, size_t n) {
+    return append_run(x, pos, n);
+  });
+}
+
+bool enumeration_index::append_run(data_view x, id pos, size_t n) {
+  // Views represent enumeration values as counts.
+  auto e = caf::get_if<view<count>>(&x);
+  if (!e || *e >= fields_.size())
+    return false;
+  index_.skip(pos - index_.size());
+  index_.append(static_cast<enumeration>(*e), n);
+  return true;
+}
+
+expected<ids>
+enumeration_index::lookup_field(relational_operator op, enumeration x) const {
+  if (op != equal && op != not_equal)
+    return make_error(ec::unsupported_operator, op);
+  if (x >= fields_.size())
+    return ids{offset(), op == not_equal};
+  return index_.lookup(op, x);
+}
+
+expected<ids>
+enumeration_index::lookup_impl(relational_operator op, data_view d) const {
+  return caf::visit(detail::overload(
+    [&](auto x) -> expected<ids> {
+      return make_error(ec::type_clash, materialize(x));
+    },
+    [&](view<count> x) {
+      if (x >= fields_.size())
+        return lookup_field(op, static_cast<enumeration>(fields_.size()));
+      return lookup_field(op, static_cast<enumeration>(x));
+    },
+    [&](view<std::string> x) {
+      auto i = std::find(fields_.begin(), fields_.end(), x);
+      return lookup_field(op, static_cast<enumeration>(i - fields_.begin()));
+    },
+    [&](view<vector> xs) { return detail::container_lookup(*this, op, xs); },
+    [&](view<set> xs) { return detail::container_lookup(*this, op, xs); }
+  ), d);
+}
+
 // -- sequence_index -----------------------------------------------------------
 
-sequence_index::sequence_index(vast::type t, size_t max_size)
+sequence_index::sequence_index(vast::type t, size_t max_size,
+                               uint32_t version)
   : max_size_{max_size},
-    value_type_{std::move(t)} {
+    value_type_{std::move(t)},
+    version_{version} {
+}
+
+void sequence_index::select_bitmap_type(caf::atom_value type) {
+  value_index::select_bitmap_type(type);
+  for (auto& element : elements_)
+    element->select_bitmap_type(type);
 }
 
 void sequence_index::init() {
@@ -535,7 +1293,8 @@ void serialize(caf::serializer& sink, const sequence_index& idx) {
                  [&](auto& vi) {
                    auto& t = const_cast<type&>(idx.value_type_);
                    auto& x = const_cast<std::unique_ptr<value_index>&>(vi);
-                   return detail::value_index_inspect_helper{t, x};
+                   return detail::value_index_inspect_helper{t, x,
+                                                             idx.version_};
                  });
   sink & xs;
 }
@@ -557,7 +1316,8 @@ void serialize(caf::deserializer& source, sequence_index& idx) {
                    [&](auto& vi) {
                      auto& t = idx.value_type_;
                      auto& x = vi;
-                     return detail::value_index_inspect_helper{t, x};
+                     return detail::value_index_inspect_helper{t, x,
+                                                               idx.version_};
                    });
     for (auto& x : xs)
       source & x;
@@ -572,4 +1332,60 @@ void serialize(caf::deserializer& source, sequence_index& idx) {
     VAST_RAISE_ERROR("cannot serialize sequence index");
 }
 
+// -- membership_index ---------------------------------------------------------
+
+membership_index::membership_index() : size_{base::uniform<32>(10)} {
+  // nop
+}
+
+data membership_index::key(data_view x) {
+  if (auto i = caf::get_if<view<integer>>(&x); i && *i >= 0)
+    return count{static_cast<count>(*i)};
+  return materialize(x);
+}
+
+bool membership_index::append_impl(data_view x, id pos) {
+  if (auto xs = caf::get_if<view<vector>>(&x))
+    return container_append(**xs, pos);
+  if (auto xs = caf::get_if<view<set>>(&x))
+    return container_append(**xs, pos);
+  if (auto xs = caf::get_if<view<map>>(&x))
+    return container_append(**xs, pos);
+  return false;
+}
+
+bool membership_index::is_empty_container(data_view x) {
+  auto empty = [](auto& xs) { return !xs || xs->size() == 0; };
+  if (auto xs = caf::get_if<view<vector>>(&x))
+    return empty(*xs);
+  if (auto xs = caf::get_if<view<set>>(&x))
+    return empty(*xs);
+  if (auto xs = caf::get_if<view<map>>(&x))
+    return empty(*xs);
+  return false;
+}
+
+expected<ids>
+membership_index::lookup_impl(relational_operator op, data_view x) const {
+  if (op == equal || op == not_equal) {
+    if (!is_empty_container(x))
+      return make_error(ec::unsupported_operator, op);
+    auto result = size_.lookup(equal, 0);
+    result.append_bits(false, offset() - result.size());
+    if (op == not_equal)
+      result.flip();
+    return result;
+  }
+  if (!(op == ni || op == not_ni))
+    return make_error(ec::unsupported_operator, op);
+  ids result{offset(), false};
+  if (auto i = postings_.find(key(x)); i != postings_.end()) {
+    result = i->second;
+    result.append_bits(false, offset() - result.size());
+  }
+  if (op == not_ni)
+    result.flip();
+  return result;
+}
+
 } // namespace vast
@@ -68,6 +68,13 @@ void wah_bitmap::append_bits(bool bit, size_type n) {
   // Now that we're at a word boundary, append fill words.
   auto fills = n / word_type::literal_word_size;
   auto partial = n % word_type::literal_word_size;
+  // Like the other modifiers, we keep a complete last word active instead of
+  // merging it right away. Otherwise the encoding of the same bits would
+  // depend on the sequence of appends.
+  if (partial == 0) {
+    --fills;
+    partial = word_type::literal_word_size;
+  }
   // Can we append to a previous fill of the same kind?
   auto& prev = blocks_.back();
   if (word_type::is_fill(prev, bit)) {
@@ -208,4 +215,37 @@ wah_bitmap_range bit_range(const wah_bitmap& bm) {
   return wah_bitmap_range{bm};
 }
 
+wah_bitmap_cursor::wah_bitmap_cursor(const wah_bitmap& bm)
+  : next_{bm.blocks().data()},
+    end_{bm.blocks().data() + bm.blocks().size()} {
+  scan();
+}
+
+void wah_bitmap_cursor::skip(size_type n) {
+  if (clean_ > 0) {
+    VAST_ASSERT(n <= clean_);
+    clean_ -= n;
+  } else {
+    VAST_ASSERT(n <= dirty_);
+    literals_ += n;
+    dirty_ -= n;
+  }
+  scan();
+}
+
+void wah_bitmap_cursor::scan() {
+  while (clean_ == 0 && dirty_ == 0 && next_ != end_) {
+    if (word_type::is_fill(*next_)) {
+      clean_ = word_type::fill_words(*next_);
+      fill_ = word_type::fill_type(*next_);
+      ++next_;
+    } else {
+      literals_ = next_;
+      while (next_ != end_ && !word_type::is_fill(*next_))
+        ++next_;
+      dirty_ = next_ - literals_;
+    }
+  }
+}
+
 } // namespace vast
@@ -14,12 +14,16 @@
 #include "vast/bitmap.hpp"
 #include "vast/ewah_bitmap.hpp"
 #include "vast/ids.hpp"
+#include "vast/load.hpp"
 #include "vast/null_bitmap.hpp"
+#include "vast/roaring_bitmap.hpp"
+#include "vast/save.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/bitmap.hpp"
 
 #define SUITE bitmap
 #include "vast/test/test.hpp"
+#include "vast/test/fixtures/actor_system.hpp"
 
 using namespace vast;
 using namespace std::string_literals;
@@ -174,6 +178,15 @@ struct bitmap_test_harness {
     auto begin = bitmaps.begin();
     auto end = bitmaps.end();
     CHECK_EQUAL(nary_and(begin, end), x & y & z0 & z1);
+    MESSAGE("nary OR");
+    CHECK_EQUAL(nary_or(begin, end), x | y | z0 | z1);
+    auto op = [](const auto& lhs, const auto& rhs) { return lhs | rhs; };
+    CHECK_EQUAL(nary_or(begin, end), nary_eval(begin, end, op));
+    MESSAGE("nary evaluation with a single bitmap");
+    CHECK_EQUAL(nary_or(begin, begin + 1), x);
+    CHECK_EQUAL(nary_and(begin, begin + 1), x);
+    MESSAGE("nary evaluation without bitmaps");
+    CHECK(nary_or(end, end).empty());
   }
 
   void test_rank() {
@@ -476,6 +489,14 @@ TEST(wah_bitmap) {
 
 FIXTURE_SCOPE_END()
 
+FIXTURE_SCOPE(roaring_bitmap_tests, bitmap_test_harness<roaring_bitmap>)
+
+TEST(roaring_bitmap) {
+  execute();
+}
+
+FIXTURE_SCOPE_END()
+
 FIXTURE_SCOPE(bitmap_tests, bitmap_test_harness<bitmap>)
 
 TEST(bitmap) {
@@ -486,6 +507,163 @@ FIXTURE_SCOPE_END()
 
 namespace {
 
+// Appends the same bits spanning several Roaring containers to both bitmaps.
+template <class Bitmap>
+void make_clustered(Bitmap& bm, size_t seed) {
+  bm.append_bits(false, 1000 * seed);
+  for (auto i = 0u; i < 300; ++i)
+    bm.append_block(0x0f0f0f0f0f0f0f0f >> seed);
+  bm.append_bits(true, 70000 + seed);
+  for (auto i = 0u; i < 5000; ++i)
+    bm.append_bit(i % (seed + 2) == 0);
+  bm.append_bits(false, 200000);
+  bm.append_bit(true);
+}
+
+// Compares the block-wise evaluation of a word-aligned encoding with the
+// generic algorithm over bit ranges.
+template <bool FillLHS, bool FillRHS, class Bitmap, class Operation>
+void check_word_eval(const Bitmap& x, const Bitmap& y, Operation op) {
+  auto expected = binary_eval<FillLHS, FillRHS, Bitmap, Bitmap>(x, y, op);
+  CHECK_EQUAL((binary_eval<FillLHS, FillRHS>(x, y, op)), expected);
+  expected = binary_eval<FillLHS, FillRHS, Bitmap, Bitmap>(y, x, op);
+  CHECK_EQUAL((binary_eval<FillLHS, FillRHS>(y, x, op)), expected);
+}
+
+template <class Bitmap>
+void check_word_eval() {
+  Bitmap x;
+  Bitmap y;
+  make_clustered(x, 1);
+  make_clustered(y, 3);
+  y.append_bits(true, 1000);
+  for (auto i = 0u; i < 500; ++i) {
+    x.append_block(0xf0f0f0f0f0f0f0f0 << (i % 5));
+    y.append_block(0x123456789abcdef0 >> (i % 7));
+  }
+  y.append_bits(false, 42);
+  y.append_block(0xff00, 17);
+  for (auto& z : {x, ~x, Bitmap{}, Bitmap{100, true}}) {
+    check_word_eval<false, false>(z, y, [](auto l, auto r) { return l & r; });
+    check_word_eval<true, true>(z, y, [](auto l, auto r) { return l | r; });
+    check_word_eval<true, true>(z, y, [](auto l, auto r) { return l ^ r; });
+    check_word_eval<true, false>(z, y, [](auto l, auto r) { return l & ~r; });
+    check_word_eval<true, true>(z, y, [](auto l, auto r) { return l | ~r; });
+  }
+}
+
+} // namespace <anonymous>
+
+TEST(EWAH and WAH block-wise evaluation) {
+  check_word_eval<ewah_bitmap>();
+  check_word_eval<wah_bitmap>();
+}
+
+FIXTURE_SCOPE(roaring_tests, fixtures::deterministic_actor_system)
+
+TEST(Roaring containers) {
+  using word_type = roaring_bitmap::word_type;
+  roaring_bitmap bm;
+  bm.append_bits(false, 100);
+  bm.append_bit(true);
+  REQUIRE_EQUAL(bm.containers().size(), 1u);
+  CHECK_EQUAL(bm.containers()[0].array.size(), 1u);
+  MESSAGE("array becomes bitset beyond 4096 elements");
+  bm.append_bits(true, 4096);
+  CHECK_EQUAL(bm.containers()[0].cardinality, 4097u);
+  CHECK(bm.containers()[0].array.empty());
+  CHECK_EQUAL(bm.containers()[0].bitset.size(), 1024u);
+  MESSAGE("full chunks have neither array nor bitset");
+  bm.append_bits(false, roaring_bitmap::container_bits - bm.size());
+  bm.append_bits(true, roaring_bitmap::container_bits);
+  bm.append_bits(false, 10 * roaring_bitmap::container_bits);
+  bm.append_bit(true);
+  REQUIRE_EQUAL(bm.containers().size(), 3u);
+  auto& full = bm.containers()[1];
+  CHECK_EQUAL(full.key, 1u);
+  CHECK(full.full());
+  CHECK(full.array.empty());
+  CHECK(full.bitset.empty());
+  CHECK_EQUAL(bm.containers()[2].key, 12u);
+  MESSAGE("searching");
+  CHECK_EQUAL(rank(bm), 4097u + roaring_bitmap::container_bits + 1);
+  CHECK_EQUAL(select(bm, 1), 100u);
+  CHECK_EQUAL(select(bm, 4098), roaring_bitmap::container_bits);
+  CHECK_EQUAL(select(bm, -1), bm.size() - 1);
+  CHECK_EQUAL(bm.find_first(4197), roaring_bitmap::container_bits);
+  CHECK_EQUAL(bm.find_first(bm.size()), word_type::npos);
+}
+
+TEST(Roaring bitwise operations) {
+  roaring_bitmap x;
+  roaring_bitmap y;
+  ewah_bitmap ex;
+  ewah_bitmap ey;
+  make_clustered(x, 1);
+  make_clustered(y, 3);
+  make_clustered(ex, 1);
+  make_clustered(ey, 3);
+  CHECK_EQUAL(to_string(x), to_string(ex));
+  CHECK_EQUAL(to_string(~x), to_string(~ex));
+  CHECK_EQUAL(to_string(x & y), to_string(ex & ey));
+  CHECK_EQUAL(to_string(x | y), to_string(ex | ey));
+  CHECK_EQUAL(to_string(x ^ y), to_string(ex ^ ey));
+  CHECK_EQUAL(to_string(x - y), to_string(ex - ey));
+  CHECK_EQUAL(to_string(y - x), to_string(ey - ex));
+  CHECK_EQUAL(to_string(x / y), to_string(ex / ey));
+  CHECK_EQUAL(rank(x & y), rank(ex & ey));
+  CHECK_EQUAL(select(x | y, 5000), select(ex | ey, 5000));
+  MESSAGE("results are canonical");
+  auto z = x | y;
+  roaring_bitmap copy;
+  copy.append(z);
+  CHECK_EQUAL(z, copy);
+}
+
+TEST(Roaring serialization) {
+  roaring_bitmap x;
+  make_clustered(x, 2);
+  roaring_bitmap y;
+  std::vector<char> buf;
+  CHECK_EQUAL(save(sys, buf, x), caf::none);
+  CHECK_EQUAL(load(sys, buf, y), caf::none);
+  CHECK_EQUAL(x, y);
+  MESSAGE("type-erased");
+  bitmap bx{x};
+  bitmap by;
+  buf.clear();
+  CHECK_EQUAL(save(sys, buf, bx), caf::none);
+  CHECK_EQUAL(load(sys, buf, by), caf::none);
+  CHECK(caf::holds_alternative<roaring_bitmap>(by));
+  CHECK_EQUAL(bx, by);
+}
+
+TEST(bitmap type selection) {
+  CHECK(!bitmap::valid_type(caf::atom("foo")));
+  REQUIRE(bitmap::valid_type(caf::atom("roaring")));
+  bitmap x{caf::atom("roaring")};
+  bitmap y{caf::atom("roaring")};
+  make_clustered(x, 1);
+  make_clustered(y, 3);
+  CHECK(caf::holds_alternative<roaring_bitmap>(x));
+  MESSAGE("operations on equal concrete types retain the type");
+  auto z = x & y;
+  CHECK(caf::holds_alternative<roaring_bitmap>(z));
+  MESSAGE("bitmaps with different types compare by value");
+  ewah_bitmap ex;
+  ewah_bitmap ey;
+  make_clustered(ex, 1);
+  make_clustered(ey, 3);
+  CHECK_EQUAL(bitmap{ex}, x);
+  CHECK_EQUAL(bitmap{ex & ey}, z);
+  CHECK_EQUAL(bitmap{ex} & y, z);
+  CHECK(caf::holds_alternative<ewah_bitmap>(bitmap{}));
+}
+
+FIXTURE_SCOPE_END()
+
+namespace {
+
 ewah_bitmap make_ewah1() {
   ewah_bitmap bm;
   bm.append_bits(true, 10);
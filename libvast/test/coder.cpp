@@ -521,6 +521,40 @@ TEST(serialization multi-level coder) {
   CHECK_DECODE(not_equal, 13, "11111");
 }
 
+TEST(serialization decodes bitmaps on demand) {
+  equality_coder<null_bitmap> x{10};
+  fill(x, 8, 9, 0, 1, 4);
+  std::string buf;
+  CHECK_EQUAL(save(sys, buf, x), caf::none);
+  equality_coder<null_bitmap> c;
+  CHECK_EQUAL(load(sys, buf, c), caf::none);
+  CHECK_EQUAL(c.serialized_count(), 10u);
+  CHECK_DECODE(equal, 8, "10000");
+  CHECK_EQUAL(c.serialized_count(), 9u);
+  CHECK_DECODE(less, 2, "00110");
+  CHECK_EQUAL(c.serialized_count(), 7u);
+  MESSAGE("appending decodes only the bitmaps it touches");
+  fill(x, 9);
+  fill(c, 9);
+  CHECK_EQUAL(c.serialized_count(), 6u);
+  CHECK_DECODE(equal, 9, "010001");
+  MESSAGE("saving keeps the serialized bitmaps as is");
+  buf.clear();
+  CHECK_EQUAL(save(sys, buf, c), caf::none);
+  equality_coder<null_bitmap> y;
+  CHECK_EQUAL(load(sys, buf, y), caf::none);
+  CHECK_EQUAL(y.serialized_count(), 10u);
+  CHECK_EQUAL(y, x);
+  CHECK_EQUAL(y.serialized_count(), 0u);
+  MESSAGE("coders of earlier versions get decoded right away");
+  buf.clear();
+  CHECK_EQUAL(save(sys, buf, x.size(), x.storage()), caf::none);
+  equality_coder<null_bitmap> z;
+  CHECK_EQUAL(load(sys, buf, z), caf::none);
+  CHECK_EQUAL(z.serialized_count(), 0u);
+  CHECK_EQUAL(z, x);
+}
+
 TEST(printable) {
   equality_coder<null_bitmap> c{5};
   fill(c, 1, 2, 1, 0, 4);
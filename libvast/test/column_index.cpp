@@ -20,12 +20,15 @@
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
 #include "vast/default_table_slice.hpp"
+#include "vast/save.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/table_slice_builder.hpp"
 #include "vast/type.hpp"
+#include "vast/value_index.hpp"
 
 #include <caf/test/dsl.hpp>
 
+using namespace std::chrono_literals;
 using namespace vast;
 
 namespace {
@@ -102,4 +105,66 @@ TEST(bro conn log) {
   CHECK_EQUAL(unbox(col->lookup(pred)), expected_result);
 }
 
+TEST(incremental flushes) {
+  auto row_type = bro_conn_log_layout();
+  auto col_offset = unbox(row_type.resolve("id.orig_h"));
+  auto col_type = row_type.at(col_offset);
+  auto col_index = unbox(row_type.flat_index_at(col_offset));
+  auto pred = unbox(to<predicate>(":addr == 192.168.1.103"));
+  auto expected_result = make_ids({1, 3, 7, 14, 16}, bro_conn_log.size());
+  MESSAGE("flush after each slice");
+  auto col = unbox(make_column_index(sys, directory, *col_type, col_index));
+  for (auto slice : bro_conn_log_slices) {
+    col->add(slice);
+    REQUIRE(!col->flush_to_disk());
+  }
+  MESSAGE("reload snapshot and log");
+  col = unbox(make_column_index(sys, directory, *col_type, col_index));
+  CHECK_EQUAL(unbox(col->lookup(pred)), expected_result);
+  MESSAGE("continue appending after reloading");
+  auto slice = bro_conn_log_slices[0];
+  slice.unshared().offset(bro_conn_log.size());
+  col->add(slice);
+  REQUIRE(!col->flush_to_disk());
+  col = unbox(make_column_index(sys, directory, *col_type, col_index));
+  expected_result = make_ids({1, 3, 7, 14, 16, bro_conn_log.size() + 1,
+                              bro_conn_log.size() + 3, bro_conn_log.size() + 7},
+                             bro_conn_log.size() + slice->rows());
+  CHECK_EQUAL(unbox(col->lookup(pred)), expected_result);
+}
+
+TEST(legacy snapshots) {
+  MESSAGE("write a timestamp index in the format of version 0");
+  type column_type = timestamp_type{};
+  record_type layout{{"value", column_type}};
+  auto epoch = timestamp{};
+  auto idx = value_index::make(column_type, 0);
+  REQUIRE(idx);
+  for (auto i = 0; i < 3; ++i)
+    REQUIRE(idx->append(make_data_view(epoch + i * 1s)));
+  detail::value_index_inspect_helper helper{column_type, idx, 0};
+  REQUIRE(!save(sys, directory, idx->offset(), helper));
+  MESSAGE("load the index with the mapping of version 0");
+  auto col = unbox(make_column_index(sys, directory, column_type, 0));
+  using legacy_index = arithmetic_index<timestamp>;
+  CHECK(dynamic_cast<const legacy_index*>(&col->idx()) != nullptr);
+  auto x = make_data_view(epoch + 1s);
+  CHECK_EQUAL(unbox(col->idx().lookup(greater_equal, x)),
+              make_ids({1, 2}, 3));
+  MESSAGE("new snapshots retain the version");
+  auto slice = default_table_slice::make(layout, make_rows(epoch + 5s));
+  slice.unshared().offset(3);
+  col->add(slice);
+  REQUIRE(!col->flush_to_disk());
+  col = unbox(make_column_index(sys, directory, column_type, 0));
+  CHECK(dynamic_cast<const legacy_index*>(&col->idx()) != nullptr);
+  CHECK_EQUAL(unbox(col->idx().lookup(greater_equal, x)),
+              make_ids({1, 2, 3}, 4));
+  MESSAGE("new indexes use the current version");
+  auto filename = directory;
+  filename += "-new";
+  col = unbox(make_column_index(sys, filename, column_type, 0));
+  CHECK(dynamic_cast<const time_index*>(&col->idx()) != nullptr);
+}
+
 FIXTURE_SCOPE_END()
@@ -164,6 +164,11 @@ TEST(evaluation) {
   CHECK(evaluate(rhs, not_in, lhs));
   CHECK(evaluate(rhs, ni, lhs));
   CHECK(evaluate(rhs, not_in, lhs));
+  MESSAGE("map keys");
+  rhs = map{{"foo", 42}, {"bar", 43}};
+  CHECK(evaluate(lhs, in, rhs));
+  CHECK(evaluate(rhs, ni, lhs));
+  CHECK(!evaluate(data{42}, in, rhs));
   MESSAGE("equality");
   lhs = count{42};
   rhs = count{1337};
@@ -11,10 +11,16 @@
  * contained in the LICENSE file.                                             *
  ******************************************************************************/
 
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/columnar_table_slice.hpp"
+#include "vast/default_table_slice.hpp"
+#include "vast/evaluate.hpp"
 #include "vast/event.hpp"
 #include "vast/expression.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/schema.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/table_slice_builder.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
 
@@ -153,4 +159,97 @@ TEST(evaluation - schema) {
   CHECK(caf::holds_alternative<caf::none_t>(*ast_resolved));
 }
 
+TEST(evaluation - table slice rows) {
+  auto layout = caf::get<record_type>(foo);
+  layout.fields.insert(layout.fields.begin(),
+                       record_field{"timestamp", timestamp_type{}});
+  auto builder = default_table_slice::make_builder(layout);
+  auto tp = to<timestamp>("2014-01-16+05:30:12");
+  REQUIRE(tp);
+  for (auto x : {data{*tp}, data{"babba"}, data{1.337}, data{42u}, data{100},
+                 data{"bar"}, data{-4.8}})
+    REQUIRE(builder->add(make_view(x)));
+  for (auto x : {data{*tp}, data{"yadda"}, data{0.1}, data{7u}, data{-1},
+                 data{"baz"}, data{4.2}})
+    REQUIRE(builder->add(make_view(x)));
+  auto slice = builder->finish();
+  REQUIRE(slice);
+  REQUIRE_EQUAL(slice->rows(), 2u);
+  auto eval = [&](std::string_view str, size_t row) {
+    auto ast = to<expression>(str);
+    REQUIRE(ast);
+    auto ast_resolved = caf::visit(type_resolver{foo}, *ast);
+    REQUIRE(ast_resolved);
+    return caf::visit(table_slice_row_evaluator{*slice, row, foo},
+                      *ast_resolved);
+  };
+  CHECK(eval("s1 == \"babba\" && d1 <= 1337.0", 0));
+  CHECK(!eval("s1 == \"babba\" && d1 <= 1337.0", 1));
+  CHECK(eval("c > 10 || s2 == \"baz\"", 0));
+  CHECK(eval("c > 10 || s2 == \"baz\"", 1));
+  CHECK(!eval("! i < +0", 1));
+  CHECK(eval("&type == \"foo\"", 0));
+  CHECK(eval("&time == 2014-01-16+05:30:12", 1));
+  CHECK(!eval("&time == 2015-01-16+05:30:12", 1));
+}
+
+TEST(evaluation - table slices) {
+  auto layout = caf::get<record_type>(foo);
+  layout.fields.insert(layout.fields.begin(),
+                       record_field{"timestamp", timestamp_type{}});
+  auto tp = to<timestamp>("2014-01-16+05:30:12");
+  REQUIRE(tp);
+  // Use more than 64 rows to cover partial blocks.
+  auto make_slice = [&](table_slice_builder_ptr builder) {
+    for (int i = 0; i < 130; ++i) {
+      auto s2 = i % 7 == 0 ? data{} : data{"bar"};
+      for (auto x : {data{*tp + std::chrono::seconds(i)},
+                     data{i % 3 == 0 ? "babba" : "yadda"}, data{i * 0.5},
+                     data{count(i)}, data{integer(i) - 50}, s2, data{-i * 1.0}})
+        REQUIRE(builder->add(make_view(x)));
+    }
+    auto result = builder->finish();
+    REQUIRE(result);
+    result.unshared().offset(1000);
+    return result;
+  };
+  auto slices = {make_slice(default_table_slice::make_builder(layout)),
+                 make_slice(columnar_table_slice::make_builder(layout))};
+  auto queries = {
+    "c > 100",
+    "i < +0 && s1 == \"babba\"",
+    "! d1 >= 10.0 || s2 == \"bar\"",
+    "s2 != \"bar\"",
+    "s1 ~ /b.*/ && d2 > -20.0",
+    "&time > 2014-01-16+05:31:00",
+    "&type == \"foo\"",
+    "c !in [2, 4, 8]",
+    "c in [1, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59]",
+    "s1 in [\"a\", \"b\", \"c\", \"d\", \"e\", \"f\", \"g\", \"h\", "
+    "\"i\", \"j\", \"k\", \"l\", \"m\", \"n\", \"o\", \"yadda\"]",
+    "s2 !in [\"a\", \"b\", \"c\", \"d\", \"e\", \"f\", \"g\", \"h\", "
+    "\"i\", \"j\", \"k\", \"l\", \"m\", \"n\", \"o\", \"bar\"]",
+  };
+  for (auto& slice : slices) {
+    MESSAGE("evaluate " << to_string(slice->implementation_id()));
+    for (auto query : queries) {
+      auto ast = to<expression>(query);
+      REQUIRE(ast);
+      auto expr = caf::visit(type_resolver{foo}, *ast);
+      REQUIRE(expr);
+      ids expected;
+      for (size_t row = 0; row < slice->rows(); ++row) {
+        if (caf::visit(table_slice_row_evaluator{*slice, row, foo}, *expr)) {
+          expected.append_bits(false, slice->offset() + row - expected.size());
+          expected.append_bit(true);
+        }
+      }
+      auto result = evaluate(*expr, *slice);
+      CHECK_EQUAL(result.size(), slice->offset() + slice->rows());
+      CHECK_EQUAL(rank(result), rank(expected));
+      CHECK_EQUAL(rank(result & expected), rank(expected));
+    }
+  }
+}
+
 FIXTURE_SCOPE_END()
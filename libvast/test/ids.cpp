@@ -11,6 +11,7 @@
  * contained in the LICENSE file.                                             *
  ******************************************************************************/
 
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/ids.hpp"
 
 #define SUITE ids
@@ -30,3 +31,14 @@ TEST(make ids) {
   auto zs = make_ids({{15, 20}, 2, {10, 15}, 1});
   CHECK_EQUAL(ys, zs);
 }
+
+TEST(take) {
+  auto xs = make_ids({{10, 12}, {20, 22}});
+  CHECK_EQUAL(rank(take(xs, 0)), 0u);
+  auto ys = take(xs, 3);
+  CHECK_EQUAL(rank(ys), 3u);
+  CHECK_EQUAL(select(ys, 1), 10u);
+  CHECK_EQUAL(select(ys, -1), 20u);
+  CHECK_EQUAL(rank(take(xs, 4)), 4u);
+  CHECK_EQUAL(take(xs, 42), xs);
+}
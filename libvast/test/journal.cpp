@@ -0,0 +1,127 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#define SUITE journal
+
+#include "vast/test/test.hpp"
+#include "vast/test/fixtures/actor_system.hpp"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "vast/journal.hpp"
+
+using namespace vast;
+
+namespace {
+
+struct fixture : fixtures::deterministic_actor_system {
+  fixture() {
+    filename = directory / "journal" / "state";
+  }
+
+  // Collects all committed records of a journal.
+  std::vector<std::string> replay(journal& j) {
+    std::vector<std::string> result;
+    auto f = [&](uint64_t& x, std::string& str) -> caf::error {
+      result.push_back(std::to_string(x) + str);
+      return caf::none;
+    };
+    REQUIRE(!j.replay<uint64_t, std::string>(f));
+    return result;
+  }
+
+  path filename;
+};
+
+} // namespace <anonymous>
+
+FIXTURE_SCOPE(journal_tests, fixture)
+
+TEST(snapshot and log) {
+  MESSAGE("write a snapshot and a log");
+  {
+    journal j{sys, filename};
+    REQUIRE(!j.init());
+    CHECK(!j.has_snapshot());
+    REQUIRE(!j.snapshot(std::string(100, 'x')));
+    CHECK(j.has_snapshot());
+    REQUIRE(!j.append(uint64_t{1}, std::string{"foo"}));
+    REQUIRE(!j.append(uint64_t{2}, std::string{"bar"}));
+    REQUIRE(!j.commit());
+    REQUIRE(!j.append(uint64_t{3}, std::string{"baz"}));
+  }
+  MESSAGE("read snapshot and committed records");
+  journal j{sys, filename};
+  REQUIRE(!j.init());
+  REQUIRE(j.has_snapshot());
+  std::string snapshot;
+  REQUIRE(!j.load_snapshot(snapshot));
+  CHECK_EQUAL(snapshot, std::string(100, 'x'));
+  CHECK_EQUAL(replay(j), (std::vector<std::string>{"1foo", "2bar"}));
+  CHECK(!j.needs_compaction());
+  MESSAGE("overwrite uncommitted records");
+  REQUIRE(!j.append(uint64_t{4}, std::string{"qux"}));
+  REQUIRE(!j.commit());
+  CHECK_EQUAL(replay(j), (std::vector<std::string>{"1foo", "2bar", "4qux"}));
+  MESSAGE("compact the log");
+  while (!j.needs_compaction())
+    REQUIRE(!j.append(uint64_t{5}, std::string(10, 'y')));
+  REQUIRE(!j.snapshot(std::string{"compacted"}));
+  CHECK_EQUAL(j.log_size(), 0u);
+  CHECK(replay(j).empty());
+  journal k{sys, filename};
+  REQUIRE(!k.init());
+  REQUIRE(!k.load_snapshot(snapshot));
+  CHECK_EQUAL(snapshot, "compacted");
+  CHECK(replay(k).empty());
+}
+
+TEST(garbage after the last record) {
+  {
+    journal j{sys, filename};
+    REQUIRE(!j.init());
+    REQUIRE(!j.snapshot(std::string{"snapshot"}));
+    REQUIRE(!j.append(uint64_t{1}, std::string{"foo"}));
+    REQUIRE(!j.commit());
+  }
+  MESSAGE("simulate a crash in the middle of an append");
+  {
+    auto log = filename;
+    log += ".log";
+    std::ofstream out{log.str(), std::ios::binary | std::ios::app};
+    out << "garbage";
+  }
+  journal j{sys, filename};
+  REQUIRE(!j.init());
+  CHECK_EQUAL(replay(j), (std::vector<std::string>{"1foo"}));
+  REQUIRE(!j.append(uint64_t{2}, std::string{"bar"}));
+  REQUIRE(!j.commit());
+  CHECK_EQUAL(replay(j), (std::vector<std::string>{"1foo", "2bar"}));
+}
+
+TEST(snapshot without manifest) {
+  REQUIRE(!save(sys, filename, std::string{"legacy"}));
+  journal j{sys, filename};
+  REQUIRE(!j.init());
+  REQUIRE(j.has_snapshot());
+  CHECK(j.snapshot_size() > 0u);
+  std::string snapshot;
+  REQUIRE(!j.load_snapshot(snapshot));
+  CHECK_EQUAL(snapshot, "legacy");
+  CHECK(replay(j).empty());
+}
+
+FIXTURE_SCOPE_END()
@@ -185,6 +185,42 @@ TEST_DISABLED(uuid lookup) {
   CHECK_EQUAL(query("00:00:10", "00:00:30"), slice(0, 2));
 }
 
+TEST(time range lookup) {
+  for (size_t i = 0; i < num_partitions; ++i)
+    ids.emplace_back(uuid::random());
+  std::vector<mock_partition> mock_partitions;
+  for (size_t i = 0; i < num_partitions; ++i)
+    mock_partitions.emplace_back(ids[i], i);
+  auto lookup = [&](std::string_view op, std::string_view hhmmss) {
+    std::string q = "timestamp ";
+    q += op;
+    q += " 1970-01-01+";
+    q += hhmmss;
+    q += ".0";
+    return meta_idx.lookup(unbox(to<expression>(q)));
+  };
+  MESSAGE("index all but the last partition");
+  for (size_t i = 0; i + 1 < num_partitions; ++i)
+    meta_idx.add(ids[i], *mock_partitions[i].slice);
+  CHECK_EQUAL(lookup("==", "00:00:30"), slice(1));
+  CHECK_EQUAL(lookup("<", "00:00:25"), slice(0));
+  CHECK_EQUAL(lookup("<=", "00:00:25"), slice(0, 2));
+  CHECK_EQUAL(lookup(">", "00:00:49"), slice(2));
+  CHECK_EQUAL(lookup(">=", "00:00:49"), slice(1, 3));
+  CHECK_EQUAL(lookup("==", "00:01:20"), empty());
+  MESSAGE("add the last partition after the first lookup");
+  auto& last = mock_partitions.back();
+  meta_idx.add(last.id, *last.slice);
+  CHECK_EQUAL(lookup("==", "00:01:20"), slice(3));
+  CHECK_EQUAL(lookup(">", "00:00:49"), slice(2, 4));
+  MESSAGE("extend the time range of the first partition");
+  meta_idx.add(ids[0], *mock_partitions[3].slice);
+  auto expected = std::vector<uuid>{ids[0], ids[3]};
+  std::sort(expected.begin(), expected.end());
+  CHECK_EQUAL(lookup("==", "00:01:20"), expected);
+  CHECK_EQUAL(lookup("<", "00:00:25"), slice(0));
+}
+
 FIXTURE_SCOPE_END()
 
 FIXTURE_SCOPE(metaidx_serialization_tests, fixtures::deterministic_actor_system)
@@ -15,10 +15,13 @@
 #include "vast/concept/parseable/vast/pattern.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/pattern.hpp"
+#include "vast/load.hpp"
 #include "vast/pattern.hpp"
+#include "vast/save.hpp"
 
 #define SUITE pattern
 #include "vast/test/test.hpp"
+#include "vast/test/fixtures/actor_system.hpp"
 
 using namespace vast;
 using namespace std::string_literals;
@@ -43,6 +46,58 @@ TEST(functionality) {
   CHECK(p.search(str));
 }
 
+TEST(glob fast path) {
+  auto prefix = pattern::glob("foo*");
+  CHECK(prefix.match("foo"));
+  CHECK(prefix.match("foobar"));
+  CHECK(!prefix.match("barfoo"));
+  CHECK(prefix.search("barfoo"));
+  auto suffix = pattern::glob("*.com");
+  CHECK(suffix.match("vast.com"));
+  CHECK(!suffix.match("vastcom"));
+  CHECK(!suffix.match("vast.com.org"));
+  CHECK(suffix.search("vast.com.org"));
+  auto infix = pattern::glob("*foo*");
+  CHECK(infix.match("foo"));
+  CHECK(infix.match("barfoobaz"));
+  CHECK(!infix.match("fobar"));
+  auto literal = pattern::glob("a.b");
+  CHECK(literal.match("a.b"));
+  CHECK(!literal.match("axb"));
+  CHECK(literal.search("xa.bx"));
+  MESSAGE("escapes that do not denote literals");
+  CHECK(pattern{"a\\.*"}.match("a..."));
+  CHECK(!pattern{"a\\.*"}.match("ab"));
+  CHECK(pattern{"\\w+.*"}.match("foo bar"));
+  CHECK(!pattern{"\\w+.*"}.match(" foo"));
+  MESSAGE("wildcards do not match line terminators");
+  CHECK(!prefix.match("foo\nbar"));
+  CHECK(prefix.search("foo\nbar"));
+  CHECK(!suffix.match("vast\r.com"));
+  CHECK(!infix.match("a\nfoo"));
+  CHECK(!infix.match("foo\n"));
+  CHECK(pattern{".*a\nb.*"}.match("xa\nby"));
+  CHECK(!pattern{".*a\nb.*"}.match("xa\nbya\nb"));
+  MESSAGE("empty pattern");
+  CHECK(pattern{}.match(""));
+  CHECK(!pattern{}.match("foo"));
+  CHECK(pattern{}.search("foo"));
+}
+
+TEST(moved from) {
+  auto p = pattern{"foo"};
+  auto q = std::move(p);
+  CHECK(q.match("foo"));
+  CHECK(!p.match("foo"));
+  CHECK(!p.search("foo"));
+}
+
+TEST(invalid) {
+  auto p = pattern{"(foo"};
+  CHECK(!p.match("(foo"));
+  CHECK(!p.search("(foo"));
+}
+
 TEST(composition) {
   auto foo = pattern{"foo"};
   auto bar = pattern{"bar"};
@@ -51,6 +106,11 @@ TEST(composition) {
   CHECK(!foobar.match("foo"));
   CHECK(!foobar.match("bar"));
   auto foo_or_bar = foo | bar;
+  auto copy = foo;
+  copy |= bar;
+  CHECK(copy == foo_or_bar);
+  CHECK(copy.match("bar"));
+  CHECK(!foo.match("bar"));
   CHECK(!foo_or_bar.match("foobar"));
   CHECK(foo_or_bar.search("foobar"));
   CHECK(foo_or_bar.match("foo"));
@@ -85,3 +145,18 @@ TEST(parseable) {
   CHECK(f == l);
   CHECK(to_string(pat) == str);
 }
+
+FIXTURE_SCOPE(pattern_tests, fixtures::deterministic_actor_system)
+
+TEST(serialization) {
+  auto x = pattern::glob("foo*");
+  std::vector<char> buf;
+  CHECK_EQUAL(save(sys, buf, x), caf::none);
+  pattern y;
+  CHECK_EQUAL(load(sys, buf, y), caf::none);
+  CHECK(x == y);
+  CHECK(y.match("foobar"));
+  CHECK(!y.match("barfoo"));
+}
+
+FIXTURE_SCOPE_END()
@@ -48,6 +48,30 @@ TEST(construction and querying) {
   CHECK_EQUAL(*slices[1], *bro_conn_log_slices[2]);
 }
 
+TEST(compression) {
+  std::vector<compression> methods = {compression::null, compression::lz4};
+#ifdef VAST_HAVE_SNAPPY
+  methods.push_back(compression::snappy);
+#endif
+  for (auto method : methods) {
+    segment_builder builder{sys, method};
+    for (auto& slice : bro_conn_log_slices)
+      REQUIRE(!builder.add(slice));
+    auto segment = builder.finish();
+    REQUIRE(segment);
+    auto x = *segment;
+    MESSAGE("roundtrip the segment through its chunk");
+    auto y = segment::make(sys, x->chunk());
+    REQUIRE(y);
+    auto xs = (*y)->lookup(make_ids({0, 6, 19, 21}));
+    REQUIRE(xs);
+    auto& slices = *xs;
+    REQUIRE_EQUAL(slices.size(), 2u);
+    CHECK_EQUAL(*slices[0], *bro_conn_log_slices[0]);
+    CHECK_EQUAL(*slices[1], *bro_conn_log_slices[2]);
+  }
+}
+
 TEST(serialization) {
   segment_builder builder{sys};
   auto slice = bro_conn_log_slices[0];
@@ -40,4 +40,21 @@ TEST(construction and querying) {
   REQUIRE_EQUAL(slices->size(), 2u);
 }
 
+TEST(querying persisted segments) {
+  rm("foo");
+  auto store = segment_store::make(sys, path{"foo"}, 512_KiB, 2);
+  REQUIRE(store);
+  for (auto& slice : bro_conn_log_slices)
+    REQUIRE(!store->put(slice));
+  REQUIRE(!store->flush());
+  MESSAGE("memory-map segments with a fresh store");
+  store = segment_store::make(sys, path{"foo"}, 512_KiB, 2);
+  REQUIRE(store);
+  auto slices = store->get(make_ids({0, 6, 19, 21}));
+  REQUIRE(slices);
+  REQUIRE_EQUAL(slices->size(), 2u);
+  CHECK_EQUAL(*slices->at(0), *bro_conn_log_slices[0]);
+  CHECK_EQUAL(*slices->at(1), *bro_conn_log_slices[2]);
+}
+
 FIXTURE_SCOPE_END()
@@ -23,6 +23,16 @@
 #include <caf/binary_deserializer.hpp>
 #include <caf/binary_serializer.hpp>
 
+#include "vast/bloom_filter_synopsis.hpp"
+#include "vast/columnar_table_slice.hpp"
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/address.hpp"
+#include "vast/concept/parseable/vast/subnet.hpp"
+#include "vast/data.hpp"
+#include "vast/default_table_slice.hpp"
+#include "vast/min_max_synopsis.hpp"
+#include "vast/table_slice_builder.hpp"
+
 using namespace std::chrono_literals;
 using namespace vast;
 
@@ -50,7 +60,7 @@ TEST(min-max synopsis) {
   MESSAGE("[4,7] op 4");
   timestamp four = epoch + 4s;
   CHECK(x->lookup(equal, four));
-  CHECK(!x->lookup(not_equal, four));
+  CHECK(x->lookup(not_equal, four));
   CHECK(!x->lookup(less, four));
   CHECK(x->lookup(less_equal, four));
   CHECK(x->lookup(greater, four));
@@ -58,7 +68,7 @@ TEST(min-max synopsis) {
   MESSAGE("[4,7] op 6");
   timestamp six = epoch + 6s;
   CHECK(x->lookup(equal, six));
-  CHECK(!x->lookup(not_equal, six));
+  CHECK(x->lookup(not_equal, six));
   CHECK(x->lookup(less, six));
   CHECK(x->lookup(less_equal, six));
   CHECK(x->lookup(greater, six));
@@ -66,7 +76,7 @@ TEST(min-max synopsis) {
   MESSAGE("[4,7] op 7");
   timestamp seven = epoch + 7s;
   CHECK(x->lookup(equal, seven));
-  CHECK(!x->lookup(not_equal, seven));
+  CHECK(x->lookup(not_equal, seven));
   CHECK(x->lookup(less, seven));
   CHECK(x->lookup(less_equal, seven));
   CHECK(!x->lookup(greater, seven));
@@ -81,11 +91,144 @@ TEST(min-max synopsis) {
   CHECK(!x->lookup(greater_equal, nine));
 }
 
+TEST(min-max synopsis with a single value) {
+  auto x = make_synopsis(count_type{});
+  REQUIRE(x);
+  x->add(count{42});
+  x->add(caf::none);
+  CHECK(x->lookup(equal, count{42}));
+  CHECK(!x->lookup(not_equal, count{42}));
+  CHECK(!x->lookup(equal, count{43}));
+  CHECK(x->lookup(not_equal, count{43}));
+  MESSAGE("values of other types cannot be ruled out");
+  CHECK(x->lookup(equal, integer{43}));
+}
+
+TEST(min-max synopsis for ports) {
+  auto x = make_synopsis(port_type{});
+  REQUIRE(x);
+  x->add(port{53, port::udp});
+  x->add(port{80, port::tcp});
+  CHECK(x->lookup(equal, port{53}));
+  CHECK(x->lookup(equal, port{80, port::udp}));
+  CHECK(!x->lookup(equal, port{443, port::tcp}));
+  CHECK(!x->lookup(less, port{53, port::tcp}));
+  CHECK(x->lookup(greater_equal, port{80, port::icmp}));
+}
+
+TEST(bloom filter synopsis) {
+  auto x = make_synopsis(string_type{});
+  REQUIRE(x);
+  x->add(std::string_view{"foo"});
+  x->add(std::string_view{"bar"});
+  CHECK(x->lookup(equal, std::string_view{"foo"}));
+  CHECK(x->lookup(equal, std::string_view{"bar"}));
+  CHECK(!x->lookup(equal, std::string_view{"baz"}));
+  MESSAGE("operators other than equality cannot be ruled out");
+  CHECK(x->lookup(not_equal, std::string_view{"foo"}));
+  CHECK(x->lookup(match, std::string_view{"baz"}));
+  MESSAGE("membership tests");
+  auto xs = vector{"baz", "qux"};
+  CHECK(!x->lookup(in, make_view(xs)));
+  xs.emplace_back("foo");
+  CHECK(x->lookup(in, make_view(xs)));
+}
+
+TEST(bloom filter synopsis for addresses and subnets) {
+  auto x = make_synopsis(address_type{});
+  REQUIRE(x);
+  x->add(*to<address>("10.0.0.1"));
+  CHECK(x->lookup(equal, *to<address>("10.0.0.1")));
+  CHECK(!x->lookup(equal, *to<address>("10.0.0.2")));
+  auto y = make_synopsis(subnet_type{});
+  REQUIRE(y);
+  y->add(*to<subnet>("10.0.0.0/8"));
+  CHECK(y->lookup(equal, *to<subnet>("10.0.0.0/8")));
+  CHECK(!y->lookup(equal, *to<subnet>("10.0.0.0/16")));
+}
+
+TEST(bloom filter synopsis sizing) {
+  auto attr = vast::attribute{"synopsis", "bloomfilter(1000,0.001)"};
+  auto x = make_synopsis(string_type{}.attributes({attr}));
+  REQUIRE(x);
+  auto& bf = dynamic_cast<bloom_filter_synopsis&>(*x);
+  // m = ceil(-1000 * ln(0.001) / ln(2)^2) = 14378, rounded up to 14400.
+  CHECK_EQUAL(bf.num_bits(), 14400u);
+  CHECK_EQUAL(bf.num_hashes(), 10u);
+  MESSAGE("invalid attributes fall back to the defaults");
+  attr.value = "bloomfilter(0,2)";
+  auto y = make_synopsis(string_type{}.attributes({attr}));
+  REQUIRE(y);
+  auto& bf_default = dynamic_cast<bloom_filter_synopsis&>(*y);
+  CHECK_EQUAL(bf_default.num_hashes(), 7u);
+  // m = ceil(-4096 * ln(0.01) / ln(2)^2) = 39261, rounded up to 39296.
+  CHECK_EQUAL(bf_default.num_bits(), 39296u);
+  MESSAGE("the global capacity applies to types without attribute");
+  CHECK(!bloom_filter_synopsis::global_capacity(0));
+  REQUIRE(bloom_filter_synopsis::global_capacity(1000));
+  auto z = make_synopsis(string_type{});
+  REQUIRE(z);
+  // m = ceil(-1000 * ln(0.01) / ln(2)^2) = 9586, rounded up to 9600.
+  CHECK_EQUAL(dynamic_cast<bloom_filter_synopsis&>(*z).num_bits(), 9600u);
+  REQUIRE(bloom_filter_synopsis::global_capacity(
+    bloom_filter_synopsis::default_capacity));
+}
+
+TEST(column-wise ingestion) {
+  auto layout = record_type{
+    {"a", count_type{}},
+    {"b", string_type{}},
+    {"c", address_type{}},
+  };
+  auto columnar = columnar_table_slice::make_builder(layout);
+  auto fallback = default_table_slice::make_builder(layout);
+  for (uint32_t row = 0; row < 150; ++row) {
+    auto str = std::to_string(row);
+    auto addr = address::v4(&row);
+    for (auto& builder : {columnar, fallback}) {
+      // Null rows hold default-constructed values in columnar slices, which
+      // must not leak into the synopses.
+      if (row % 7 == 0) {
+        CHECK(builder->add(caf::none));
+        CHECK(builder->add(caf::none));
+        CHECK(builder->add(caf::none));
+      } else {
+        CHECK(builder->add(make_view(count{row + 10})));
+        CHECK(builder->add(make_view(str)));
+        CHECK(builder->add(make_view(addr)));
+      }
+    }
+  }
+  auto x = columnar->finish();
+  auto y = fallback->finish();
+  REQUIRE(x);
+  REQUIRE(y);
+  for (size_t col = 0; col < layout.fields.size(); ++col) {
+    auto batch = make_synopsis(layout.fields[col].type);
+    auto single = make_synopsis(layout.fields[col].type);
+    REQUIRE(batch);
+    REQUIRE(single);
+    batch->add_column(*x, col);
+    single->add_column(*y, col);
+    CHECK_EQUAL(*batch, *single);
+  }
+  auto counts = make_synopsis(count_type{});
+  counts->add_column(*x, 0);
+  auto& mm = dynamic_cast<min_max_synopsis<count>&>(*counts);
+  CHECK_EQUAL(mm.min(), 11u);
+  CHECK_EQUAL(mm.max(), 159u);
+}
+
 FIXTURE_SCOPE(synopsis_tests, fixtures::deterministic_actor_system)
 
 TEST(serialization) {
   CHECK_ROUNDTRIP(synopsis_ptr{});
   CHECK_ROUNDTRIP_DEREF(make_synopsis(timestamp_type{}));
+  CHECK_ROUNDTRIP_DEREF(make_synopsis(count_type{}));
+  CHECK_ROUNDTRIP_DEREF(make_synopsis(port_type{}));
+  auto addrs = make_synopsis(address_type{});
+  addrs->add(*to<address>("192.168.0.1"));
+  CHECK_ROUNDTRIP_DEREF(addrs);
 }
 
 FIXTURE_SCOPE_END()
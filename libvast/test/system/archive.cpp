@@ -32,7 +32,8 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
   system::archive_type a;
 
   fixture() {
-    a = self->spawn(system::archive, directory, 10, 1024 * 1024);
+    a = self->spawn(system::archive, directory, 10, 1024 * 1024,
+                    compression::lz4);
   }
 
   template <class T>
@@ -57,6 +58,26 @@ TEST(bro conn logs slices) {
   CHECK_EQUAL(result.size(), 5u);
 }
 
+TEST(concurrent queries) {
+  push_to_archive(bro_conn_log_slices);
+  MESSAGE("restart the archive to load segments from disk");
+  self->send_exit(a, exit_reason::user_shutdown);
+  run();
+  a = self->spawn(system::archive, directory, 10, 1024 * 1024,
+                  compression::lz4);
+  auto rx = self->request(a, infinite, make_ids({{10, 15}}));
+  auto ry = self->request(a, infinite, make_ids({{12, 20}}));
+  run();
+  rx.receive(
+    [&](std::vector<event>& xs) { CHECK_EQUAL(xs.size(), 5u); },
+    error_handler()
+  );
+  ry.receive(
+    [&](std::vector<event>& xs) { CHECK_EQUAL(xs.size(), 8u); },
+    error_handler()
+  );
+}
+
 TEST(archiving and querying) {
   MESSAGE("import bro conn logs to archive");
   push_to_archive(bro_conn_log_slices);
@@ -14,7 +14,12 @@
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
 
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/default_table_slice.hpp"
+#include "vast/ids.hpp"
 #include "vast/query_options.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/to_events.hpp"
 
 #include "vast/system/archive.hpp"
 #include "vast/system/exporter.hpp"
@@ -57,7 +62,8 @@ struct fixture : fixture_base {
   }
 
   void spawn_archive() {
-    archive = self->spawn(system::archive, directory / "archive", 1, 1024);
+    archive = self->spawn(system::archive, directory / "archive", 1, 1024,
+                          compression::lz4);
   }
 
   void spawn_importer() {
@@ -115,9 +121,10 @@ struct fixture : fixture_base {
     std::vector<event> result;
     bool done = false;
     self->do_receive(
-      [&](std::vector<event>& xs) {
-        MESSAGE("... got " << xs.size() << " events");
-        std::move(xs.begin(), xs.end(), std::back_inserter(result));
+      [&](const std::vector<table_slice_ptr>& slices, const ids& rows) {
+        MESSAGE("... got " << rank(rows) << " events");
+        for (auto& slice : slices)
+          to_events(result, *slice, rows);
       },
       error_handler(),
       after(0ms) >> [&] {
@@ -161,6 +168,33 @@ TEST(historical query without importer) {
   CHECK_EQUAL(results.back().id(), 19u);
 }
 
+TEST(historical query for enumeration names) {
+  MESSAGE("spawn index and archive");
+  spawn_index();
+  spawn_archive();
+  run();
+  MESSAGE("ingest events with an enumeration field");
+  auto layout = record_type{
+    {"proto", enumeration_type{{"tcp", "udp", "icmp"}}}
+  }.name("test::enumeration");
+  std::vector<vector> rows;
+  for (enumeration x : {0, 1, 0, 2, 1, 1})
+    rows.push_back(vector{x});
+  std::vector<table_slice_ptr> slices{default_table_slice::make(layout, rows)};
+  vast::detail::spawn_container_source(sys, slices, index, archive);
+  run();
+  MESSAGE("spawn exporter for a query by field name");
+  expr = unbox(to<expression>("proto == \"udp\""));
+  exporter_setup(historical);
+  MESSAGE("fetch results");
+  auto results = fetch_results();
+  REQUIRE_EQUAL(results.size(), 3u);
+  std::sort(results.begin(), results.end());
+  CHECK_EQUAL(results[0].id(), 1u);
+  CHECK_EQUAL(results[1].id(), 4u);
+  CHECK_EQUAL(results[2].id(), 5u);
+}
+
 TEST(historical query with importer) {
   MESSAGE("prepare importer");
   importer_setup();
@@ -35,7 +35,7 @@ namespace {
 
 struct fixture : fixtures::deterministic_actor_system_and_events {
   void init(record_type layout) {
-    indexer = self->spawn(system::indexer, directory, std::move(layout));
+    indexer = self->spawn(system::indexer, directory, std::move(layout), pool);
     run();
   }
 
@@ -51,6 +51,10 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
     return request<ids>(indexer, std::move(pred));
   }
 
+  // Exercises parallel indexing of columns.
+  std::shared_ptr<vast::detail::thread_pool> pool
+    = std::make_shared<vast::detail::thread_pool>(2);
+
   actor indexer;
 };
 
@@ -0,0 +1,94 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#define SUITE partition_cache
+#include "vast/test/test.hpp"
+
+#include "vast/system/partition_cache.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+#include "vast/test/fixtures/actor_system.hpp"
+
+using namespace vast;
+using namespace vast::system;
+
+namespace {
+
+struct fixture : fixtures::deterministic_actor_system {
+  fixture()
+    : cache(3, 100,
+            [this](const uuid& id) {
+              auto f = [](path, record_type) { return caf::actor{}; };
+              return make_partition(sys, directory, id, f);
+            },
+            [this](const partition& part) { return sizes[part.id()]; }) {
+    for (size_t i = 0; i < 5; ++i)
+      ids.push_back(uuid::random());
+  }
+
+  std::unordered_map<uuid, size_t> sizes;
+  std::vector<uuid> ids;
+  partition_cache cache;
+};
+
+} // namespace <anonymous>
+
+FIXTURE_SCOPE(partition_cache_tests, fixture)
+
+TEST(partition limit) {
+  for (auto& id : ids)
+    CHECK_EQUAL(cache.get_or_add(id)->id(), id);
+  CHECK_EQUAL(cache.size(), 3u);
+  CHECK(!cache.contains(ids[0]));
+  CHECK(!cache.contains(ids[1]));
+  CHECK(cache.contains(ids[2]));
+  MESSAGE("accessing a partition makes it the most recently used one");
+  cache.get_or_add(ids[2]);
+  cache.get_or_add(ids[0]);
+  CHECK(cache.contains(ids[2]));
+  CHECK(!cache.contains(ids[3]));
+  CHECK_EQUAL(cache.stats().hits, 1u);
+  CHECK_EQUAL(cache.stats().misses, 6u);
+  CHECK_EQUAL(cache.stats().evictions, 3u);
+}
+
+TEST(memory budget) {
+  sizes[ids[0]] = 40;
+  sizes[ids[1]] = 40;
+  sizes[ids[2]] = 40;
+  cache.get_or_add(ids[0]);
+  cache.get_or_add(ids[1]);
+  CHECK_EQUAL(cache.bytes(), 80u);
+  cache.get_or_add(ids[2]);
+  CHECK_EQUAL(cache.size(), 2u);
+  CHECK_EQUAL(cache.bytes(), 80u);
+  CHECK(!cache.contains(ids[0]));
+  MESSAGE("a partition that exceeds the budget on its own stays cached");
+  sizes[ids[3]] = 1000;
+  CHECK_EQUAL(cache.get_or_add(ids[3])->id(), ids[3]);
+  CHECK_EQUAL(cache.size(), 1u);
+  CHECK_EQUAL(cache.bytes(), 1000u);
+  MESSAGE("shrinking the budget evicts partitions");
+  cache.max_bytes(2000);
+  cache.get_or_add(ids[4]);
+  CHECK_EQUAL(cache.size(), 2u);
+  cache.max_bytes(0);
+  CHECK_EQUAL(cache.size(), 1u);
+  CHECK(cache.contains(ids[4]));
+  CHECK_EQUAL(cache.stats().evictions, 4u);
+}
+
+FIXTURE_SCOPE_END()
@@ -20,6 +20,8 @@
 
 #include "vast/test/fixtures/actor_system_and_events.hpp"
 
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/expression.hpp"
 #include "vast/detail/make_io_stream.hpp"
 #include "vast/format/bro.hpp"
 #include "vast/system/atoms.hpp"
@@ -28,6 +30,7 @@
 
 using namespace vast;
 using namespace vast::system;
+using namespace std::string_literals;
 
 namespace {
 
@@ -101,4 +104,58 @@ TEST(bro source) {
   run();
 }
 
+TEST(bro source with filter) {
+  namespace bf = format::bro;
+  auto stream = detail::make_input_stream(bro::small_conn);
+  REQUIRE(stream);
+  bf::reader reader{std::move(*stream)};
+  auto src = self->spawn(source<bf::reader>, std::move(reader),
+                         default_table_slice::make_builder,
+                         events::slice_size);
+  self->send(src, unbox(to<expression>("service == \"dns\"")));
+  run();
+  auto snk = self->spawn(test_sink, src);
+  run();
+  MESSAGE("matching events fill up entire slices");
+  const auto& slices = deref<test_sink_type>(snk).state.slices;
+  REQUIRE_EQUAL(slices.size(), 2u);
+  CHECK_EQUAL(slices[0]->rows(), events::slice_size);
+  CHECK_EQUAL(slices[1]->rows(), 3u);
+  for (auto& slice : slices)
+    for (size_t row = 0; row < slice->rows(); ++row)
+      CHECK_EQUAL(materialize(slice->at(row, 8)), data{"dns"s});
+  self->send_exit(src, caf::exit_reason::user_shutdown);
+  run();
+}
+
+TEST(bro source with non-matching filter) {
+  namespace bf = format::bro;
+  auto stream = detail::make_input_stream(bro::small_conn);
+  REQUIRE(stream);
+  bf::reader reader{std::move(*stream)};
+  auto src = self->spawn(source<bf::reader>, std::move(reader),
+                         default_table_slice::make_builder,
+                         events::slice_size);
+  self->send(src, unbox(to<expression>("service == \"foo\"")));
+  run();
+  auto& st = deref<caf::stateful_actor<source_state<bf::reader>>>(src).state;
+  MESSAGE("a single run reads no more than the maximum number of events");
+  std::vector<table_slice_ptr> slices;
+  auto push_slice = [&](table_slice_ptr slice) {
+    slices.push_back(std::move(slice));
+  };
+  auto result = st.extract_events(12, events::slice_size, push_slice);
+  CHECK_EQUAL(result.first, 0u);
+  CHECK(!result.second);
+  CHECK(slices.empty());
+  MESSAGE("the reader still holds the remaining events");
+  size_t remaining = 0;
+  for (auto e = st.reader.read(); e || !e.error(); e = st.reader.read())
+    if (e)
+      ++remaining;
+  CHECK_EQUAL(remaining, bro_conn_log.size() - 12);
+  self->send_exit(src, caf::exit_reason::user_shutdown);
+  run();
+}
+
 FIXTURE_SCOPE_END()
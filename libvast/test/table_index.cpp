@@ -165,6 +165,50 @@ TEST(bro conn logs) {
   verify();
 }
 
+TEST(parallel bro conn logs) {
+  auto layout = bro_conn_log_layout();
+  init(make_table_index(sys, directory, layout));
+  tbl->parallelize(std::make_shared<vast::detail::thread_pool>(3));
+  MESSAGE("ingest test data on multiple threads");
+  for (auto slice : bro_conn_log_slices)
+    add(slice);
+  CHECK_EQUAL(rank(query("id.resp_p == 53/? || id.resp_p == 137/?")), 8u);
+  CHECK_EQUAL(rank(query("proto == \"udp\"")), 20u);
+  CHECK_EQUAL(rank(query("orig_bytes < 400 && proto == \"udp\"")), 17u);
+  MESSAGE("check per-column accounting");
+  auto times = tbl->take_append_times();
+  REQUIRE_EQUAL(times.size(), layout.fields.size());
+  for (auto& t : tbl->take_append_times())
+    CHECK(t == timespan::zero());
+}
+
+TEST(cheap operands first) {
+  auto layout = bro_conn_log_layout();
+  init(make_table_index(sys, directory, layout));
+  for (auto slice : bro_conn_log_slices)
+    add(slice);
+  MESSAGE("restore the table index without loading any column");
+  tbl.reset();
+  init(make_table_index(sys, directory, layout));
+  auto loaded_columns = [&] {
+    size_t result = 0;
+    tbl->for_each_column([&](column_index* col) {
+      if (col != nullptr)
+        ++result;
+    });
+    return result;
+  };
+  CHECK_EQUAL(loaded_columns(), 0u);
+  MESSAGE("a mismatching type short-circuits the conjunction");
+  CHECK_EQUAL(rank(query(":addr == 192.168.1.104 && &type == \"foo\"")), 0u);
+  CHECK_EQUAL(loaded_columns(), 0u);
+  MESSAGE("a matching type does not");
+  auto type_query = ":addr == 192.168.1.104 && &type == \"" + layout.name()
+                    + '"';
+  CHECK_EQUAL(rank(query(type_query)), 4u);
+  CHECK_NOT_EQUAL(loaded_columns(), 0u);
+}
+
 TEST_DISABLED(bro conn log http slices) {
   MESSAGE("scrutinize each bro conn log slice individually");
   // Pre-computed via:
@@ -151,6 +151,11 @@ TEST(type/data compatibility) {
   CHECK(compatible(address_type{}, in, subnet{}));
   CHECK(compatible(subnet_type{}, in, subnet_type{}));
   CHECK(compatible(subnet_type{}, in, subnet{}));
+  MESSAGE("counts check against enumerations");
+  auto e = enumeration_type{{"foo", "bar"}};
+  CHECK(type_check(e, count{1}));
+  CHECK(!type_check(e, count{2}));
+  CHECK(type_check(count_type{}, count{2}));
 }
 
 TEST(serialization) {
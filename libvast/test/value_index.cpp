@@ -17,6 +17,7 @@
 #include "vast/test/fixtures/actor_system_and_events.hpp"
 
 #include "vast/value_index.hpp"
+#include "vast/default_table_slice.hpp"
 #include "vast/load.hpp"
 #include "vast/save.hpp"
 
@@ -195,6 +196,65 @@ TEST(timestamp) {
   CHECK(to_string(*eighteen) == "000101");
 }
 
+TEST(time index) {
+  using namespace std::chrono;
+  auto ptr = value_index::make(timestamp_type{});
+  REQUIRE(ptr != nullptr);
+  REQUIRE(dynamic_cast<time_index*>(ptr.get()) != nullptr);
+  auto& idx = *ptr;
+  auto t = unbox(to<timestamp>("2014-01-16+05:30:15"));
+  MESSAGE("append values with sub-second differences");
+  REQUIRE(idx.append(make_data_view(t)));
+  REQUIRE(idx.append(make_data_view(t + 500ms)));
+  REQUIRE(idx.append(caf::none));
+  REQUIRE(idx.append(make_data_view(t + 1500ms), 4));
+  REQUIRE(idx.append(make_data_view(t + 250ms)));
+  MESSAGE("lookup");
+  auto lookup = [&](relational_operator op, timestamp x) {
+    return to_string(unbox(idx.lookup(op, make_data_view(x))));
+  };
+  CHECK_EQUAL(lookup(equal, t + 500ms), "01000");
+  CHECK_EQUAL(lookup(not_equal, t + 500ms), "10011");
+  CHECK_EQUAL(lookup(less, t + 500ms), "10001");
+  CHECK_EQUAL(lookup(less_equal, t + 500ms), "11001");
+  CHECK_EQUAL(lookup(greater, t + 250ms), "01010");
+  CHECK_EQUAL(lookup(greater_equal, t + 250ms), "01011");
+  MESSAGE("span multiple blocks");
+  time_index blocks;
+  auto n = time_index::block_size * 3;
+  for (size_t i = 0; i < n; ++i)
+    REQUIRE(blocks.append(make_data_view(t + microseconds(i))));
+  auto x = t + microseconds(n / 2);
+  CHECK_EQUAL(rank(unbox(blocks.lookup(less, make_data_view(x)))), n / 2);
+  CHECK_EQUAL(rank(unbox(blocks.lookup(equal, make_data_view(x)))), 1u);
+  CHECK_EQUAL(rank(unbox(blocks.lookup(greater_equal, make_data_view(x)))),
+              n - n / 2);
+  MESSAGE("bulk lookup");
+  vector xs;
+  for (size_t i = 0; i < n; i += 100)
+    xs.emplace_back(t + microseconds(i));
+  xs.emplace_back(t - 1us);
+  CHECK_EQUAL(rank(unbox(blocks.lookup(in, make_data_view(xs)))),
+              xs.size() - 1);
+  CHECK_EQUAL(rank(unbox(blocks.lookup(not_in, make_data_view(xs)))),
+              n - (xs.size() - 1));
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(save(sys, buf, blocks), caf::none);
+  time_index blocks2;
+  CHECK_EQUAL(load(sys, buf, blocks2), caf::none);
+  CHECK_EQUAL(rank(unbox(blocks2.lookup(less, make_data_view(x)))), n / 2);
+  MESSAGE("the base attribute and version 0 select an arithmetic index");
+  using legacy_index = arithmetic_index<timestamp>;
+  type with_base = timestamp_type{}.attributes({{"base", "uniform(10, 20)"}});
+  ptr = value_index::make(with_base);
+  CHECK(dynamic_cast<legacy_index*>(ptr.get()) != nullptr);
+  ptr = value_index::make(timestamp_type{}, 0);
+  CHECK(dynamic_cast<legacy_index*>(ptr.get()) != nullptr);
+  with_base = timestamp_type{}.attributes({{"base", "foo"}});
+  CHECK(value_index::make(with_base) == nullptr);
+}
+
 TEST(string) {
   string_index idx{100};
   MESSAGE("append");
@@ -260,6 +320,103 @@ TEST(string) {
   CHECK_EQUAL(to_string(*result), "0100010000");
 }
 
+TEST(dictionary) {
+  auto t = string_type{}.attributes({{"index", "dictionary"}});
+  auto ptr = value_index::make(t);
+  REQUIRE(ptr);
+  REQUIRE(dynamic_cast<dictionary_index*>(ptr.get()) != nullptr);
+  auto& idx = *ptr;
+  MESSAGE("append");
+  REQUIRE(idx.append(make_data_view("foo")));
+  REQUIRE(idx.append(make_data_view("bar")));
+  REQUIRE(idx.append(make_data_view("baz")));
+  REQUIRE(idx.append(make_data_view("foo")));
+  REQUIRE(idx.append(make_data_view("foo")));
+  REQUIRE(idx.append(make_data_view("bar")));
+  REQUIRE(idx.append(make_data_view("")));
+  REQUIRE(idx.append(make_data_view("qux")));
+  REQUIRE(idx.append(make_data_view("corge")));
+  REQUIRE(idx.append(make_data_view("bazz")));
+  MESSAGE("lookup");
+  auto result = idx.lookup(equal, make_data_view("foo"));
+  CHECK_EQUAL(to_string(*result), "1001100000");
+  result = idx.lookup(equal, make_data_view("bar"));
+  CHECK_EQUAL(to_string(*result), "0100010000");
+  result = idx.lookup(equal, make_data_view(""));
+  CHECK_EQUAL(to_string(*result), "0000001000");
+  result = idx.lookup(equal, make_data_view("bazz"));
+  CHECK_EQUAL(to_string(*result), "0000000001");
+  result = idx.lookup(equal, make_data_view("nope"));
+  CHECK_EQUAL(to_string(*result), "0000000000");
+  result = idx.lookup(not_equal, make_data_view("foo"));
+  CHECK_EQUAL(to_string(*result), "0110011111");
+  result = idx.lookup(ni, make_data_view("o"));
+  CHECK_EQUAL(to_string(*result), "1001100010");
+  result = idx.lookup(ni, make_data_view("z"));
+  CHECK_EQUAL(to_string(*result), "0010000001");
+  result = idx.lookup(not_ni, make_data_view("ar"));
+  CHECK_EQUAL(to_string(*result), "1011101111");
+  result = idx.lookup(match, make_data_view("foo"));
+  CHECK(!result);
+  auto xs = set{"foo", "bar", "baz"};
+  result = idx.lookup(in, make_data_view(xs));
+  REQUIRE(result);
+  CHECK_EQUAL(to_string(*result), "1111110000");
+  MESSAGE("bulk lookup");
+  auto many = vector{"foo", "qux"};
+  for (auto i = 0; i < 100; ++i)
+    many.emplace_back("x" + std::to_string(i));
+  result = idx.lookup(in, make_data_view(many));
+  REQUIRE(result);
+  CHECK_EQUAL(to_string(*result), "1001100100");
+  result = idx.lookup(not_in, make_data_view(many));
+  REQUIRE(result);
+  CHECK_EQUAL(to_string(*result), "0110011011");
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(save(sys, buf, static_cast<dictionary_index&>(idx)), caf::none);
+  dictionary_index idx2;
+  CHECK_EQUAL(load(sys, buf, idx2), caf::none);
+  result = idx2.lookup(equal, make_data_view("foo"));
+  CHECK_EQUAL(to_string(*result), "1001100000");
+  REQUIRE(idx2.append(make_data_view("bar")));
+  result = idx2.lookup(equal, make_data_view("bar"));
+  CHECK_EQUAL(to_string(*result), "01000100001");
+  MESSAGE("postings follow the selected bitmap type");
+  dictionary_index idx3;
+  idx3.select_bitmap_type(caf::atom("roaring"));
+  REQUIRE(idx3.append(make_data_view("foo")));
+  REQUIRE(idx3.append(make_data_view("bar")));
+  result = idx3.lookup(equal, make_data_view("foo"));
+  REQUIRE(result);
+  CHECK(caf::holds_alternative<roaring_bitmap>(*result));
+  CHECK_EQUAL(to_string(*result), "10");
+  MESSAGE("persisted EWAH postings mix with roaring postings");
+  dictionary_index idx4;
+  CHECK_EQUAL(load(sys, buf, idx4), caf::none);
+  idx4.select_bitmap_type(caf::atom("roaring"));
+  REQUIRE(idx4.append(make_data_view("foo")));
+  REQUIRE(idx4.append(make_data_view("grault")));
+  result = idx4.lookup(equal, make_data_view("foo"));
+  REQUIRE(result);
+  CHECK(caf::holds_alternative<ewah_bitmap>(*result));
+  CHECK_EQUAL(to_string(*result), "100110000010");
+  result = idx4.lookup(equal, make_data_view("grault"));
+  REQUIRE(result);
+  CHECK(caf::holds_alternative<roaring_bitmap>(*result));
+  CHECK_EQUAL(to_string(*result), "000000000001");
+  result = idx4.lookup(in, make_data_view(vector{"grault", "bar"}));
+  REQUIRE(result);
+  CHECK_EQUAL(to_string(*result), "010001000001");
+  result = idx4.lookup(not_equal, make_data_view("grault"));
+  REQUIRE(result);
+  CHECK_EQUAL(to_string(*result), "111111111110");
+  MESSAGE("version 0 ignores the attribute");
+  auto legacy = value_index::make(t, 0);
+  REQUIRE(legacy);
+  CHECK(dynamic_cast<string_index*>(legacy.get()) != nullptr);
+}
+
 TEST(address) {
   address_index idx;
   MESSAGE("append");
@@ -334,6 +491,65 @@ TEST(address) {
   CHECK_EQUAL(idx2.lookup(equal, make_data_view(x)), str);
 }
 
+TEST(radix address) {
+  auto t = address_type{}.attributes({{"index", "radix"}});
+  auto ptr = value_index::make(t);
+  REQUIRE(ptr != nullptr);
+  REQUIRE(dynamic_cast<radix_address_index*>(ptr.get()) != nullptr);
+  auto& idx = *ptr;
+  MESSAGE("append");
+  for (auto str : {"10.0.0.1", "10.1.2.3", "10.16.0.1", "192.168.0.1",
+                   "192.168.0.130", "2001:db8::1", "2001:db9::1"})
+    REQUIRE(idx.append(make_data_view(unbox(to<address>(str)))));
+  REQUIRE(idx.append(caf::none));
+  REQUIRE(idx.append(make_data_view(unbox(to<address>("10.0.0.1"))), 10));
+  auto lookup = [&](relational_operator op, auto x) {
+    return to_string(unbox(idx.lookup(op, make_data_view(x))));
+  };
+  MESSAGE("address equality");
+  auto x = unbox(to<address>("10.0.0.1"));
+  CHECK_EQUAL(lookup(equal, x), "10000000001");
+  CHECK_EQUAL(lookup(not_equal, x), "01111110000");
+  CHECK_EQUAL(lookup(equal, unbox(to<address>("10.0.0.2"))), "00000000000");
+  MESSAGE("prefix membership");
+  auto sn = [](auto str) { return unbox(to<subnet>(str)); };
+  CHECK_EQUAL(lookup(in, sn("10.0.0.0/8")), "11100000001");
+  CHECK_EQUAL(lookup(in, sn("10.0.0.0/12")), "11000000001");
+  CHECK_EQUAL(lookup(in, sn("10.0.0.0/24")), "10000000001");
+  CHECK_EQUAL(lookup(in, sn("192.168.0.128/25")), "00001000000");
+  CHECK_EQUAL(lookup(not_in, sn("192.168.0.0/16")), "11100110001");
+  CHECK_EQUAL(lookup(in, sn("2001:db8::/32")), "00000100000");
+  CHECK_EQUAL(lookup(in, sn("2001:db8::/31")), "00000110000");
+  CHECK_EQUAL(lookup(in, sn("2001:db8::/80")), "00000100000");
+  CHECK_EQUAL(lookup(in, sn("2001:db8::/127")), "00000100000");
+  CHECK_EQUAL(lookup(in, sn("2001:db8::2/127")), "00000000000");
+  MESSAGE("address ranges");
+  x = unbox(to<address>("10.16.0.1"));
+  CHECK_EQUAL(lookup(less, x), "11000000001");
+  CHECK_EQUAL(lookup(less_equal, x), "11100000001");
+  CHECK_EQUAL(lookup(greater, x), "00011110000");
+  CHECK_EQUAL(lookup(greater_equal, x), "00111110000");
+  MESSAGE("address lists");
+  vector xs;
+  for (auto i = 0; i < 20; ++i)
+    xs.emplace_back(unbox(to<address>("10.0.0." + std::to_string(i))));
+  xs.emplace_back(unbox(to<address>("2001:db9::1")));
+  CHECK_EQUAL(lookup(in, xs), "10000010001");
+  CHECK_EQUAL(lookup(not_in, xs), "01111100000");
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  auto& ref = static_cast<radix_address_index&>(idx);
+  CHECK_EQUAL(save(sys, buf, ref), caf::none);
+  radix_address_index idx2;
+  CHECK_EQUAL(load(sys, buf, idx2), caf::none);
+  auto bm = idx2.lookup(in, make_data_view(sn("10.0.0.0/12")));
+  CHECK_EQUAL(to_string(unbox(bm)), "11000000001");
+  MESSAGE("version 0 ignores the attribute");
+  auto legacy = value_index::make(t, 0);
+  REQUIRE(legacy);
+  CHECK(dynamic_cast<address_index*>(legacy.get()) != nullptr);
+}
+
 TEST(subnet) {
   subnet_index idx;
   auto s0 = *to<subnet>("192.168.0.0/24");
@@ -363,21 +579,26 @@ TEST(subnet) {
   REQUIRE(bm);
   CHECK_EQUAL(to_string(*bm), "000000");
   MESSAGE("subset lookup (ni)");
+  // IPv4 subnets map into ::ffff:0:0/96, which ::/40 includes.
   bm = idx.lookup(ni, make_data_view(s0));
   REQUIRE(bm);
-  CHECK_EQUAL(to_string(*bm), "101100");
+  CHECK_EQUAL(to_string(*bm), "101111");
   x = *to<subnet>("192.168.1.128/25");
   bm = idx.lookup(ni, make_data_view(x));
   REQUIRE(bm);
-  CHECK_EQUAL(to_string(*bm), "010000");
+  CHECK_EQUAL(to_string(*bm), "010011");
   x = *to<subnet>("192.168.0.254/32");
   bm = idx.lookup(ni, make_data_view(x));
   REQUIRE(bm);
-  CHECK_EQUAL(to_string(*bm), "101100");
+  CHECK_EQUAL(to_string(*bm), "101111");
   x = *to<subnet>("192.0.0.0/8");
   bm = idx.lookup(ni, make_data_view(x));
   REQUIRE(bm);
-  CHECK_EQUAL(to_string(*bm), "000000");
+  CHECK_EQUAL(to_string(*bm), "000011");
+  x = *to<subnet>("2001:db8::/32");
+  bm = idx.lookup(not_ni, make_data_view(x));
+  REQUIRE(bm);
+  CHECK_EQUAL(to_string(*bm), "111111");
   auto xs = vector{s0, s1};
   auto multi = idx.lookup(in, make_data_view(xs));
   REQUIRE(multi);
@@ -390,6 +611,20 @@ TEST(subnet) {
   bm = idx2.lookup(not_equal, make_data_view(s1));
   REQUIRE(bm);
   CHECK_EQUAL(to_string(*bm), "101111");
+  bm = idx2.lookup(ni, make_data_view(s0));
+  REQUIRE(bm);
+  CHECK_EQUAL(to_string(*bm), "101111");
+  MESSAGE("version 1 has no radix tree");
+  subnet_index legacy{1};
+  REQUIRE(legacy.append(make_data_view(s0)));
+  REQUIRE(legacy.append(make_data_view(s1)));
+  buf.clear();
+  CHECK_EQUAL(save(sys, buf, legacy), caf::none);
+  subnet_index legacy2{1};
+  CHECK_EQUAL(load(sys, buf, legacy2), caf::none);
+  bm = legacy2.lookup(ni, make_data_view(*to<subnet>("192.168.1.0/25")));
+  REQUIRE(bm);
+  CHECK_EQUAL(to_string(*bm), "01");
 }
 
 TEST(port) {
@@ -456,6 +691,162 @@ TEST(container) {
   CHECK_EQUAL(to_string(*idx2.lookup(ni, make_data_view(x))), "11000000");
 }
 
+TEST(membership) {
+  auto ptr = value_index::make(vector_type{count_type{}});
+  REQUIRE(ptr != nullptr);
+  REQUIRE(dynamic_cast<membership_index*>(ptr.get()) != nullptr);
+  auto& idx = *ptr;
+  MESSAGE("append");
+  vector xs{count{1}, count{2}, count{1}};
+  REQUIRE(idx.append(make_data_view(xs)));
+  xs = {count{3}};
+  REQUIRE(idx.append(make_data_view(xs)));
+  xs.clear();
+  REQUIRE(idx.append(make_data_view(xs)));
+  REQUIRE(idx.append(caf::none));
+  xs = {count{2}, count{3}};
+  REQUIRE(idx.append(make_data_view(xs), 5));
+  REQUIRE(idx.append(make_data_view(xs)));
+  MESSAGE("lookup");
+  auto lookup = [&](relational_operator op, count x) {
+    return to_string(unbox(idx.lookup(op, make_data_view(x))));
+  };
+  CHECK_EQUAL(lookup(ni, 1), "1000000");
+  CHECK_EQUAL(lookup(ni, 2), "1000011");
+  CHECK_EQUAL(lookup(not_ni, 2), "0110000");
+  CHECK_EQUAL(lookup(ni, 4), "0000000");
+  CHECK_EQUAL(lookup(not_ni, 4), "1110011");
+  MESSAGE("integer lookups match counts");
+  auto x = integer{3};
+  CHECK_EQUAL(to_string(unbox(idx.lookup(ni, make_data_view(x)))), "0100011");
+  MESSAGE("equality with the empty container");
+  auto empty = vector{};
+  CHECK_EQUAL(to_string(unbox(idx.lookup(equal, make_data_view(empty)))),
+              "0010000");
+  CHECK_EQUAL(to_string(unbox(idx.lookup(not_equal, make_data_view(empty)))),
+              "1100011");
+  MESSAGE("unsupported operators");
+  CHECK(!idx.lookup(equal, make_data_view(count{1})));
+  CHECK(!idx.lookup(equal, make_data_view(vector{count{1}})));
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(save(sys, buf, static_cast<membership_index&>(idx)), caf::none);
+  membership_index idx2;
+  CHECK_EQUAL(load(sys, buf, idx2), caf::none);
+  x = 2;
+  CHECK_EQUAL(to_string(unbox(idx2.lookup(ni, make_data_view(x)))), "1000011");
+  MESSAGE("version 0 selects a sequence index");
+  type legacy_type = set_type{timestamp_type{}};
+  auto legacy = value_index::make(legacy_type, 0);
+  REQUIRE(dynamic_cast<sequence_index*>(legacy.get()) != nullptr);
+  auto t = timestamp{};
+  REQUIRE(legacy->append(make_data_view(set{t})));
+  buf.clear();
+  detail::value_index_inspect_helper writer{legacy_type, legacy, 0};
+  CHECK_EQUAL(save(sys, buf, writer), caf::none);
+  std::unique_ptr<value_index> legacy2;
+  detail::value_index_inspect_helper reader{legacy_type, legacy2, 0};
+  CHECK_EQUAL(load(sys, buf, reader), caf::none);
+  REQUIRE(dynamic_cast<sequence_index*>(legacy2.get()) != nullptr);
+  CHECK_EQUAL(to_string(unbox(legacy2->lookup(ni, make_data_view(t)))), "1");
+}
+
+TEST(enumeration) {
+  auto t = enumeration_type{{"tcp", "udp", "icmp"}};
+  auto ptr = value_index::make(t);
+  REQUIRE(ptr != nullptr);
+  REQUIRE(dynamic_cast<enumeration_index*>(ptr.get()) != nullptr);
+  auto& idx = *ptr;
+  MESSAGE("append");
+  REQUIRE(idx.append(make_data_view(enumeration{0})));
+  REQUIRE(idx.append(make_data_view(enumeration{2})));
+  REQUIRE(idx.append(caf::none));
+  REQUIRE(idx.append(make_data_view(enumeration{1}), 4));
+  REQUIRE(idx.append(make_data_view(enumeration{0})));
+  CHECK(!idx.append(make_data_view(enumeration{3})));
+  MESSAGE("lookup");
+  auto lookup = [&](relational_operator op, auto x) {
+    return to_string(unbox(idx.lookup(op, make_data_view(x))));
+  };
+  CHECK_EQUAL(lookup(equal, enumeration{0}), "100001");
+  CHECK_EQUAL(lookup(equal, "udp"s), "000010");
+  CHECK_EQUAL(lookup(not_equal, "tcp"s), "010010");
+  CHECK_EQUAL(lookup(equal, "sctp"s), "000000");
+  CHECK_EQUAL(lookup(not_equal, "sctp"s), "110011");
+  CHECK(!idx.lookup(less, make_data_view(enumeration{1})));
+  auto xs = vector{"udp", "icmp"};
+  CHECK_EQUAL(to_string(unbox(idx.lookup(in, make_data_view(xs)))),
+              "010010");
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(save(sys, buf, static_cast<enumeration_index&>(idx)),
+              caf::none);
+  enumeration_index idx2;
+  CHECK_EQUAL(load(sys, buf, idx2), caf::none);
+  auto icmp = "icmp"s;
+  CHECK_EQUAL(to_string(unbox(idx2.lookup(equal, make_data_view(icmp)))),
+              "010000");
+}
+
+TEST(pattern) {
+  auto ptr = value_index::make(pattern_type{});
+  REQUIRE(ptr != nullptr);
+  REQUIRE(dynamic_cast<pattern_index*>(ptr.get()) != nullptr);
+  auto& idx = *ptr;
+  MESSAGE("append");
+  auto foo = pattern{"fo+"};
+  auto bar = pattern{"ba[rz]"};
+  REQUIRE(idx.append(make_data_view(foo)));
+  REQUIRE(idx.append(make_data_view(bar)));
+  REQUIRE(idx.append(caf::none));
+  REQUIRE(idx.append(make_data_view(foo)));
+  REQUIRE(idx.append(make_data_view(bar), 5));
+  CHECK(!idx.append(make_data_view("foo"s)));
+  MESSAGE("lookup");
+  auto lookup = [&](relational_operator op, const pattern& x) {
+    return to_string(unbox(idx.lookup(op, make_data_view(x))));
+  };
+  CHECK_EQUAL(lookup(equal, foo), "100100");
+  CHECK_EQUAL(lookup(not_equal, foo), "010001");
+  CHECK_EQUAL(lookup(equal, pattern{"qux"}), "000000");
+  CHECK_EQUAL(lookup(not_equal, pattern{"qux"}), "110101");
+  CHECK(!idx.lookup(match, make_data_view(foo)));
+  auto xs = vector{bar, pattern{"qux"}};
+  CHECK_EQUAL(to_string(unbox(idx.lookup(in, make_data_view(xs)))),
+              "010001");
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(save(sys, buf, static_cast<pattern_index&>(idx)), caf::none);
+  pattern_index idx2;
+  CHECK_EQUAL(load(sys, buf, idx2), caf::none);
+  CHECK_EQUAL(to_string(unbox(idx2.lookup(equal, make_data_view(bar)))),
+              "010001");
+  MESSAGE("version 1 has no pattern index");
+  CHECK(!value_index::make(pattern_type{}, 1));
+}
+
+TEST(map) {
+  auto ptr = value_index::make(map_type{string_type{}, count_type{}});
+  REQUIRE(ptr != nullptr);
+  REQUIRE(dynamic_cast<membership_index*>(ptr.get()) != nullptr);
+  auto& idx = *ptr;
+  MESSAGE("append");
+  auto xs = map{{"foo", count{1}}, {"bar", count{2}}};
+  REQUIRE(idx.append(make_data_view(xs)));
+  xs = map{{"baz", count{1}}};
+  REQUIRE(idx.append(make_data_view(xs)));
+  xs = map{{"bar", count{3}}};
+  REQUIRE(idx.append(make_data_view(xs)));
+  MESSAGE("lookup keys");
+  auto x = "bar"s;
+  CHECK_EQUAL(to_string(unbox(idx.lookup(ni, make_data_view(x)))), "101");
+  CHECK_EQUAL(to_string(unbox(idx.lookup(not_ni, make_data_view(x)))), "010");
+  CHECK_EQUAL(to_string(unbox(idx.lookup(ni, make_data_view(count{1})))),
+              "000");
+  MESSAGE("version 0 has no map index");
+  CHECK(!value_index::make(map_type{string_type{}, count_type{}}, 0));
+}
+
 TEST(polymorphic) {
   type t = set_type{integer_type{}}.attributes({{"max_size", "2"}});
   auto idx = value_index::make(t);
@@ -536,6 +927,59 @@ TEST(polymorphic none values) {
   CHECK_EQUAL(to_string(*bm), "01100011100001111111100");
 }
 
+TEST(batch append) {
+  auto layout = bro_conn_log_slices[0]->layout();
+  for (size_t col = 0; col < layout.fields.size(); ++col) {
+    MESSAGE("compare batch and per-value appends of column "
+            << layout.fields[col].name);
+    auto& t = layout.fields[col].type;
+    auto per_value = value_index::make(t);
+    auto batch = value_index::make(t);
+    REQUIRE(per_value);
+    REQUIRE(batch);
+    for (auto& slice : bro_conn_log_slices) {
+      for (size_t row = 0; row < slice->rows(); ++row)
+        REQUIRE(per_value->append(slice->at(row, col), slice->offset() + row));
+      REQUIRE(batch->append(*slice, col));
+    }
+    CHECK_EQUAL(batch->offset(), per_value->offset());
+    auto& slice = *bro_conn_log_slices[0];
+    for (size_t row = 0; row < slice.rows(); ++row) {
+      auto x = slice.at(row, col);
+      for (auto op : {equal, not_equal}) {
+        auto want = per_value->lookup(op, x);
+        auto got = batch->lookup(op, x);
+        REQUIRE_EQUAL(static_cast<bool>(got), static_cast<bool>(want));
+        if (want)
+          CHECK_EQUAL(*got, *want);
+      }
+    }
+  }
+}
+
+TEST(batch append failure) {
+  auto fields = std::vector<std::string>{"a", "b", "c", "d", "e", "f"};
+  auto layout = record_type{{"e", enumeration_type{fields}}};
+  auto builder = default_table_slice::make_builder(layout);
+  for (auto x : {0u, 0u, 1u, 5u, 1u})
+    REQUIRE(builder->add(make_data_view(enumeration{x})));
+  auto slice = builder->finish();
+  REQUIRE(slice != nullptr);
+  MESSAGE("the index keeps the runs before the failing one");
+  auto idx = value_index::make(enumeration_type{{"a", "b"}});
+  REQUIRE(idx != nullptr);
+  CHECK(!idx->append(*slice, 0));
+  CHECK_EQUAL(idx->offset(), 3u);
+  auto lookup = [&](enumeration x) {
+    return to_string(unbox(idx->lookup(equal, make_data_view(x))));
+  };
+  CHECK_EQUAL(lookup(0), "110");
+  CHECK_EQUAL(lookup(1), "001");
+  MESSAGE("appending continues after the appended rows");
+  REQUIRE(idx->append(make_data_view(enumeration{1}), 4));
+  CHECK_EQUAL(lookup(1), "00101");
+}
+
 auto orig_h(const event& x) {
   auto& log_entry = caf::get<vector>(x.data());
   auto& conn_id = caf::get<vector>(log_entry[2]);
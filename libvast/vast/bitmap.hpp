@@ -13,12 +13,15 @@
 
 #pragma once
 
+#include <caf/atom.hpp>
+#include <caf/error.hpp>
 #include <caf/variant.hpp>
 #include <caf/detail/type_list.hpp>
 
 #include "vast/bitmap_base.hpp"
 #include "vast/ewah_bitmap.hpp"
 #include "vast/null_bitmap.hpp"
+#include "vast/roaring_bitmap.hpp"
 #include "vast/wah_bitmap.hpp"
 
 #include "vast/detail/operators.hpp"
@@ -37,7 +40,8 @@ public:
   using types = caf::detail::type_list<
     ewah_bitmap,
     null_bitmap,
-    wah_bitmap
+    wah_bitmap,
+    roaring_bitmap
   >;
 
   using variant = caf::detail::tl_apply_t<types, caf::variant>;
@@ -45,9 +49,14 @@ public:
   /// The concrete bitmap type to be used for default construction.
   using default_bitmap = ewah_bitmap;
 
-  /// Default-constructs a bitmap of type ::default_bitmap.
+  /// Default-constructs a bitmap of the default type.
   bitmap();
 
+  /// Constructs an empty bitmap of a given type.
+  /// @param type The bitmap type: `ewah`, `null`, `wah`, or `roaring`.
+  /// @pre `valid_type(type)`
+  explicit bitmap(caf::atom_value type);
+
   /// Constructs a bitmap from a concrete bitmap type.
   /// @param bm The bitmap instance to type-erase.
   template <
@@ -64,6 +73,11 @@ public:
   /// @param bit The bit value for all *n* bits.
   bitmap(size_type n, bool bit = false);
 
+  /// Tests whether an atom names a bitmap type.
+  /// @param type The atom to test.
+  /// @returns `true` iff *type* is `ewah`, `null`, `wah`, or `roaring`.
+  static bool valid_type(caf::atom_value type);
+
   // -- inspectors -----------------------------------------------------------
 
   bool empty() const;
@@ -109,7 +123,8 @@ private:
   using range_variant = caf::variant<
     ewah_bitmap_range,
     null_bitmap_range,
-    wah_bitmap_range
+    wah_bitmap_range,
+    roaring_bitmap_range
   >;
 
   range_variant range_;
@@ -117,6 +132,59 @@ private:
 
 bitmap_bit_range bit_range(const bitmap& bm);
 
+// -- algorithms ---------------------------------------------------------------
+
+/// Applies a bitwise operation on two type-erased bitmaps. If both hold the
+/// same concrete type, the operation runs on the concrete bitmaps to make use
+/// of type-specific algorithms.
+/// @relates bitmap
+template <bool FillLHS, bool FillRHS, class Operation>
+bitmap binary_eval(const bitmap& lhs, const bitmap& rhs, Operation op) {
+  auto& x = lhs.get_data();
+  auto& y = rhs.get_data();
+  if (x.index() != y.index())
+    return binary_eval<FillLHS, FillRHS, bitmap, bitmap, Operation>(lhs, rhs,
+                                                                    op);
+  auto f = [&](auto& l) -> bitmap {
+    auto& r = caf::get<std::decay_t<decltype(l)>>(y);
+    return binary_eval<FillLHS, FillRHS>(l, r, op);
+  };
+  return caf::visit(f, x);
+}
+
+/// Computes the rank of the concrete bitmap.
+/// @relates bitmap
+template <bool Bit = true>
+bitmap::size_type rank(const bitmap& bm) {
+  return caf::visit([](auto& x) { return rank<Bit>(x); }, bm.get_data());
+}
+
+/// Computes the rank of the concrete bitmap up to and including position *i*.
+/// @relates bitmap
+template <bool Bit = true>
+bitmap::size_type rank(const bitmap& bm, bitmap::size_type i) {
+  auto f = [=](auto& x) { return rank<Bit>(x, i); };
+  return caf::visit(f, bm.get_data());
+}
+
+/// Selects the *i*-th occurrence of a bit in the concrete bitmap.
+/// @relates bitmap
+template <bool Bit = true>
+bitmap::size_type select(const bitmap& bm, bitmap::size_type i) {
+  auto f = [=](auto& x) { return select<Bit>(x, i); };
+  return caf::visit(f, bm.get_data());
+}
+
+/// Traverses the 1-bits of the concrete bitmap in conjunction with a sorted
+/// range of half-open ID intervals.
+/// @relates bitmap
+template <class Iterator, class F, class G>
+caf::error select_with(const bitmap& bm, Iterator begin, Iterator end, F f,
+                       G g) {
+  auto visitor = [&](auto& x) { return select_with(x, begin, end, f, g); };
+  return caf::visit(visitor, bm.get_data());
+}
+
 } // namespace vast
 
 namespace caf {
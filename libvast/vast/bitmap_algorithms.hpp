@@ -14,7 +14,9 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
+#include <limits>
 #include <queue>
 #include <type_traits>
 
@@ -133,6 +135,162 @@ binary_eval(const LHS& lhs, const RHS& rhs, Operation op) {
   return result;
 }
 
+namespace detail {
+
+/// Implements ::binary_eval for two bitmaps of a word-aligned encoding by
+/// walking their block sequences directly. Instead of going through a
+/// ::bit_range and dropping bits one sequence at a time, the algorithm
+/// appends runs as a whole and processes stretches of literal words in
+/// tight loops.
+/// @tparam Cursor A type that walks the block sequence of a bitmap at word
+///                granularity, providing the following interface:
+///
+///     // The number of bits per word.
+///     static constexpr size_type width;
+///     // The number of clean words at the current position.
+///     size_type clean() const;
+///     // The value of the clean words.
+///     bool fill() const;
+///     // The number of consecutive literal words at the current position.
+///     size_type dirty() const;
+///     // A pointer to the first literal word at the current position.
+///     const block_type* literals() const;
+///     // Advances the cursor by *n* words of the current clean or dirty
+///     // stretch.
+///     void skip(size_type n);
+///
+/// @pre The literal words of *lhs* and *rhs* have no bits set beyond the
+///      word width.
+template <bool FillLHS, bool FillRHS, class Cursor, class Bitmap,
+          class Operation>
+Bitmap word_eval(const Bitmap& lhs, const Bitmap& rhs, Operation op) {
+  using block_type = typename Bitmap::block_type;
+  using size_type = typename Bitmap::size_type;
+  using word_type = typename Bitmap::word_type;
+  constexpr size_type width = Cursor::width;
+  constexpr auto mask = word_type::lsb_fill(width);
+  constexpr size_type buffer_size = 64;
+  Bitmap result;
+  Cursor l{lhs};
+  Cursor r{rhs};
+  auto fill_word = [](bool bit) {
+    return bit ? word_type::all : word_type::none;
+  };
+  // Evaluates *op* with a clean word on one side over *n* literal words.
+  auto eval_clean = [&](bool bit, const block_type* xs, size_type n, auto f) {
+    auto c = fill_word(bit);
+    auto on_none = f(c, word_type::none) & mask;
+    auto on_all = f(c, word_type::all) & mask;
+    if (on_none == on_all) {
+      // The clean side determines the result, e.g., x & 0.
+      result.append_bits(on_all != 0, n * width);
+    } else if (on_none == 0) {
+      // The clean side is the identity, e.g., x & 1.
+      for (auto i = 0u; i < n; ++i)
+        result.append_block(xs[i], width);
+    } else {
+      block_type buffer[buffer_size];
+      while (n > 0) {
+        auto k = std::min(n, buffer_size);
+        for (auto i = 0u; i < k; ++i)
+          buffer[i] = f(c, xs[i]);
+        for (auto i = 0u; i < k; ++i)
+          result.append_block(buffer[i], width);
+        xs += k;
+        n -= k;
+      }
+    }
+  };
+  // Process all words that both bitmaps cover completely.
+  auto common = std::min(lhs.size(), rhs.size());
+  auto n = common / width;
+  while (n > 0) {
+    if (l.clean() > 0 && r.clean() > 0) {
+      auto k = std::min({l.clean(), r.clean(), n});
+      auto data = op(fill_word(l.fill()), fill_word(r.fill())) & mask;
+      result.append_bits(data != 0, k * width);
+      l.skip(k);
+      r.skip(k);
+      n -= k;
+    } else if (l.clean() > 0) {
+      auto k = std::min({l.clean(), r.dirty(), n});
+      VAST_ASSERT(k > 0);
+      eval_clean(l.fill(), r.literals(), k,
+                 [&](auto x, auto y) { return op(x, y); });
+      l.skip(k);
+      r.skip(k);
+      n -= k;
+    } else if (r.clean() > 0) {
+      auto k = std::min({l.dirty(), r.clean(), n});
+      VAST_ASSERT(k > 0);
+      eval_clean(r.fill(), l.literals(), k,
+                 [&](auto x, auto y) { return op(y, x); });
+      l.skip(k);
+      r.skip(k);
+      n -= k;
+    } else {
+      auto k = std::min({l.dirty(), r.dirty(), n});
+      VAST_ASSERT(k > 0);
+      auto xs = l.literals();
+      auto ys = r.literals();
+      l.skip(k);
+      r.skip(k);
+      n -= k;
+      block_type buffer[buffer_size];
+      while (k > 0) {
+        auto m = std::min(k, buffer_size);
+        for (auto i = 0u; i < m; ++i)
+          buffer[i] = op(xs[i], ys[i]);
+        for (auto i = 0u; i < m; ++i)
+          result.append_block(buffer[i], width);
+        xs += m;
+        ys += m;
+        k -= m;
+      }
+    }
+  }
+  // Fill the remaining bits, either with zeros or with the longer bitmap.
+  auto max_size = std::max(lhs.size(), rhs.size());
+  auto lhs_longer = lhs.size() > rhs.size();
+  auto fill = lhs_longer ? FillLHS : (FillRHS && rhs.size() > lhs.size());
+  auto& longer = lhs_longer ? l : r;
+  auto next_word = [&](Cursor& c) {
+    auto x = c.clean() > 0 ? fill_word(c.fill()) : *c.literals();
+    c.skip(1);
+    return x;
+  };
+  // Evaluate the word that contains the end of the shorter bitmap.
+  if (auto partial = common % width; partial > 0) {
+    auto x = next_word(l);
+    auto y = next_word(r);
+    auto bits = std::min(width, max_size - result.size());
+    auto data = op(x, y) & word_type::lsb_mask(partial);
+    if (fill)
+      data |= (lhs_longer ? x : y) & ~word_type::lsb_mask(partial);
+    result.append_block(data, bits);
+  }
+  if (fill) {
+    while (result.size() < max_size) {
+      if (longer.clean() > 0) {
+        result.append_bits(longer.fill(), longer.clean() * width);
+        longer.skip(longer.clean());
+      } else {
+        auto k = longer.dirty();
+        VAST_ASSERT(k > 0);
+        auto xs = longer.literals();
+        for (auto i = 0u; i < k && result.size() < max_size; ++i)
+          result.append_block(xs[i], std::min(width, max_size - result.size()));
+        longer.skip(k);
+      }
+    }
+  }
+  VAST_ASSERT(max_size >= result.size());
+  result.append_bits(false, max_size - result.size());
+  return result;
+}
+
+} // namespace detail
+
 /// Evaluates a binary operation over multiple bitmaps.
 /// @param begin The beginning of the bitmap range.
 /// @param end The end of the bitmap range.
@@ -180,6 +338,138 @@ auto nary_eval(Iterator begin, Iterator end, Operation op) {
   return bitmap_type{};
 }
 
+/// Evaluates an AND or OR over multiple bitmaps in a single pass. The
+/// algorithm merges the bit sequences of all bitmaps with a heap that orders
+/// them by the position of their next segment that can affect the result.
+/// Runs of the neutral element of the operation (0 for OR, 1 for AND) never
+/// enter the evaluation, and a run of the dominant element skips all other
+/// bitmaps past its end. The evaluation needs no intermediate bitmaps.
+/// @tparam Dominant The bit value that alone determines the result at a
+///                  given position, i.e., `true` for OR and `false` for AND.
+/// @param begin The beginning of the bitmap range.
+/// @param end The end of the bitmap range.
+/// @returns The application of the operation over the bitmaps *[begin,end)*.
+/// @note Consistent with ::binary_and and ::binary_or, the result has the
+///       size of the longest bitmap, whose bits past the end of a shorter
+///       bitmap count as 0.
+template <bool Dominant, class Iterator>
+auto multiway_eval(Iterator begin, Iterator end) {
+  using bitmap_type = std::decay_t<decltype(*begin)>;
+  using range_type = decltype(bit_range(*begin));
+  using bits_type = typename bitmap_type::bits_type;
+  using size_type = typename bitmap_type::size_type;
+  using word_type = typename bitmap_type::word_type;
+  // The position of the current segment in a bitmap and its remaining bits.
+  struct cursor {
+    range_type range;
+    bits_type bits;
+    size_type position;
+  };
+  std::vector<cursor> cursors;
+  auto min_size = std::numeric_limits<size_type>::max();
+  auto max_size = size_type{0};
+  for (; begin != end; ++begin) {
+    auto rng = bit_range(*begin);
+    auto first = rng.done() ? bits_type{} : rng.get();
+    cursors.push_back({std::move(rng), first, 0});
+    min_size = std::min(min_size, begin->size());
+    max_size = std::max(max_size, begin->size());
+  }
+  bitmap_type result;
+  if (cursors.empty())
+    return result;
+  // Past the end of the shortest bitmap, an AND yields only zeros.
+  auto limit = Dominant ? max_size : min_size;
+  auto is_homogeneous = [](const bits_type& x) {
+    return x.is_run() || x.homogeneous();
+  };
+  auto is_neutral = [&](const bits_type& x) {
+    return is_homogeneous(x) && x[0] != Dominant;
+  };
+  // Moves a cursor to the next segment.
+  auto next = [](cursor& c) {
+    c.position += c.bits.size();
+    c.range.next();
+    c.bits = c.range.done() ? bits_type{} : c.range.get();
+  };
+  // Moves a cursor to the first segment at or after *target* that is not
+  // neutral.
+  auto advance = [&](cursor& c, size_type target) {
+    while (!c.bits.empty() && c.position + c.bits.size() <= target)
+      next(c);
+    if (!c.bits.empty() && c.position < target) {
+      c.bits = drop(c.bits, target - c.position);
+      c.position = target;
+    }
+    while (!c.bits.empty() && is_neutral(c.bits))
+      next(c);
+  };
+  using entry = std::pair<size_type, size_t>;
+  std::priority_queue<entry, std::vector<entry>, std::greater<entry>> queue;
+  auto enqueue = [&](size_t i) {
+    if (!cursors[i].bits.empty())
+      queue.emplace(cursors[i].position, i);
+  };
+  for (auto i = 0u; i < cursors.size(); ++i) {
+    advance(cursors[i], 0);
+    enqueue(i);
+  }
+  std::vector<size_t> active;
+  auto position = size_type{0};
+  while (!queue.empty() && queue.top().first < limit) {
+    // Everything up to the next relevant segment is neutral.
+    if (queue.top().first > position) {
+      result.append_bits(!Dominant, queue.top().first - position);
+      position = queue.top().first;
+    }
+    active.clear();
+    while (!queue.empty() && queue.top().first == position) {
+      active.push_back(queue.top().second);
+      queue.pop();
+    }
+    auto run_end = position;
+    for (auto i : active)
+      if (is_homogeneous(cursors[i].bits))
+        run_end = std::max(run_end, position + cursors[i].bits.size());
+    if (run_end > position) {
+      // A run of the dominant bit makes all segments before its end
+      // irrelevant.
+      run_end = std::min(run_end, limit);
+      while (!queue.empty() && queue.top().first < run_end) {
+        active.push_back(queue.top().second);
+        queue.pop();
+      }
+      result.append_bits(Dominant, run_end - position);
+      position = run_end;
+    } else {
+      // Only literal segments start here. We combine them up to the end of
+      // the shortest one or the start of the next segment.
+      auto n = limit - position;
+      for (auto i : active)
+        n = std::min(n, cursors[i].bits.size());
+      if (!queue.empty())
+        n = std::min(n, queue.top().first - position);
+      auto block = Dominant ? word_type::none : word_type::all;
+      for (auto i : active) {
+        if constexpr (Dominant)
+          block |= cursors[i].bits.data();
+        else
+          block &= cursors[i].bits.data();
+      }
+      result.append_block(block, n);
+      position += n;
+    }
+    for (auto i : active) {
+      advance(cursors[i], position);
+      enqueue(i);
+    }
+  }
+  VAST_ASSERT(position <= limit);
+  result.append_bits(!Dominant, limit - position);
+  result.append_bits(false, max_size - limit);
+  return result;
+}
+
 template <class LHS, class RHS>
 auto binary_and(const LHS& lhs, const RHS& rhs) {
   auto op = [](auto x, auto y) { return x & y; };
@@ -212,14 +502,12 @@ auto binary_nor(const LHS& lhs, const RHS& rhs) {
 
 template <class Iterator>
 auto nary_and(Iterator begin, Iterator end) {
-  auto op = [](auto x, auto y) { return x & y; };
-  return nary_eval(begin, end, op);
+  return multiway_eval<false>(begin, end);
 }
 
 template <class Iterator>
 auto nary_or(Iterator begin, Iterator end) {
-  auto op = [](auto x, auto y) { return x | y; };
-  return nary_eval(begin, end, op);
+  return multiway_eval<true>(begin, end);
 }
 
 template <class Iterator>
@@ -0,0 +1,90 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "vast/optional.hpp"
+#include "vast/synopsis.hpp"
+
+namespace vast {
+
+/// A synopsis that tracks set membership with a Bloom filter. It supports
+/// equality and membership lookups for strings, addresses, and subnets.
+/// Lookups with other operators or values of unsupported types always
+/// succeed, because the filter cannot rule them out.
+class bloom_filter_synopsis final : public synopsis {
+public:
+  /// The default number of distinct values a filter gets sized for. At the
+  /// default false-positive rate, a filter occupies about 5 KiB.
+  static constexpr size_t default_capacity = 4096;
+
+  /// The default false-positive probability at full capacity.
+  static constexpr double default_false_positive_rate = 0.01;
+
+  /// Constructs a Bloom filter synopsis.
+  /// @param x The type the synopsis should act for.
+  /// @param capacity The number of distinct values to size the filter for.
+  /// @param fp_rate The false-positive probability at full *capacity*.
+  /// @pre `capacity > 0 && fp_rate > 0 && fp_rate < 1`
+  bloom_filter_synopsis(vast::type x, size_t capacity = global_capacity(),
+                        double fp_rate = default_false_positive_rate);
+
+  /// @returns the number of distinct values a filter gets sized for, unless
+  ///          its type specifies otherwise.
+  static size_t global_capacity();
+
+  /// Changes the number of distinct values a filter gets sized for, unless
+  /// its type specifies otherwise. The setting applies process-wide and
+  /// affects only filters constructed afterwards.
+  /// @param n The number of distinct values.
+  /// @returns `false` if *n* is 0.
+  static bool global_capacity(size_t n);
+
+  void add(data_view x) override;
+
+  void add_column(const table_slice& slice, size_t col) override;
+
+  bool lookup(relational_operator op, data_view rhs) const override;
+
+  bool equals(const synopsis& other) const noexcept override;
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+  /// @returns the number of bits in the filter.
+  size_t num_bits() const noexcept;
+
+  /// @returns the number of hash functions.
+  size_t num_hashes() const noexcept;
+
+  /// Computes the digest of a value, if the filter supports its type.
+  /// @param x The value to hash.
+  /// @returns the 64-bit digest of *x* or `nullopt` for unsupported types.
+  static optional<uint64_t> digest(data_view x);
+
+private:
+  void insert(uint64_t digest);
+
+  bool contains(uint64_t digest) const;
+
+  size_t num_hashes_;
+  std::vector<uint64_t> bits_;
+};
+
+} // namespace vast
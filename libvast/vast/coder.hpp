@@ -19,8 +19,13 @@
 #include <vector>
 #include <type_traits>
 
+#include <caf/deserializer.hpp>
 #include <caf/meta/load_callback.hpp>
 #include <caf/meta/save_callback.hpp>
+#include <caf/serializer.hpp>
+#include <caf/stream_deserializer.hpp>
+#include <caf/stream_serializer.hpp>
+#include <caf/streambuf.hpp>
 
 #include "vast/base.hpp"
 #include "vast/operator.hpp"
@@ -150,6 +155,10 @@ private:
   Bitmap bitmap_;
 };
 
+/// The base class for coders with a fixed number of bitmaps. A coder loaded
+/// from disk keeps its bitmaps in serialized form and decodes each one only
+/// when an operation first accesses it, so that lookups on persisted indexes
+/// pay only for the bitmaps they touch.
 template <class Bitmap>
 class vector_coder : detail::equality_comparable<vector_coder<Bitmap>> {
 public:
@@ -169,26 +178,132 @@ public:
     return bitmaps_.size();
   }
 
+  /// @returns the number of bitmaps that no operation accessed since loading
+  ///          the coder, which therefore remain in serialized form.
+  size_t serialized_count() const noexcept {
+    auto pred = [](auto& bytes) { return !bytes.empty(); };
+    return std::count_if(frozen_.begin(), frozen_.end(), pred);
+  }
+
   auto size() const {
     return size_;
   }
 
   auto& storage() const {
+    thaw_all();
     return bitmaps_;
   }
 
   friend bool operator==(const vector_coder& x, const vector_coder& y) {
+    x.thaw_all();
+    y.thaw_all();
     return x.size_ == y.size_ && x.bitmaps_ == y.bitmaps_;
   }
 
   template <class Inspector>
   friend auto inspect(Inspector& f, vector_coder& ec) {
-    return f(ec.size_, ec.bitmaps_);
+    using result_type = typename Inspector::result_type;
+    // Coders of earlier versions start with their size, which never equals
+    // the marker, followed by their bitmaps. Later versions write each
+    // bitmap as a sequence of bytes, which loading the coder keeps as is.
+    if constexpr (std::is_base_of_v<caf::serializer, Inspector>) {
+      auto marker = frozen_marker;
+      uint64_t n = ec.bitmaps_.size();
+      if (auto err = f(marker, ec.size_, n))
+        return err;
+      std::vector<char> buf;
+      for (size_t i = 0; i < n; ++i) {
+        auto* bytes = &buf;
+        if (ec.is_frozen(i)) {
+          bytes = &ec.frozen_[i];
+        } else {
+          buf.clear();
+          caf::containerbuf<std::vector<char>> sink{buf};
+          caf::stream_serializer<caf::containerbuf<std::vector<char>>&> s{
+            nullptr, sink};
+          if (auto err = s(ec.bitmaps_[i]))
+            return err;
+        }
+        uint64_t length = bytes->size();
+        if (auto err = f(length))
+          return err;
+        if (auto err = f.apply_raw(bytes->size(), bytes->data()))
+          return err;
+      }
+      return result_type{};
+    } else if constexpr (std::is_base_of_v<caf::deserializer, Inspector>) {
+      size_type first;
+      if (auto err = f(first))
+        return err;
+      ec.frozen_.clear();
+      if (first != frozen_marker) {
+        ec.size_ = first;
+        return f(ec.bitmaps_);
+      }
+      uint64_t n;
+      if (auto err = f(ec.size_, n))
+        return err;
+      ec.bitmaps_.assign(n, Bitmap{});
+      ec.frozen_.resize(n);
+      for (auto& bytes : ec.frozen_) {
+        uint64_t length;
+        if (auto err = f(length))
+          return err;
+        bytes.resize(length);
+        if (auto err = f.apply_raw(bytes.size(), bytes.data()))
+          return err;
+      }
+      return result_type{};
+    } else {
+      ec.thaw_all();
+      return f(ec.size_, ec.bitmaps_);
+    }
   }
 
 protected:
+  static constexpr size_type frozen_marker
+    = std::numeric_limits<size_type>::max();
+
+  bool is_frozen(size_t index) const {
+    return !frozen_.empty() && !frozen_[index].empty();
+  }
+
+  /// Decodes a bitmap unless an operation accessed it before.
+  /// @param index The index of the bitmap.
+  /// @returns the bitmap at *index*.
+  Bitmap& thaw(size_t index) const {
+    VAST_ASSERT(index < bitmaps_.size());
+    if (is_frozen(index)) {
+      auto& bytes = frozen_[index];
+      caf::charbuf source{bytes.data(), bytes.size()};
+      caf::stream_deserializer<caf::charbuf&> d{nullptr, source};
+      // Loading the coder read the bytes back exactly as we wrote them.
+      auto err = d(bitmaps_[index]);
+      VAST_ASSERT(!err);
+      std::vector<char>{}.swap(bytes);
+    }
+    return bitmaps_[index];
+  }
+
+  /// Decodes the bitmaps in a range unless an operation accessed them before.
+  /// @param first The index of the first bitmap.
+  /// @param last The index one past the last bitmap.
+  void thaw(size_t first, size_t last) const {
+    for (auto i = first; i < last; ++i)
+      thaw(i);
+  }
+
+  /// Decodes all bitmaps that remain in serialized form.
+  void thaw_all() const {
+    for (size_t i = 0; i < frozen_.size(); ++i)
+      thaw(i);
+    frozen_.clear();
+  }
+
   void append(const vector_coder& other, bool bit) {
     VAST_ASSERT(bitmaps_.size() == other.bitmaps_.size());
+    thaw_all();
+    other.thaw_all();
     for (auto i = 0u; i < bitmaps_.size(); ++i) {
       bitmaps_[i].append_bits(bit, this->size() - bitmaps_[i].size());
       bitmaps_[i].append(other.bitmaps_[i]);
@@ -198,6 +313,11 @@ protected:
 
   size_type size_;
   mutable std::vector<Bitmap> bitmaps_;
+
+  /// The serialized form of each bitmap that no operation accessed since
+  /// loading the coder, or an empty sequence of bytes otherwise. Empty for
+  /// coders that did not get loaded in serialized form.
+  mutable std::vector<std::vector<char>> frozen_;
 };
 
 /// Encodes each value in its own bitmap.
@@ -213,7 +333,7 @@ public:
   using super::super;
 
   bitmap_type& lazy_bitmap_at(size_t index) const {
-    auto& result = this->bitmaps_[index];
+    auto& result = this->thaw(index);
     result.append_bits(false, this->size_ - result.size());
     return result;
   }
@@ -243,12 +363,14 @@ public:
       case less: {
         if (x == 0)
           return Bitmap{this->size_, false};
+        this->thaw(0, x);
         auto f = this->bitmaps_.begin();
         auto result = nary_or(f, f + x);
         result.append_bits(false, this->size_ - result.size());
         return result;
       }
       case less_equal: {
+        this->thaw(0, x + 1);
         auto f = this->bitmaps_.begin();
         auto result = nary_or(f, f + x + 1);
         result.append_bits(false, this->size_ - result.size());
@@ -262,6 +384,7 @@ public:
         return result;
       }
       case greater_equal: {
+        this->thaw(x, this->bitmaps_.size());
         auto result = nary_or(this->bitmaps_.begin() + x, this->bitmaps_.end());
         result.append_bits(false, this->size_ - result.size());
         return result;
@@ -269,6 +392,7 @@ public:
       case greater: {
         if (x >= this->bitmaps_.size() - 1)
           return Bitmap{this->size_, false};
+        this->thaw(x + 1, this->bitmaps_.size());
         auto f = this->bitmaps_.begin();
         auto l = this->bitmaps_.end();
         auto result = nary_or(f + x + 1, l);
@@ -301,7 +425,7 @@ public:
   using super::super;
 
   bitmap_type& lazy_bitmap_at(size_t index) const {
-    auto& result = this->bitmaps_[index];
+    auto& result = this->thaw(index);
     result.append_bits(true, this->size_ - result.size());
     return result;
   }
@@ -387,7 +511,7 @@ public:
   using super::super;
 
   bitmap_type& lazy_bitmap_at(size_t index) const {
-    auto& result = this->bitmaps_[index];
+    auto& result = this->thaw(index);
     result.append_bits(false, this->size_ - result.size());
     return result;
   }
@@ -424,12 +548,12 @@ public:
         } else if (op == less || op == greater_equal) {
           --x;
         }
-        auto result = x & 1 ? Bitmap{this->size_, true} : this->bitmaps_[0];
+        auto result = x & 1 ? Bitmap{this->size_, true} : this->thaw(0);
         for (auto i = 1u; i < this->bitmaps_.size(); ++i)
           if ((x >> i) & 1)
-            result |= this->bitmaps_[i];
+            result |= this->thaw(i);
           else
-            result &= this->bitmaps_[i];
+            result &= this->thaw(i);
         if (op == greater || op == greater_equal || op == not_equal)
           result.flip();
         return result;
@@ -438,7 +562,7 @@ public:
       case not_equal: {
         auto result = Bitmap{this->size_, true};
         for (auto i = 0u; i < this->bitmaps_.size(); ++i) {
-          auto& bm = this->bitmaps_[i];
+          auto& bm = this->thaw(i);
           result &= (((x >> i) & 1) ? ~bm : bm);
         }
         if (op == not_equal)
@@ -453,7 +577,7 @@ public:
         auto result = Bitmap{this->size_, false};
         for (auto i = 0u; i < this->bitmaps_.size(); ++i)
           if (((x >> i) & 1) == 0)
-            result |= this->bitmaps_[i];
+            result |= this->thaw(i);
         if (op == in)
           result.flip();
         return result;
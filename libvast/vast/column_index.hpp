@@ -14,6 +14,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <caf/expected.hpp>
 #include <caf/fwd.hpp>
@@ -22,6 +23,7 @@
 #include "vast/event.hpp"
 #include "vast/expression.hpp"
 #include "vast/filesystem.hpp"
+#include "vast/journal.hpp"
 #include "vast/type.hpp"
 #include "vast/value_index.hpp"
 
@@ -48,12 +50,16 @@ public:
 
   // -- persistence ------------------------------------------------------------
 
-  /// Materializes the index from disk if `filename()` exists, constructs a new
-  /// one otherwise. Automatically called by the factory functions.
+  /// Loads the index from disk if `filename()` exists, constructs a new one
+  /// otherwise. The coders of a loaded index decode their bitmaps only when a
+  /// lookup or append first accesses them. Automatically called by the
+  /// factory functions.
   /// @returns An error if I/O operations fail.
   caf::error init();
 
-  /// Persists the index to disk.
+  /// Persists the index to disk. Commits the column values that ::add logged
+  /// since the last flush, unless the log has outgrown the serialized index,
+  /// in which case the index gets written in full.
   caf::error flush_to_disk();
 
   // -- properties -------------------------------------------------------------
@@ -74,7 +80,8 @@ public:
   /// Serializes or deserializes a column index.
   template <class Inspector>
   friend typename Inspector::result_type inspect(Inspector& f, column_index& x) {
-    detail::value_index_inspect_helper tmp{x.index_type_, x.idx_};
+    detail::value_index_inspect_helper tmp{x.index_type_, x.idx_,
+                                           x.version_};
     return f(x.index_type_, x.filename_, tmp, f.last_flush_);
   }
 
@@ -97,16 +104,29 @@ public:
 protected:
   // -- constructors, destructors, and assignment operators --------------------
 
-  column_index(caf::actor_system& sys, type index_type, path filename);
+  column_index(caf::actor_system& sys, type index_type, path filename,
+               size_t column);
 
   // -- member variables -------------------------------------------------------
 
   bool has_skip_attribute_;
   type index_type_;
   path filename_;
+  size_t column_;
   std::unique_ptr<value_index> idx_;
   value_index::size_type last_flush_ = 0;
+
+  /// The version of the mapping from types to value indexes. Indexes loaded
+  /// from disk retain the version they were written with.
+  uint32_t version_ = value_index::current_version;
   caf::actor_system& sys_;
+
+  /// Whether ::add logs the new rows. Otherwise, the next flush writes the
+  /// index in full.
+  bool logging_ = true;
+
+  /// Persists the value index and the column values since the last snapshot.
+  journal journal_;
 };
 
 // -- related types ------------------------------------------------------------
@@ -0,0 +1,145 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <caf/variant.hpp>
+
+#include "vast/address.hpp"
+#include "vast/aliases.hpp"
+#include "vast/bitvector.hpp"
+#include "vast/data.hpp"
+#include "vast/fwd.hpp"
+#include "vast/port.hpp"
+#include "vast/subnet.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/time.hpp"
+
+namespace vast {
+
+/// A table slice that stores its data column-wise. Fixed-width types live in
+/// contiguous arrays, strings in a single blob with an offset table, and all
+/// remaining types fall back to a vector of data. Each column carries a
+/// validity bitmap to represent null values.
+class columnar_table_slice final : public table_slice {
+public:
+  // -- friends ----------------------------------------------------------------
+
+  friend columnar_table_slice_builder;
+
+  // -- member types -----------------------------------------------------------
+
+  /// A bitmap with one bit per row.
+  using bitmap_type = bitvector<uint64_t>;
+
+  /// Storage for a column of strings. The value in row *i* occupies the bytes
+  /// `[offsets[i], offsets[i + 1])` in `blob`.
+  struct string_column {
+    std::vector<uint64_t> offsets = {0};
+    std::string blob;
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, string_column& x) {
+      return f(x.offsets, x.blob);
+    }
+  };
+
+  /// Type-specialized storage for the values of a column.
+  using column_values = caf::variant<
+    vector,
+    bitmap_type,
+    std::vector<integer>,
+    std::vector<count>,
+    std::vector<real>,
+    std::vector<timespan>,
+    std::vector<timestamp>,
+    std::vector<port>,
+    std::vector<address>,
+    std::vector<subnet>,
+    string_column
+  >;
+
+  /// Whether the slice stores values of type `T` in a contiguous array.
+  template <class T>
+  static constexpr bool is_fixed_width = std::is_same_v<T, integer>
+                                         || std::is_same_v<T, count>
+                                         || std::is_same_v<T, real>
+                                         || std::is_same_v<T, timespan>
+                                         || std::is_same_v<T, timestamp>;
+
+  /// A single column of the slice.
+  struct column {
+    /// The values of all rows. Null rows hold a default-constructed value.
+    column_values values;
+
+    /// Has bit *i* set if and only if row *i* is not null.
+    bitmap_type valid;
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, column& x) {
+      return f(x.values, x.valid);
+    }
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  columnar_table_slice(const columnar_table_slice&) = default;
+
+  explicit columnar_table_slice(record_type layout);
+
+  // -- factory functions ------------------------------------------------------
+
+  columnar_table_slice* copy() const final;
+
+  // -- persistence ------------------------------------------------------------
+
+  caf::error serialize(caf::serializer& sink) const final;
+
+  caf::error deserialize(caf::deserializer& source) final;
+
+  // -- static factory functions -----------------------------------------------
+
+  /// Constructs a builder that generates a columnar_table_slice.
+  /// @param layout The layout of the table_slice.
+  /// @returns The builder instance.
+  static table_slice_builder_ptr make_builder(record_type layout);
+
+  // -- properties -------------------------------------------------------------
+
+  data_view at(size_type row, size_type col) const final;
+
+  caf::atom_value implementation_id() const noexcept final;
+
+  /// @returns the storage of column *col*.
+  /// @pre `col < columns()`
+  const column& column_at(size_type col) const noexcept {
+    VAST_ASSERT(col < xs_.size());
+    return xs_[col];
+  }
+
+private:
+  // -- member variables -------------------------------------------------------
+
+  std::vector<column> xs_;
+};
+
+/// @relates columnar_table_slice
+using columnar_table_slice_ptr = caf::intrusive_cow_ptr<columnar_table_slice>;
+
+} // namespace vast
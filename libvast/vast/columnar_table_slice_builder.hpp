@@ -0,0 +1,59 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <memory>
+
+#include "vast/columnar_table_slice.hpp"
+#include "vast/table_slice_builder.hpp"
+
+namespace vast {
+
+/// Builds a `columnar_table_slice` by appending values column by column to
+/// type-specialized storage.
+class columnar_table_slice_builder final : public table_slice_builder {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using super = table_slice_builder;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  columnar_table_slice_builder(record_type layout);
+
+  // -- properties -------------------------------------------------------------
+
+  bool add(data_view x) final;
+
+  table_slice_ptr finish() final;
+
+  size_t rows() const noexcept final;
+
+  void reserve(size_t num_rows) final;
+
+private:
+  // -- utility functions ------------------------------------------------------
+
+  /// Allocates `slice_` and resets related state if necessary.
+  void lazy_init();
+
+  // -- member variables -------------------------------------------------------
+
+  size_t col_;
+  size_t rows_;
+  std::unique_ptr<columnar_table_slice> slice_;
+};
+
+} // namespace vast
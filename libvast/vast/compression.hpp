@@ -29,6 +29,24 @@ enum class compression : int8_t {
 #endif
 };
 
+/// @returns an upper bound for the compressed output.
+/// @param method The compression algorithm.
+/// @param size The size of the uncompressed input.
+size_t compress_bound(compression method, size_t size);
+
+/// Compresses a contiguous byte sequence.
+/// @param method The compression algorithm.
+/// @returns The number of bytes written to *out* or 0 on failure.
+/// @pre `out_size >= compress_bound(method, in_size)`
+size_t compress(compression method, const char* in, size_t in_size, char* out,
+                size_t out_size);
+
+/// Uncompresses a contiguous byte sequence.
+/// @param method The compression algorithm.
+/// @returns The number of bytes written to *out* or 0 on failure.
+size_t uncompress(compression method, const char* in, size_t in_size,
+                  char* out, size_t out_size);
+
 /// The LZ4 compression algorithm.
 namespace lz4 {
 
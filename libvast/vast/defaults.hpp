@@ -17,6 +17,8 @@
 #include <cstdint>
 #include <string>
 
+#include <caf/atom.hpp>
+
 namespace vast::defaults {
 
 namespace command {
@@ -74,9 +76,27 @@ namespace system {
 /// Maximum size for sources that generate table slices.
 extern size_t table_slice_size;
 
+/// Implementation ID of the table slices that sources generate.
+extern caf::atom_value table_slice_type;
+
 /// Maximum number of events per index partition.
 extern size_t max_partition_size;
 
+/// Number of workers that load segments for the archive.
+extern size_t archive_workers;
+
+/// Number of threads that index columns in parallel for all INDEXER actors.
+extern size_t indexer_workers;
+
+/// Concrete type of the bitmaps that the index creates.
+extern caf::atom_value bitmap_type;
+
+/// Memory budget in bytes for the partitions that the index caches.
+extern size_t partition_cache_size;
+
+/// Number of distinct values that Bloom filter synopses get sized for.
+extern size_t bloom_filter_capacity;
+
 } // namespace system
 
 } // namespace vast::defaults
@@ -0,0 +1,143 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+namespace vast::detail {
+
+/// A static interval tree over closed intervals `[lo, hi]` that answers
+/// stabbing queries in *O((k + 1) log n)* for *k* results, and queries for
+/// intervals starting before or ending after a point in *O(k)*. The tree
+/// stores its nodes implicitly in an array sorted by left endpoint, where the
+/// middle element of each subrange is the root of the subtree for that range.
+/// Every node tracks the maximum right endpoint of its subtree.
+template <class Point, class Value>
+class interval_tree {
+public:
+  struct interval {
+    Point lo;
+    Point hi;
+    Value value;
+  };
+
+  interval_tree() = default;
+
+  /// Constructs the tree from a set of intervals.
+  /// @param xs The intervals.
+  /// @pre `lo <= hi` for all intervals in *xs*.
+  explicit interval_tree(std::vector<interval> xs) : intervals_{std::move(xs)} {
+    auto by_lo = [](auto& x, auto& y) { return x.lo < y.lo; };
+    std::sort(intervals_.begin(), intervals_.end(), by_lo);
+    max_hi_.resize(intervals_.size());
+    if (!intervals_.empty())
+      build(0, intervals_.size());
+    by_hi_.resize(intervals_.size());
+    std::iota(by_hi_.begin(), by_hi_.end(), size_t{0});
+    std::sort(by_hi_.begin(), by_hi_.end(), [&](size_t i, size_t j) {
+      return intervals_[i].hi < intervals_[j].hi;
+    });
+  }
+
+  /// @returns the number of intervals in the tree.
+  size_t size() const noexcept {
+    return intervals_.size();
+  }
+
+  /// @returns `true` iff the tree contains no intervals.
+  bool empty() const noexcept {
+    return intervals_.empty();
+  }
+
+  /// Visits all intervals that contain a point.
+  /// @param x The point.
+  /// @param f The function to invoke with the value of each interval.
+  template <class F>
+  void stab(const Point& x, F f) const {
+    if (!intervals_.empty())
+      stab(0, intervals_.size(), x, f);
+  }
+
+  /// Visits all intervals whose left endpoint is less than a point.
+  /// @param x The point.
+  /// @param inclusive Whether to include intervals starting at *x*.
+  /// @param f The function to invoke with the value of each interval.
+  template <class F>
+  void starting_before(const Point& x, bool inclusive, F f) const {
+    for (auto& i : intervals_) {
+      if (inclusive ? x < i.lo : !(i.lo < x))
+        break;
+      f(i.value);
+    }
+  }
+
+  /// Visits all intervals whose right endpoint is greater than a point.
+  /// @param x The point.
+  /// @param inclusive Whether to include intervals ending at *x*.
+  /// @param f The function to invoke with the value of each interval.
+  template <class F>
+  void ending_after(const Point& x, bool inclusive, F f) const {
+    for (auto i = by_hi_.rbegin(); i != by_hi_.rend(); ++i) {
+      auto& hi = intervals_[*i].hi;
+      if (inclusive ? hi < x : !(x < hi))
+        break;
+      f(intervals_[*i].value);
+    }
+  }
+
+private:
+  const Point& build(size_t first, size_t last) {
+    auto mid = first + (last - first) / 2;
+    const Point* result = &intervals_[mid].hi;
+    if (first < mid) {
+      auto& x = build(first, mid);
+      if (*result < x)
+        result = &x;
+    }
+    if (mid + 1 < last) {
+      auto& x = build(mid + 1, last);
+      if (*result < x)
+        result = &x;
+    }
+    max_hi_[mid] = *result;
+    return *result;
+  }
+
+  template <class F>
+  void stab(size_t first, size_t last, const Point& x, F& f) const {
+    if (first >= last)
+      return;
+    auto mid = first + (last - first) / 2;
+    // No interval in this subtree reaches up to x.
+    if (max_hi_[mid] < x)
+      return;
+    stab(first, mid, x, f);
+    // All intervals from here on start after x.
+    if (x < intervals_[mid].lo)
+      return;
+    if (!(intervals_[mid].hi < x))
+      f(intervals_[mid].value);
+    stab(mid + 1, last, x, f);
+  }
+
+  std::vector<interval> intervals_;
+  std::vector<Point> max_hi_;
+  std::vector<size_t> by_hi_;
+};
+
+} // namespace vast::detail
@@ -310,13 +310,16 @@ public:
         return rval;
       }
       if (n->partial_len) {
-        auto prefix_len = prefix_mismatch(n, prefix, depth);
-        if (!prefix_len)
-          return rval;
-        if (depth + prefix_len == prefix.size()) {
-          recursive_add_leaves(n, rval);
+        // If the prefix ends within the compressed path, all leaves below
+        // share the prefix iff any of them does. Comparing only up to the end
+        // of the prefix keeps this correct for keys with NUL bytes.
+        if (prefix.size() - depth <= n->partial_len) {
+          if (prefix_matches(minimum(n)->key(), prefix))
+            recursive_add_leaves(n, rval);
           return rval;
         }
+        if (prefix_mismatch(n, prefix, depth) < n->partial_len)
+          return rval;
         // There is a full match, go deeper.
         depth += n->partial_len;
       }
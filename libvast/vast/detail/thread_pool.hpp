@@ -0,0 +1,70 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vast::detail {
+
+/// A fixed set of threads for fork-join parallelism outside of the actor
+/// scheduler. Multiple clients can share a pool concurrently.
+class thread_pool {
+public:
+  /// Spawns the threads of the pool.
+  /// @param num_threads The number of threads.
+  explicit thread_pool(size_t num_threads);
+
+  /// Joins all threads.
+  ~thread_pool();
+
+  thread_pool(const thread_pool&) = delete;
+
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  /// @returns the number of threads in the pool.
+  size_t size() const;
+
+  /// Calls `f(i)` for all `i` in `[0, n)` on the calling thread and the
+  /// threads of the pool. Each index is processed exactly once.
+  /// @param n The number of indexes.
+  /// @param f The function to call for each index.
+  /// @post All calls to *f* have returned.
+  /// @note Once all indexes are taken, the caller withdraws its helper tasks
+  ///       that have not started yet, so it never waits for other clients.
+  void parallel_for(size_t n, const std::function<void(size_t)>& f);
+
+private:
+  /// A queued helper of a `parallel_for` call.
+  struct task {
+    const void* owner;
+    std::function<void()> f;
+  };
+
+  void run();
+
+  std::vector<std::thread> threads_;
+  std::deque<task> tasks_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  bool done_ = false;
+};
+
+} // namespace vast::detail
@@ -0,0 +1,35 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/fwd.hpp"
+#include "vast/ids.hpp"
+
+namespace vast {
+
+/// Evaluates a [resolved](@ref type_extractor) expression over all rows of a
+/// table slice at once. Instead of visiting the expression for every row,
+/// this function evaluates each predicate for an entire column into a
+/// selection bitmap and combines the bitmaps of conjunctions, disjunctions,
+/// and negations with bitwise operations. For columnar table slices,
+/// comparisons of fixed-width values run as tight loops over the contiguous
+/// column storage.
+/// @param expr The expression tailored to the layout of *slice*.
+/// @param slice The table slice to evaluate.
+/// @returns The IDs of all rows in *slice* that satisfy *expr*.
+/// @relates table_slice
+ids evaluate(const expression& expr, const table_slice& slice);
+
+} // namespace vast
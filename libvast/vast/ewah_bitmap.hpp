@@ -160,6 +160,66 @@ private:
 
 ewah_bitmap_range bit_range(const ewah_bitmap& bm);
 
+/// Walks the blocks of an EWAH bitmap at word granularity. In contrast to
+/// ::ewah_bitmap_range, the cursor exposes stretches of dirty blocks in place
+/// so that algorithms can process them in bulk.
+/// @relates ewah_bitmap
+class ewah_bitmap_cursor {
+public:
+  using block_type = ewah_bitmap::block_type;
+  using size_type = ewah_bitmap::size_type;
+  using word_type = ewah_bitmap::word_type;
+
+  static constexpr size_type width = word_type::width;
+
+  explicit ewah_bitmap_cursor(const ewah_bitmap& bm);
+
+  /// @returns the number of clean words at the current position.
+  size_type clean() const {
+    return clean_;
+  }
+
+  /// @returns the value of the clean words at the current position.
+  bool fill() const {
+    return fill_;
+  }
+
+  /// @returns the number of dirty blocks at the current position.
+  size_type dirty() const {
+    return dirty_;
+  }
+
+  /// @returns a pointer to the first dirty block at the current position.
+  const block_type* literals() const {
+    return literals_;
+  }
+
+  /// Advances the cursor within the current clean or dirty stretch.
+  /// @param n The number of words to skip.
+  /// @pre `n <= clean()` or `clean() == 0 && n <= dirty()`
+  void skip(size_type n);
+
+private:
+  void scan();
+
+  const block_type* next_;
+  const block_type* end_;
+  const block_type* literals_ = nullptr;
+  size_type clean_ = 0;
+  size_type dirty_ = 0;
+  bool fill_ = false;
+};
+
+// -- algorithms ---------------------------------------------------------------
+
+/// Applies a bitwise operation on two EWAH bitmaps directly on their blocks.
+/// @relates ewah_bitmap
+template <bool FillLHS, bool FillRHS, class Operation>
+ewah_bitmap binary_eval(const ewah_bitmap& lhs, const ewah_bitmap& rhs,
+                        Operation op) {
+  return detail::word_eval<FillLHS, FillRHS, ewah_bitmap_cursor>(lhs, rhs, op);
+}
+
 } // namespace vast
 
 
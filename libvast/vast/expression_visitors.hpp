@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
 #include "vast/error.hpp"
@@ -24,6 +25,7 @@
 namespace vast {
 
 class event;
+class table_slice;
 
 /// Hoists the contained expression of a single-element conjunction or
 /// disjunction one level in the tree.
@@ -162,6 +164,45 @@ struct event_evaluator {
   relational_operator op_;
 };
 
+/// Evaluates a single row of a table slice over a [resolved](@ref
+/// type_extractor) expression. Unlike the ::event_evaluator, this visitor
+/// only accesses the columns that occur in the expression instead of
+/// materializing the entire row.
+struct table_slice_row_evaluator {
+  /// @param slice The table slice holding the row.
+  /// @param row The row to evaluate.
+  /// @param layout The event type of *slice*, i.e., its layout without the
+  ///               leading timestamp column.
+  /// @pre `row < slice.rows()`
+  table_slice_row_evaluator(const table_slice& slice, size_t row,
+                            const type& layout);
+
+  bool operator()(caf::none_t);
+  bool operator()(const conjunction& c);
+  bool operator()(const disjunction& d);
+  bool operator()(const negation& n);
+  bool operator()(const predicate& p);
+  bool operator()(const attribute_extractor& e, const data& d);
+  bool operator()(const key_extractor&, const data&);
+  bool operator()(const type_extractor&, const data&);
+  bool operator()(const data_extractor& e, const data& d);
+
+  template <class T>
+  bool operator()(const data& d, const T& x) {
+    return (*this)(x, d);
+  }
+
+  template <class T, class U>
+  bool operator()(const T&, const U&) {
+    return false;
+  }
+
+  const table_slice& slice_;
+  size_t row_;
+  const type& layout_;
+  relational_operator op_;
+};
+
 /// Checks whether a [resolved](@ref type_extractor) expression matches a given
 /// type. That is, this visitor tests whether an expression consists of a
 /// viable set of predicates for a type. For conjunctions, all operands must
@@ -313,6 +313,19 @@ void create_symlink(const path& target, const path& link);
 /// @returns `true` if *p* has been successfully deleted.
 bool rm(const path& p);
 
+/// Moves a file, replacing an existing file at the destination. On POSIX
+/// systems, the replacement happens atomically.
+/// @param from The path of the file to move.
+/// @param to The new path of the file.
+/// @returns `true` if *from* has been successfully moved to *to*.
+bool mv(const path& from, const path& to);
+
+/// Computes the number of bytes of a file or of all files in a directory,
+/// recursively.
+/// @param p The path to a file or directory.
+/// @returns The total size of all regular files in *p*.
+size_t disk_usage(const path& p);
+
 /// If the path does not exist, create it as directory.
 /// @param p The path to a directory to create.
 /// @returns `true` on success or if *p* exists already.
@@ -29,6 +29,15 @@ public:
   /// @returns `caf::none` on success.
   virtual caf::expected<void> write(const event& x)  = 0;
 
+  /// Processes a selection of rows of a table slice.
+  /// @param x The table slice to write.
+  /// @param rows The IDs of the rows to write.
+  /// @returns `caf::none` on success.
+  /// The default implementation converts the selected rows into events and
+  /// writes them one by one. Writers that can operate on table slices
+  /// directly should override this function.
+  virtual caf::expected<void> write(const table_slice& x, const ids& rows);
+
   /// Called periodically to flush state.
   /// @returns `caf::none` on success.
   /// The default implementation does nothing.
@@ -25,6 +25,8 @@ class address;
 class bitmap;
 class chunk;
 class column_index;
+class columnar_table_slice;
+class columnar_table_slice_builder;
 class data;
 class default_table_slice;
 class default_table_slice_builder;
@@ -84,6 +86,7 @@ table_slice* intrusive_cow_ptr_unshare(table_slice*&);
 
 using chunk_ptr = caf::intrusive_ptr<chunk>;
 using column_index_ptr = std::unique_ptr<column_index>;
+using columnar_table_slice_ptr = caf::intrusive_cow_ptr<columnar_table_slice>;
 using default_table_slice_ptr = caf::intrusive_cow_ptr<default_table_slice>;
 using synopsis_ptr = caf::intrusive_ptr<synopsis>;
 using table_slice_builder_ptr = caf::intrusive_ptr<table_slice_builder>;
@@ -41,5 +41,13 @@ struct id_range {
 ids make_ids(std::initializer_list<id_range> ranges, size_t min_size = 0,
              bool default_bit = false);
 
+/// Restricts an ID set to its first *n* IDs. For example,
+/// `take(make_ids({{10, 12}, {20, 22}}), 3)` will return an ID set containing
+/// 10, 11, and 20.
+/// @param xs The ID set to restrict.
+/// @param n The maximum number of IDs to keep.
+/// @returns The *n* smallest IDs in *xs*.
+ids take(const ids& xs, size_t n);
+
 } // namespace vast
 
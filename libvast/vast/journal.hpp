@@ -0,0 +1,164 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+#include <caf/error.hpp>
+#include <caf/fwd.hpp>
+
+#include "vast/filesystem.hpp"
+#include "vast/load.hpp"
+#include "vast/save.hpp"
+
+namespace vast {
+
+/// Persists state incrementally as a *snapshot* of the full state plus a
+/// *log* of records that describe the changes since the snapshot. Writers
+/// append records, which the journal buffers in serialized form, and write
+/// them to the log with ::commit.
+/// Occasionally, they replace snapshot and log with a new snapshot, which
+/// *compacts* the state.
+///
+/// A *manifest* next to the snapshot records the committed length of the log.
+/// Snapshot and manifest get replaced atomically by renaming a temporary
+/// file, and readers ignore everything in the log beyond the committed
+/// length. Every write gets flushed to disk with `fsync(2)` before the
+/// manifest references it, and every rename before the journal continues.
+/// Therefore, a crash or power loss at any point leaves the last committed
+/// state intact.
+///
+/// A crash during compaction can leave a new snapshot with the log of the
+/// previous one. Hence, readers must skip records that the snapshot already
+/// contains.
+class journal {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Constructs a journal.
+  /// @param sys The actor system for serialization.
+  /// @param filename The path of the snapshot. Log and manifest have the same
+  ///                 path with the extensions `.log` and `.manifest`.
+  journal(caf::actor_system& sys, path filename);
+
+  // -- properties -------------------------------------------------------------
+
+  /// @returns the path of the snapshot.
+  const path& filename() const {
+    return filename_;
+  }
+
+  /// @returns `true` if the journal has a snapshot on disk.
+  bool has_snapshot() const;
+
+  /// @returns the number of bytes of the snapshot.
+  uint64_t snapshot_size() const {
+    return snapshot_size_;
+  }
+
+  /// @returns the number of bytes of all records in the log, including
+  ///          uncommitted ones.
+  uint64_t log_size() const {
+    return log_size_ + pending_.size();
+  }
+
+  /// @returns `true` if the log has grown larger than the snapshot, at which
+  ///          point rewriting the snapshot costs less than reading the log.
+  bool needs_compaction() const {
+    return log_size() > snapshot_size_;
+  }
+
+  // -- persistence ------------------------------------------------------------
+
+  /// Reads the manifest. A snapshot without a manifest has an empty log.
+  /// @returns An error if I/O operations fail.
+  caf::error init();
+
+  /// Loads the snapshot.
+  /// @param xs The objects to deserialize.
+  /// @pre `has_snapshot()`
+  template <class... Ts>
+  caf::error load_snapshot(Ts&... xs) {
+    return load(sys_, filename_, xs...);
+  }
+
+  /// Deserializes all committed records in order.
+  /// @tparam Ts The types of the objects in a record.
+  /// @param f The function to invoke with the objects of each record.
+  /// @returns An error if I/O operations fail or *f* returns an error.
+  template <class... Ts, class F>
+  caf::error replay(F f) {
+    return for_each_record([&](const std::vector<char>& buf) -> caf::error {
+      std::tuple<Ts...> xs;
+      auto g = [&](auto&... ys) -> caf::error {
+        if (auto err = load(sys_, buf, ys...))
+          return err;
+        return f(ys...);
+      };
+      return std::apply(g, xs);
+    });
+  }
+
+  /// Replaces the snapshot and clears the log.
+  /// @param xs The objects to serialize.
+  /// @returns An error if I/O operations fail.
+  template <class... Ts>
+  caf::error snapshot(const Ts&... xs) {
+    std::vector<char> buf;
+    if (auto err = save(sys_, buf, xs...))
+      return err;
+    return write_snapshot(buf);
+  }
+
+  /// Appends a record to the log. The record takes effect with the next call
+  /// to ::commit.
+  /// @param xs The objects to serialize.
+  /// @returns An error if serialization fails.
+  template <class... Ts>
+  caf::error append(const Ts&... xs) {
+    std::vector<char> buf;
+    if (auto err = save(sys_, buf, xs...))
+      return err;
+    write_record(buf);
+    return caf::none;
+  }
+
+  /// Writes all appended records to the log and makes them durable.
+  /// @returns An error if I/O operations fail.
+  caf::error commit();
+
+private:
+  caf::error write_snapshot(const std::vector<char>& buf);
+
+  void write_record(const std::vector<char>& buf);
+
+  caf::error write_manifest();
+
+  caf::error
+  for_each_record(std::function<caf::error(const std::vector<char>&)> f);
+
+  caf::actor_system& sys_;
+  path filename_;
+  path log_;
+  path manifest_;
+  uint64_t snapshot_size_ = 0;
+  uint64_t log_size_ = 0;
+  std::vector<char> pending_;
+};
+
+} // namespace vast
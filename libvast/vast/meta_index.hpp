@@ -14,6 +14,7 @@
 #pragma once
 
 #include <functional>
+#include <map>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
@@ -22,10 +23,14 @@
 #include <caf/fwd.hpp>
 
 #include "vast/fwd.hpp"
+#include "vast/min_max_synopsis.hpp"
 #include "vast/synopsis.hpp"
+#include "vast/time.hpp"
 #include "vast/type.hpp"
 #include "vast/uuid.hpp"
 
+#include "vast/detail/interval_tree.hpp"
+
 namespace vast {
 
 /// The meta index is the first data structure that queries hit. The result
@@ -74,12 +79,38 @@ private:
   /// Contains synopses per table layout.
   using partition_synopsis = std::unordered_map<record_type, table_synopsis>;
 
+  /// A min-max synopsis over time.
+  using time_synopsis = min_max_synopsis<timestamp>;
+
+  /// The synopses of a single field across all partitions.
+  struct field_synopses {
+    /// Synopses other than time synopses, along with their partition.
+    std::vector<std::pair<uuid, const synopsis*>> synopses;
+
+    /// Time synopses, along with their partition.
+    std::vector<std::pair<uuid, const time_synopsis*>> time_synopses;
+
+    /// The non-empty time ranges in `time_synopses`.
+    detail::interval_tree<timestamp, uuid> time_ranges;
+  };
+
+  /// Recomputes `fields_` from all partitions.
+  void rebuild() const;
+
   /// Layouts for which we cannot generate a synopsis structure.
   std::unordered_set<record_type> blacklisted_layouts_;
 
   /// Maps a partition ID to the synopses for that partition.
   std::unordered_map<uuid, partition_synopsis> partition_synopses_;
 
+  /// Maps fields to their synopses in all partitions, so that lookups only
+  /// match each distinct field once. Lookups compute this lazily.
+  mutable std::map<record_field, field_synopses> fields_;
+
+  /// Partitions that changed since the last computation of `fields_`. The
+  /// time ranges of these partitions may have grown since then.
+  mutable std::unordered_set<uuid> dirty_partitions_;
+
   /// The factory function to construct a synopsis structure for a type.
   synopsis_factory make_synopsis_;
 
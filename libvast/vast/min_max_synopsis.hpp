@@ -13,9 +13,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <typeinfo>
+#include <vector>
+
+#include <caf/atom.hpp>
 #include <caf/deserializer.hpp>
 #include <caf/serializer.hpp>
 
+#include "vast/columnar_table_slice.hpp"
 #include "vast/synopsis.hpp"
 
 namespace vast {
@@ -32,15 +39,95 @@ public:
   }
 
   void add(data_view x) override {
-    auto y = caf::get_if<view<T>>(&x);
-    VAST_ASSERT(y != nullptr);
-    if (*y < min_)
-      min_ = *y;
-    if (*y > max_)
-      max_ = *y;
+    // Nil values cannot satisfy any predicate with a value of type T.
+    if (auto y = caf::get_if<view<T>>(&x))
+      update(*y);
+  }
+
+  void add_column(const table_slice& slice, size_t col) override {
+    if constexpr (columnar_table_slice::is_fixed_width<T>) {
+      if (slice.implementation_id() == caf::atom("TS_Columnar")) {
+        auto& x = static_cast<const columnar_table_slice&>(slice);
+        auto& column = x.column_at(col);
+        if (auto xs = caf::get_if<std::vector<T>>(&column.values)) {
+          update(xs->data(), column.valid.blocks().data(), xs->size());
+          return;
+        }
+      }
+    }
+    synopsis::add_column(slice, col);
   }
 
   bool lookup(relational_operator op, data_view rhs) const override {
+    if (auto x = caf::get_if<view<T>>(&rhs))
+      return lookup_impl(op, *x);
+    // We cannot rule out matches for values of other types.
+    return true;
+  }
+
+  bool equals(const synopsis& other) const noexcept override {
+    if (typeid(other) != typeid(*this))
+      return false;
+    auto& dref = static_cast<const min_max_synopsis&>(other);
+    return type() == dref.type() && min_ == dref.min_ && max_ == dref.max_;
+  }
+
+  caf::error serialize(caf::serializer& sink) const override {
+    return sink(min_, max_);
+  }
+
+  caf::error deserialize(caf::deserializer& source) override {
+    return source(min_, max_);
+  }
+
+  T min() const noexcept {
+    return min_;
+  }
+
+  T max() const noexcept {
+    return max_;
+  }
+
+protected:
+  /// Incorporates a value into the range.
+  void update(T x) {
+    if (x < min_)
+      min_ = x;
+    if (x > max_)
+      max_ = x;
+  }
+
+  /// Incorporates an array of values into the range.
+  /// @param xs The values.
+  /// @param valid A bitmap with bit *i* set iff `xs[i]` is not null.
+  /// @param n The number of values in *xs*.
+  void update(const T* xs, const uint64_t* valid, size_t n) {
+    auto lo = min_;
+    auto hi = max_;
+    for (size_t i = 0; i < n; i += 64) {
+      auto bits = valid[i / 64];
+      auto m = std::min(n - i, size_t{64});
+      if (m == 64 && bits == ~uint64_t{0}) {
+        // Blocks without nulls have a constant trip count and no branches,
+        // which allows the compiler to vectorize this loop.
+        for (size_t j = 0; j < 64; ++j) {
+          lo = std::min(lo, xs[i + j]);
+          hi = std::max(hi, xs[i + j]);
+        }
+      } else {
+        for (size_t j = 0; j < m; ++j)
+          if ((bits >> j) & 1) {
+            lo = std::min(lo, xs[i + j]);
+            hi = std::max(hi, xs[i + j]);
+          }
+      }
+    }
+    min_ = lo;
+    max_ = hi;
+  }
+
+  /// Tests whether any value in the range may fulfill a predicate.
+  bool lookup_impl(relational_operator op, T x) const {
     // Let *min* and *max* constitute the LHS of the lookup operation and *rhs*
     // be the value to compare with on the RHS. Then, there are 5 possible
     // scenarios to differentiate for the inputs:
@@ -61,43 +148,26 @@ public:
     //   (5) [4,8] < 9 is true  (4 < 9 || 8 < 9)
     //
     // Thus, for range comparisons we need to test `min op rhs || max op rhs`.
-    auto x = caf::get_if<view<T>>(&rhs);
-    VAST_ASSERT(x != nullptr);
     switch (op) {
       default:
-        VAST_ASSERT(!"unsupported operator");
-        return false;
+        // Operators without an order relation may match anything.
+        return true;
       case equal:
-        return min_ <= *x && *x <= max_;
+        return min_ <= x && x <= max_;
       case not_equal:
-        return !(min_ <= *x && *x <= max_);
+        // Only a range of a single value equal to *rhs* has no other value.
+        return !(min_ == x && x == max_);
       case less:
-        return min_ < *x;
+        return min_ < x;
       case less_equal:
-        return min_ <= *x;
+        return min_ <= x;
       case greater:
-        return max_ > *x;
+        return max_ > x;
       case greater_equal:
-        return max_ >= *x;
+        return max_ >= x;
     }
   }
 
-  caf::error serialize(caf::serializer& sink) const override {
-    return sink(min_, max_);
-  }
-
-  caf::error deserialize(caf::deserializer& source) override {
-    return source(min_, max_);
-  }
-
-  T min() const noexcept {
-    return min_;
-  }
-
-  T max() const noexcept {
-    return max_;
-  }
-
 private:
   T min_;
   T max_;
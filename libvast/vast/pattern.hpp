@@ -13,7 +13,11 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <string_view>
+
+#include <caf/meta/load_callback.hpp>
 
 #include "vast/detail/operators.hpp"
 
@@ -22,7 +26,10 @@ namespace vast {
 struct access;
 class json;
 
-/// A regular expression.
+/// A regular expression. A pattern compiles its expression once on
+/// construction and shares the compiled matcher among all its copies.
+/// Patterns that consist of a literal string, optionally surrounded by `.*`
+/// (as produced by ::glob), bypass the regex engine entirely.
 class pattern : detail::totally_ordered<pattern>,
                 detail::addable<pattern>,
                 detail::orable<pattern>,
@@ -42,7 +49,7 @@ public:
   static pattern glob(std::string_view str);
 
   /// Default-constructs an empty pattern.
-  pattern() = default;
+  pattern();
 
   /// Constructs a pattern from a string.
   /// @param str The string containing the pattern.
@@ -60,8 +67,7 @@ public:
 
   const std::string& string() const;
 
-
-  // -- concepts // ------------------------------------------------------------
+  // -- concepts ---------------------------------------------------------------
 
   pattern& operator+=(const pattern& other);
   pattern& operator+=(std::string_view other);
@@ -82,13 +88,24 @@ public:
 
   template <class Inspector>
   friend auto inspect(Inspector& f, pattern& p) {
-    return f(p.str_);
+    // We only serialize the expression and recompile it after loading.
+    auto load = [&]() -> caf::error {
+      p.compile();
+      return {};
+    };
+    return f(p.str_, caf::meta::load_callback(load));
   }
 
   friend bool convert(const pattern& p, json& j);
 
 private:
+  class matcher;
+
+  /// Compiles `str_` into `matcher_`.
+  void compile();
+
   std::string str_;
+  std::shared_ptr<const matcher> matcher_;
 };
 
 } // namespace vast
@@ -0,0 +1,37 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "vast/min_max_synopsis.hpp"
+#include "vast/port.hpp"
+#include "vast/synopsis.hpp"
+
+namespace vast {
+
+/// A min-max synopsis over port numbers. Ports do not take part in the
+/// ordering directly, because their equality treats unknown protocols as
+/// wildcard whereas their ordering does not.
+class port_synopsis final : public min_max_synopsis<port::number_type> {
+public:
+  using super = min_max_synopsis<port::number_type>;
+
+  port_synopsis(vast::type x);
+
+  void add(data_view x) override;
+
+  bool lookup(relational_operator op, data_view rhs) const override;
+};
+
+} // namespace vast
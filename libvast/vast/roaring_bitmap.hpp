@@ -0,0 +1,265 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <caf/error.hpp>
+#include <caf/none.hpp>
+
+#include "vast/bitmap_base.hpp"
+#include "vast/word.hpp"
+
+#include "vast/detail/operators.hpp"
+
+namespace vast {
+
+class roaring_bitmap_range;
+
+/// A bitmap that partitions the bit space into chunks of 2^16 bits and
+/// encodes each chunk independently, following the design of *Roaring*
+/// bitmaps by Chambi et al. A chunk with at least one 1-bit has a
+/// *container* that represents its 1-bits in one of three ways:
+///
+/// 1. *array*: a sorted vector of 16-bit offsets for at most 4096 1-bits.
+/// 2. *bitset*: an uncompressed sequence of 1024 blocks.
+/// 3. *full*: no data at all if all 2^16 bits are 1.
+///
+/// Chunks without 1-bits have no container. In contrast to the run-length
+/// encoded bitmaps, random access and operations on sparse and clustered bit
+/// sequences only touch the affected containers.
+class roaring_bitmap : public bitmap_base<roaring_bitmap>,
+                       detail::equality_comparable<roaring_bitmap> {
+  friend roaring_bitmap_range;
+
+public:
+  /// The number of bits per container.
+  static constexpr size_type container_bits = size_type{1} << 16;
+
+  /// The number of blocks of a bitset container.
+  static constexpr size_type container_blocks
+    = container_bits / word_type::width;
+
+  /// The maximum number of 1-bits in an array container.
+  static constexpr size_type array_capacity = 4096;
+
+  /// The 1-bits of a single chunk.
+  struct container : detail::equality_comparable<container> {
+    /// The index of the chunk, i.e., the position of its first bit divided
+    /// by ::container_bits.
+    size_type key = 0;
+
+    /// The number of 1-bits in the chunk.
+    size_type cardinality = 0;
+
+    /// The sorted offsets of all 1-bits for an array container.
+    std::vector<uint16_t> array;
+
+    /// The blocks of a bitset container.
+    std::vector<block_type> bitset;
+
+    /// @returns `true` if all bits of the chunk are 1.
+    bool full() const {
+      return cardinality == container_bits;
+    }
+
+    friend bool operator==(const container& x, const container& y) {
+      return x.key == y.key && x.cardinality == y.cardinality
+             && x.array == y.array && x.bitset == y.bitset;
+    }
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, container& x) {
+      return f(x.key, x.cardinality, x.array, x.bitset);
+    }
+  };
+
+  /// A truth table of a bitwise operation. Bit *2x + y* holds the result of
+  /// the operation for the bit values *x* and *y*.
+  using truth_table = uint8_t;
+
+  roaring_bitmap() = default;
+
+  explicit roaring_bitmap(size_type n, bool bit = false);
+
+  // -- inspectors -----------------------------------------------------------
+
+  bool empty() const;
+
+  size_type size() const;
+
+  const std::vector<container>& containers() const;
+
+  // -- modifiers ------------------------------------------------------------
+
+  void append_bit(bool bit);
+
+  void append_bits(bool bit, size_type n);
+
+  void append_block(block_type bits, size_type n = word_type::width);
+
+  void flip();
+
+  // -- searching ------------------------------------------------------------
+
+  /// Counts the 1-bits.
+  /// @returns The number of 1-bits.
+  size_type count() const;
+
+  /// Counts the 1-bits up to and including a given position.
+  /// @param i The position where to end counting.
+  /// @returns The number of 1-bits in *[0,i]*.
+  /// @pre `i < size()`
+  size_type count(size_type i) const;
+
+  /// Locates the first 1-bit at or after a given position.
+  /// @param i The position where to start searching.
+  /// @returns The position of the first 1-bit in *[i,size())* or `npos`.
+  size_type find_first(size_type i = 0) const;
+
+  /// Locates the *i*-th occurrence of a bit value.
+  /// @param i The rank of the bit to locate, or `npos` for the last one.
+  /// @param bit The bit value to locate.
+  /// @returns The position of the *i*-th occurrence of *bit* or `npos`.
+  /// @pre `i > 0`
+  size_type find_nth(size_type i, bool bit = true) const;
+
+  // -- bitwise operations ---------------------------------------------------
+
+  /// Evaluates a bitwise operation container by container. This function
+  /// implements ::binary_eval for two Roaring bitmaps.
+  /// @param lhs The LHS of the operation.
+  /// @param rhs The RHS of the operation.
+  /// @param fill_lhs Whether to copy the remaining bits of a longer *lhs*.
+  /// @param fill_rhs Whether to copy the remaining bits of a longer *rhs*.
+  /// @param op The truth table of the bitwise operation.
+  /// @returns The result of the bitwise operation between *lhs* and *rhs*.
+  static roaring_bitmap evaluate(const roaring_bitmap& lhs,
+                                 const roaring_bitmap& rhs, bool fill_lhs,
+                                 bool fill_rhs, truth_table op);
+
+  // -- concepts -------------------------------------------------------------
+
+  friend bool operator==(const roaring_bitmap& x, const roaring_bitmap& y);
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, roaring_bitmap& bm) {
+    return f(bm.containers_, bm.size_);
+  }
+
+  friend roaring_bitmap_range bit_range(const roaring_bitmap& bm);
+
+private:
+  /// @returns the container for the chunk *key*, which must be the last one.
+  container& tail(size_type key);
+
+  std::vector<container> containers_;
+  size_type size_ = 0;
+};
+
+class roaring_bitmap_range
+  : public bit_range_base<roaring_bitmap_range, roaring_bitmap::block_type> {
+public:
+  using word_type = roaring_bitmap::word_type;
+
+  explicit roaring_bitmap_range(const roaring_bitmap& bm);
+
+  void next();
+  bool done() const;
+
+private:
+  void scan();
+
+  const roaring_bitmap* bitmap_;
+  std::vector<roaring_bitmap::container>::const_iterator container_;
+  roaring_bitmap::size_type position_ = 0;
+};
+
+// -- algorithms ---------------------------------------------------------------
+
+/// Applies a bitwise operation on two Roaring bitmaps. Only containers that
+/// can affect the result participate in the evaluation.
+/// @relates roaring_bitmap
+template <bool FillLHS, bool FillRHS, class Operation>
+roaring_bitmap
+binary_eval(const roaring_bitmap& lhs, const roaring_bitmap& rhs,
+            Operation op) {
+  using word_type = roaring_bitmap::word_type;
+  auto table = roaring_bitmap::truth_table{0};
+  for (auto x : {0, 1})
+    for (auto y : {0, 1}) {
+      auto l = x ? word_type::all : word_type::none;
+      auto r = y ? word_type::all : word_type::none;
+      if (op(l, r) & word_type::lsb1)
+        table |= 1 << (2 * x + y);
+    }
+  return roaring_bitmap::evaluate(lhs, rhs, FillLHS, FillRHS, table);
+}
+
+/// Computes the rank of a Roaring bitmap without scanning its bits.
+/// @relates roaring_bitmap
+template <bool Bit = true>
+roaring_bitmap::size_type rank(const roaring_bitmap& bm) {
+  return Bit ? bm.count() : bm.size() - bm.count();
+}
+
+/// Computes the rank of a Roaring bitmap up to and including position *i*.
+/// @relates roaring_bitmap
+template <bool Bit = true>
+roaring_bitmap::size_type rank(const roaring_bitmap& bm,
+                               roaring_bitmap::size_type i) {
+  VAST_ASSERT(i < bm.size());
+  return Bit ? bm.count(i) : i + 1 - bm.count(i);
+}
+
+/// Computes the position of the *i*-th occurrence of a bit in a Roaring
+/// bitmap.
+/// @relates roaring_bitmap
+template <bool Bit = true>
+roaring_bitmap::size_type select(const roaring_bitmap& bm,
+                                 roaring_bitmap::size_type i) {
+  VAST_ASSERT(i > 0);
+  return bm.find_nth(i, Bit);
+}
+
+/// Traverses the 1-bits of a Roaring bitmap in conjunction with a sorted
+/// range of half-open ID intervals. This overload skips over gaps in the
+/// bitmap with a single container lookup.
+/// @relates roaring_bitmap
+template <class Iterator, class F, class G>
+caf::error select_with(const roaring_bitmap& bm, Iterator begin,
+                       Iterator end, F f, G g) {
+  auto pred = [&](const auto& x, auto y) { return f(x).second <= y; };
+  auto x = bm.find_first();
+  while (x != roaring_bitmap::word_type::npos && begin != end) {
+    begin = std::lower_bound(begin, end, x, pred);
+    if (begin == end)
+      break;
+    auto [first, last] = f(*begin);
+    if (x < first) {
+      x = bm.find_first(first);
+      continue;
+    }
+    if (auto error = g(*begin))
+      return error;
+    x = bm.find_first(last);
+    ++begin;
+  }
+  return caf::none;
+}
+
+} // namespace vast
@@ -27,6 +27,7 @@
 
 #include "vast/aliases.hpp"
 #include "vast/chunk.hpp"
+#include "vast/compression.hpp"
 #include "vast/fwd.hpp"
 #include "vast/uuid.hpp"
 
@@ -61,6 +62,9 @@ using segment_ptr = caf::intrusive_ptr<segment>;
 ///               .                                         . /
 ///               +-----------------------------------------+
 ///
+/// If the meta data specifies a compression method other than `null`, each
+/// table slice gets compressed individually and its bytes begin with the
+/// uncompressed size as 64-bit little-endian integer.
 class segment : public caf::ref_counted {
   friend segment_builder;
 
@@ -74,7 +78,7 @@ public:
   static inline constexpr magic_type magic = 0x2a547ea8;
 
   /// The current version of the segment format.
-  static inline constexpr version_type version = 1;
+  static inline constexpr version_type version = 2;
 
   /// The fixed-size header for every segment.
   struct header {
@@ -99,9 +103,12 @@ public:
   /// Meta data for a segment.
   struct meta_data {
     std::vector<table_slice_synopsis> slices;
+    compression method = compression::null; ///< Per-slice compression.
   };
 
-  /// Constructs a segment.
+  /// Constructs a segment. This only reads the header and meta data; table
+  /// slices get deserialized on demand in `lookup`. Hence, a memory-mapped
+  /// chunk only pages in the slices that a lookup selects.
   /// @param sys The actor system that stores factory to deserialize table
   ///            slices.
   /// @param chunk The chunk holding the segment data.
@@ -153,7 +160,7 @@ auto inspect(Inspector& f, segment::table_slice_synopsis& x) {
 /// @relates segment::meta_data
 template <class Inspector>
 auto inspect(Inspector& f, segment::meta_data& x) {
-  return f(x.slices);
+  return f(x.slices, x.method);
 }
 
 /// @relates segment
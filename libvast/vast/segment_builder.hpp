@@ -35,7 +35,9 @@ public:
   /// Constructs a segment builder.
   /// @param sys The actor system used to construct segments (and deserialize
   ///            table slices).
-  segment_builder(caf::actor_system& sys);
+  /// @param method The compression method for individual table slices.
+  segment_builder(caf::actor_system& sys,
+                  compression method = compression::lz4);
 
   /// Adds a table slice to the segment.
   /// @returns An error if adding the table slice failed.
@@ -57,7 +59,7 @@ public:
   /// @returns The UUID for the segment under construction.
   const uuid& id() const;
 
-  /// @returns The number of bytes of the current segment.
+  /// @returns The number of (compressed) bytes of the current segment.
   size_t table_slice_bytes() const;
 
 private:
@@ -65,6 +67,7 @@ private:
   void reset();
 
   caf::actor_system& actor_system_;
+  compression method_;
   // Segment state
   std::vector<char> segment_buffer_;
   segment::meta_data meta_;
@@ -74,6 +77,7 @@ private:
   std::vector<char> table_slice_buffer_;
   caf::vectorbuf table_slice_streambuf_;
   caf::stream_serializer<caf::vectorbuf&> table_slice_serializer_;
+  std::vector<char> compression_buffer_;
   // Lookup cache
   std::vector<table_slice_ptr> slices_;
 };
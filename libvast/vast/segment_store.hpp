@@ -39,10 +39,12 @@ public:
   /// @param dir The directory where to store state.
   /// @param max_segment_size The maximum segment size in bytes.
   /// @param in_memory_segments The number of semgents to cache in memory.
+  /// @param method The compression method for table slices in new segments.
   /// @pre `max_segment_size > 0`
   static segment_store_ptr make(caf::actor_system& sys,
                                 path dir, size_t max_segment_size,
-                                size_t in_memory_segments);
+                                size_t in_memory_segments,
+                                compression method = compression::lz4);
 
   ~segment_store();
 
@@ -53,10 +55,42 @@ public:
 
   caf::error flush() override;
 
+  // -- non-blocking lookups ---------------------------------------------------
+
+  /// Memory-maps a segment from a file. The file contains the segment chunk
+  /// prefixed by its size in variable byte encoding. Only pages that a
+  /// subsequent lookup touches get read from disk.
+  /// @param sys The actor system for table slice deserialization.
+  /// @param filename The segment file.
+  /// @returns The segment in *filename*.
+  static caf::expected<segment_ptr> mmap(caf::actor_system& sys,
+                                         const path& filename);
+
+  /// @returns The IDs of all segments that contain at least one of *xs* in
+  ///          the order of their arrival.
+  std::vector<uuid> candidates(const ids& xs) const;
+
+  /// Retrieves table slices from the segment under construction.
+  /// @param xs The IDs for the events to retrieve.
+  caf::expected<std::vector<table_slice_ptr>> get_active(const ids& xs) const;
+
+  /// @returns The ID of the segment under construction.
+  const uuid& active_segment() const;
+
+  /// @returns The segment with ID *id* if it is in the cache or `nullptr`.
+  segment_ptr cached(const uuid& id);
+
+  /// Adds a segment to the cache.
+  /// @pre `x != nullptr`
+  void cache(segment_ptr x);
+
+  /// @returns The path to the file of segment *id*.
+  path segment_file(const uuid& id) const;
+
   /// @cond PRIVATE
 
   segment_store(caf::actor_system& sys, path dir, uint64_t max_segment_size,
-                size_t in_memory_segments);
+                size_t in_memory_segments, compression method);
 
   /// @endcond
 
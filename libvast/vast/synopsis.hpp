@@ -45,6 +45,13 @@ public:
   /// @param slice The table slice to process.
   virtual void add(data_view x) = 0;
 
+  /// Adds all values of a column of a table slice. The default implementation
+  /// adds one value at a time.
+  /// @param slice The table slice to process.
+  /// @param col The column of *slice* to add.
+  /// @pre `col < slice.columns()`
+  virtual void add_column(const table_slice& slice, size_t col);
+
   /// Tests whether a predicate matches. The synopsis is implicitly the LHS of
   /// the predicate.
   /// @param op The operator of the predicate.
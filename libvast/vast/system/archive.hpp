@@ -13,42 +13,110 @@
 
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
+#include <caf/actor.hpp>
 #include <caf/fwd.hpp>
 #include <caf/replies_to.hpp>
 #include <caf/stateful_actor.hpp>
 #include <caf/typed_actor.hpp>
 #include <caf/typed_event_based_actor.hpp>
+#include <caf/typed_response_promise.hpp>
 
+#include "vast/compression.hpp"
+#include "vast/event.hpp"
 #include "vast/fwd.hpp"
 #include "vast/ids.hpp"
-#include "vast/store.hpp"
+#include "vast/segment_store.hpp"
 #include "vast/system/atoms.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/uuid.hpp"
 
 namespace vast::system {
 
+/// A lookup in the archive that waits for segments to arrive.
+/// @tparam T The result type, either ::event or ::table_slice_ptr.
+/// @relates archive
+template <class T>
+struct archive_lookup {
+  /// The requested IDs.
+  ids xs;
+
+  /// The number of segments that have yet to deliver their events.
+  size_t pending = 0;
+
+  /// Results that we deliver with the response.
+  std::vector<T> buffer;
+
+  /// Receives partial results if the lookup arrived as asynchronous message.
+  caf::actor sink;
+
+  /// Delivers the final result.
+  caf::typed_response_promise<std::vector<T>> promise;
+};
+
 /// @relates archive
 struct archive_state {
-  std::unique_ptr<vast::store> store;
+  /// Holds all table slices.
+  segment_store_ptr store;
+
+  /// Loads segments from disk and materializes events off the archive's
+  /// thread.
+  caf::actor workers;
+
+  /// Maps segments that are currently loading to the waiting lookups.
+  std::unordered_map<uuid, std::vector<uint64_t>> loading;
+
+  /// Lookups for events that wait for segments.
+  std::unordered_map<uint64_t, archive_lookup<event>> event_lookups;
+
+  /// Lookups for table slices that wait for segments.
+  std::unordered_map<uint64_t, archive_lookup<table_slice_ptr>> slice_lookups;
+
+  /// The ID for the next lookup. Shared by both kinds of lookups.
+  uint64_t next_lookup = 0;
+
+  /// @returns the pending lookups with result type `T`.
+  template <class T>
+  auto& lookups() {
+    if constexpr (std::is_same_v<T, event>)
+      return event_lookups;
+    else
+      return slice_lookups;
+  }
+
   static inline const char* name = "archive";
 };
 
 /// @relates archive
 using archive_type = caf::typed_actor<
   caf::reacts_to<caf::stream<table_slice_ptr>>,
-  caf::replies_to<ids>::with<std::vector<event>>
+  caf::replies_to<ids>::with<std::vector<event>>,
+  caf::replies_to<table_slice_atom, ids>::with<std::vector<table_slice_ptr>>
 >;
 
-/// Stores event batches and answers queries for ID sets.
+/// Stores event batches and answers queries for ID sets. The archive loads
+/// segments and extracts events on a pool of workers, whose size is
+/// configurable via `vast.archive-workers`. Concurrent lookups share the
+/// loading of the same segment. When receiving a query as asynchronous
+/// message, the archive sends a batch of events to the sender for each
+/// segment as soon as it becomes available. Requests receive a single
+/// response with all events. Queries tagged with `table_slice_atom` receive
+/// the table slices that contain the requested IDs instead of events, which
+/// avoids materializing events altogether. The receiver is responsible for
+/// restricting the slices to the requested rows.
 /// @param self The actor handle.
 /// @param dir The root directory of the archive.
 /// @param capacity The number of segments to cache in memory.
 /// @param max_segment_size The maximum segment size in bytes.
+/// @param method The compression method for table slices in segments.
 /// @pre `max_segment_size > 0`
 archive_type::behavior_type
 archive(archive_type::stateful_pointer<archive_state> self, path dir,
-        size_t capacity, size_t max_segment_size);
+        size_t capacity, size_t max_segment_size, compression method);
 
 } // namespace vast::system
 
@@ -79,6 +79,7 @@ using statistics_atom = caf::atom_constant<caf::atom("statistics")>;
 using stop_atom = caf::atom_constant<caf::atom("stop")>;
 using store_atom = caf::atom_constant<caf::atom("store")>;
 using submit_atom = caf::atom_constant<caf::atom("submit")>;
+using table_slice_atom = caf::atom_constant<caf::atom("tableslice")>;
 using unload_atom = caf::atom_constant<caf::atom("unload")>;
 using value_atom = caf::atom_constant<caf::atom("value")>;
 using write_atom = caf::atom_constant<caf::atom("write")>;
@@ -14,7 +14,6 @@
 #pragma once
 
 #include <chrono>
-#include <deque>
 #include <memory>
 #include <unordered_map>
 
@@ -23,6 +22,7 @@
 #include "vast/expression.hpp"
 #include "vast/ids.hpp"
 #include "vast/query_options.hpp"
+#include "vast/table_slice.hpp"
 #include "vast/uuid.hpp"
 
 #include "vast/system/accountant.hpp"
@@ -39,8 +39,8 @@ struct exporter_state {
   ids hits;
   ids unprocessed;
   std::unordered_map<type, expression> checkers;
-  std::deque<event> candidates;
-  std::vector<event> results;
+  std::vector<table_slice_ptr> results;
+  ids result_ids;
   std::chrono::steady_clock::time_point start;
   query_statistics stats;
   query_options options;
@@ -48,9 +48,10 @@ struct exporter_state {
   static inline const char* name = "exporter";
 };
 
-/// The EXPORTER receives index hits, looks up the corresponding events in the
-/// archive, and performs a candidate check to select the resulting stream of
-/// matching events.
+/// The EXPORTER receives index hits, looks up the corresponding table slices in
+/// the archive, and performs a candidate check on the rows of the slices to
+/// select the resulting stream of matching events. The EXPORTER ships results
+/// to its sinks as table slices together with the IDs of the matching rows.
 /// @param self The actor handle.
 /// @param ast The AST of query.
 /// @param qos The query options.
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -24,10 +25,11 @@
 #include "vast/fwd.hpp"
 #include "vast/system/indexer_stage_driver.hpp"
 #include "vast/system/partition.hpp"
+#include "vast/system/partition_cache.hpp"
 #include "vast/uuid.hpp"
 
-#include "vast/detail/flat_lru_cache.hpp"
 #include "vast/detail/flat_set.hpp"
+#include "vast/detail/thread_pool.hpp"
 
 namespace vast::system {
 
@@ -39,16 +41,6 @@ struct index_state {
   /// the INDEXER actors of the current partition.
   using stage_ptr = indexer_stage_driver::stage_ptr_type;
 
-  /// Looks up partitions in the LRU cache by UUID.
-  class partition_lookup {
-  public:
-    auto operator()(const uuid& id) const {
-      return [&](const partition_ptr& ptr) {
-        return ptr->id() == id;
-      };
-    }
-  };
-
   /// Loads partitions from disk by UUID.
   class partition_factory {
   public:
@@ -62,10 +54,6 @@ struct index_state {
     index_state* st_;
   };
 
-  using partition_cache_type = detail::flat_lru_cache<partition_ptr,
-                                                      partition_lookup,
-                                                      partition_factory>;
-
   /// Stores context information for unfinished queries.
   struct lookup_state {
     /// Issued query.
@@ -114,7 +102,7 @@ struct index_state {
   partition_ptr active;
 
   /// Recently accessed partitions.
-  partition_cache_type lru_partitions;
+  partition_cache lru_partitions;
 
   /// Base directory for all partitions of the index.
   path dir;
@@ -145,11 +133,23 @@ struct index_state {
   /// Caches idle workers.
   std::vector<caf::actor> idle_workers;
 
+  /// Threads for indexing columns in parallel, shared by all INDEXER actors.
+  std::shared_ptr<detail::thread_pool> indexer_workers;
+
   /// Name of the INDEX actor.
   static inline const char* name = "index";
 };
 
-/// Indexes events in horizontal partitions.
+/// Indexes events in horizontal partitions. The INDEXER actors of all
+/// partitions share a pool of `vast.indexer-workers` threads for indexing
+/// columns in parallel. The option `vast.bitmap-type` selects the concrete
+/// bitmap type for the postings of the value indexes that keep one bitmap
+/// per distinct value, e.g., `roaring` for sparse and clustered data.
+/// Besides the number of partitions, the option
+/// `vast.partition-cache-size` limits the estimated memory of all cached
+/// partitions in bytes, and `vast.bloom-filter-capacity` sizes the Bloom
+/// filter synopses of the meta index. The INDEX reports cache hits, misses,
+/// and evictions to the accountant under the key `index.partition-cache`.
 /// @param dir The directory of the index.
 /// @param max_partition_size The maximum number of events per partition.
 /// @param in_mem_partitions The maximum number of partitions to hold in memory.
@@ -13,15 +13,19 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 
 #include <caf/actor.hpp>
 #include <caf/stateful_actor.hpp>
 
 #include "vast/filesystem.hpp"
+#include "vast/system/accountant.hpp"
 #include "vast/table_index.hpp"
 #include "vast/type.hpp"
 
+#include "vast/detail/thread_pool.hpp"
+
 namespace vast::system {
 
 struct indexer_state {
@@ -30,14 +34,20 @@ struct indexer_state {
   void init(table_index&& from);
   union { table_index tbl; };
   bool initialized;
+  accountant_type accountant;
   static inline const char* name = "indexer";
 };
 
-/// Indexes table slices.
+/// Indexes table slices. Reports the time spent per column to the
+/// accountant after each batch, under the key
+/// `indexer.append.<layout>.<column>`.
 /// @param self The actor handle.
 /// @param dir The directory where to store the indexes in.
 /// @param layout The type of individual columns in slices.
+/// @param pool The threads for indexing columns in parallel, or `nullptr` to
+///             index all columns in the actor.
 caf::behavior indexer(caf::stateful_actor<indexer_state>* self, path dir,
-                      record_type layout);
+                      record_type layout,
+                      std::shared_ptr<detail::thread_pool> pool);
 
 } // namespace vast::system
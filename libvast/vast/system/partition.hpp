@@ -14,6 +14,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 
 #include <caf/detail/unordered_flat_map.hpp>
 #include <caf/event_based_actor.hpp>
@@ -26,6 +27,8 @@
 #include "vast/type.hpp"
 #include "vast/uuid.hpp"
 
+#include "vast/detail/thread_pool.hpp"
+
 namespace vast::system {
 
 /// The horizontal data scaling unit of the index. A partition represents a
@@ -158,10 +161,12 @@ partition_ptr make_partition(caf::actor_system& sys, const path& base_dir,
                              uuid id, indexer_manager::indexer_factory f);
 
 /// Creates a partition that spawns regular INDEXER actors as children of
-/// `self`.
+/// `self`. The INDEXER actors share *pool* for indexing columns in parallel.
 /// @relates partition
 partition_ptr make_partition(caf::actor_system& sys, caf::local_actor* self,
-                             const path& base_dir, uuid id);
+                             const path& base_dir, uuid id,
+                             std::shared_ptr<detail::thread_pool> pool
+                             = nullptr);
 
 } // namespace vast::system
 
@@ -0,0 +1,132 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include "vast/system/partition.hpp"
+#include "vast/uuid.hpp"
+
+namespace vast::system {
+
+/// Caches partitions in LRU order. The cache holds at most a maximum number
+/// of partitions and evicts partitions while their estimated memory usage
+/// exceeds a budget. Evicting a partition releases its INDEXER actors and
+/// thereby their table indexes, unless a pending query still references them.
+class partition_cache {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Loads a partition by UUID.
+  using factory_type = std::function<partition_ptr(const uuid&)>;
+
+  /// Estimates the number of bytes that a partition occupies in memory.
+  using estimator_type = std::function<size_t(const partition&)>;
+
+  /// Counts cache accesses and evictions.
+  struct statistics {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Constructs a partition cache.
+  /// @param max_partitions The maximum number of partitions.
+  /// @param max_bytes The memory budget in bytes.
+  /// @param factory Loads partitions on a cache miss.
+  /// @param estimator Estimates the memory usage of a loaded partition.
+  partition_cache(size_t max_partitions, size_t max_bytes,
+                  factory_type factory, estimator_type estimator);
+
+  // -- properties -------------------------------------------------------------
+
+  /// @returns whether the partition with ID `id` is in the cache.
+  bool contains(const uuid& id) const;
+
+  /// @returns the number of cached partitions.
+  size_t size() const noexcept {
+    return entries_.size();
+  }
+
+  /// @returns the estimated memory usage of all cached partitions.
+  size_t bytes() const noexcept {
+    return bytes_;
+  }
+
+  /// @returns the maximum number of partitions.
+  size_t max_partitions() const noexcept {
+    return max_partitions_;
+  }
+
+  /// Sets the maximum number of partitions and evicts partitions if necessary.
+  /// @pre `n > 0`
+  void max_partitions(size_t n);
+
+  /// @returns the memory budget in bytes.
+  size_t max_bytes() const noexcept {
+    return max_bytes_;
+  }
+
+  /// Sets the memory budget and evicts partitions if necessary.
+  void max_bytes(size_t n);
+
+  /// @returns the number of hits, misses, and evictions so far.
+  const statistics& stats() const noexcept {
+    return stats_;
+  }
+
+  // -- operations -------------------------------------------------------------
+
+  /// Gets a partition from the cache or loads it on a miss. Loading a
+  /// partition may evict others, but never the requested one, even if it
+  /// exceeds the budget on its own.
+  /// @param id The ID of the partition.
+  /// @returns The partition with ID `id`.
+  partition_ptr& get_or_add(const uuid& id);
+
+private:
+  struct entry {
+    partition_ptr part;
+    size_t bytes;
+  };
+
+  using list_type = std::list<entry>;
+
+  /// Evicts the least recently used partitions until the cache respects its
+  /// limits, keeping at least the most recently used one.
+  void shrink();
+
+  /// Cached partitions, the most recently used at the front.
+  list_type entries_;
+
+  /// Maps partition IDs to cache entries.
+  std::unordered_map<uuid, list_type::iterator> positions_;
+
+  size_t max_partitions_;
+  size_t max_bytes_;
+  size_t bytes_ = 0;
+  statistics stats_;
+  factory_type factory_;
+  estimator_type estimator_;
+};
+
+} // namespace vast::system
@@ -23,11 +23,14 @@
 #include <caf/stateful_actor.hpp>
 
 #include "vast/concept/printable/stream.hpp"
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/concept/printable/vast/uuid.hpp"
 #include "vast/event.hpp"
 #include "vast/format/writer.hpp"
+#include "vast/ids.hpp"
 #include "vast/system/atoms.hpp"
 #include "vast/system/query_statistics.hpp"
+#include "vast/table_slice.hpp"
 
 namespace vast::system {
 
@@ -83,6 +86,42 @@ caf::behavior sink(caf::stateful_actor<sink_state<Writer>>* self,
         }
       }
     },
+    [=](const std::vector<table_slice_ptr>& slices, const ids& rows) {
+      // Access the writer via its base to see all overloads of write().
+      format::writer& writer = self->state.writer;
+      for (auto& slice : slices) {
+        auto first = slice->offset();
+        auto selection = rows & make_ids({{first, first + slice->rows()}});
+        auto n = rank(selection);
+        if (n == 0)
+          continue;
+        auto reached_limit = self->state.limit > 0
+                             && self->state.processed + n >= self->state.limit;
+        if (reached_limit) {
+          n = self->state.limit - self->state.processed;
+          selection = take(selection, n);
+        }
+        auto r = writer.write(*slice, selection);
+        if (!r) {
+          VAST_ERROR(self, self->system().render(r.error()));
+          self->state.writer.cleanup();
+          self->quit(r.error());
+          return;
+        }
+        self->state.processed += n;
+        if (reached_limit) {
+          VAST_INFO(self, "reached limit:", self->state.limit, "events");
+          self->state.writer.cleanup();
+          self->quit();
+          return;
+        }
+      }
+      auto now = steady_clock::now();
+      if (now - self->state.last_flush > self->state.flush_interval) {
+        self->state.writer.flush();
+        self->state.last_flush = now;
+      }
+    },
     [=](const uuid& id, const query_statistics&) {
       VAST_IGNORE_UNUSED(id);
       VAST_DEBUG(self, "got query statistics from", id);
@@ -32,10 +32,13 @@
 #include "vast/concept/printable/vast/error.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
 #include "vast/concept/printable/vast/type.hpp"
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/columnar_table_slice.hpp"
 #include "vast/default_table_slice.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/error.hpp"
+#include "vast/evaluate.hpp"
 #include "vast/event.hpp"
 #include "vast/expected.hpp"
 #include "vast/expression.hpp"
@@ -159,26 +162,79 @@ struct source_state {
       layout);
   }
 
+  /// Computes the rows of a table slice that satisfy the filter.
+  /// @pre `!caf::holds_alternative<caf::none_t>(filter)`
+  ids apply_filter(const table_slice& slice) {
+    type layout = slice.layout(1).name(slice.layout().name());
+    auto& checker = checkers[layout];
+    if (caf::holds_alternative<caf::none_t>(checker)) {
+      auto x = tailor(filter, layout);
+      VAST_ASSERT(x);
+      checker = std::move(*x);
+    }
+    return evaluate(checker, slice);
+  }
+
+  /// Copies the selected rows of a table slice into a builder.
+  /// @returns `false` if the builder rejected a value.
+  bool copy_rows(const table_slice& slice, const ids& rows,
+                 table_slice_builder& builder) {
+    for (auto rng = select(rows); rng; rng.next()) {
+      auto row = rng.get() - slice.offset();
+      for (table_slice::size_type col = 0; col < slice.columns(); ++col)
+        if (!builder.add(slice.at(row, col))) {
+          VAST_ERROR(self, "failed to copy filtered row", row);
+          return false;
+        }
+    }
+    return true;
+  }
+
   // Extracts events from the source until input is exhausted or until the
-  // maximum is reached.
+  // maximum number of events has been read.
   // @returns The number of produced events and whether we've reached the end.
   template <class PushSlice>
   std::pair<size_t, bool> extract_events(size_t max_events,
                                          size_t table_slice_size,
                                          PushSlice& push_slice) {
-    auto finish_slice = [&](table_slice_builder* bptr) {
+    size_t produced = 0;
+    size_t read = 0;
+    // Ships the slice of a builder. With a filter, only the rows that satisfy
+    // it make it into the slice. Unless flushing, the passing rows of a
+    // partially matching slice go back into the builder, which then keeps
+    // filling up to a full slice.
+    auto finish_slice = [&](table_slice_builder* bptr, bool flush) {
       if (!bptr)
         return;
       auto slice = bptr->finish();
-      if (slice == nullptr)
+      if (slice == nullptr) {
         VAST_ERROR(self, "failed to finish a slice");
-      else
-        push_slice(std::move(slice));
+        return;
+      }
+      if (!caf::holds_alternative<caf::none_t>(filter)) {
+        auto hits = apply_filter(*slice);
+        auto n = rank(hits);
+        // Skip events that don't satisfy our filter.
+        if (n == 0)
+          return;
+        if (n < slice->rows()) {
+          if (!copy_rows(*slice, hits, *bptr) || !flush)
+            return;
+          slice = bptr->finish();
+          if (slice == nullptr) {
+            VAST_ERROR(self, "failed to finish a slice");
+            return;
+          }
+        }
+      }
+      produced += slice->rows();
+      push_slice(std::move(slice));
     };
-    size_t produced = 0;
     // The streaming operates on slices, while the reader operates on events.
-    // Hence, we can produce up to num * table_slice_size events per run.
-    while (produced < max_events) {
+    // Hence, we can produce up to num * table_slice_size events per run. We
+    // bound the run by the events we read rather than by the events we ship,
+    // because a selective filter may drop most of them.
+    while (read < max_events) {
       auto maybe_e = reader.read();
       if (!maybe_e) {
         // Try again when receiving default-generated errors.
@@ -200,35 +256,23 @@ struct source_state {
         for (auto& kvp : builders) {
           auto bptr = kvp.second.get();
           if (kvp.second != nullptr && bptr->rows() > 0)
-            finish_slice(bptr);
+            finish_slice(bptr, true);
         }
         return {produced, true};
       }
+      ++read;
       auto& e = *maybe_e;
       auto bptr = builder(e.type(), table_slice_size);
       if (bptr == nullptr)
         continue;
-      if (!caf::holds_alternative<caf::none_t>(filter)) {
-        auto& checker = checkers[e.type()];
-        if (caf::holds_alternative<caf::none_t>(checker)) {
-          auto x = tailor(filter, e.type());
-          VAST_ASSERT(x);
-          checker = std::move(*x);
-        }
-        if (!caf::visit(event_evaluator{e}, checker)) {
-          // Skip events that don't satisfy our filter.
-          continue;
-        }
-      }
       /// Add meta column(s).
       if (auto ts = e.timestamp(); !bptr->add(ts))
         VAST_WARNING(self, "failed to add timestamp", ts);
       /// Add data column(s).
       if (auto data = e.data(); !bptr->recursive_add(data, e.type()))
         VAST_WARNING(self, "failed to add data", data);
-      ++produced;
       if (bptr->rows() == table_slice_size)
-        finish_slice(bptr);
+        finish_slice(bptr, false);
     }
     return {produced, false};
   }
@@ -337,8 +381,20 @@ caf::behavior default_source(caf::stateful_actor<source_state<Reader>>* self,
                              Reader reader) {
   auto slice_size = get_or(self->system().config(), "vast.table-slice-size",
                            defaults::system::table_slice_size);
-  return source(self, std::move(reader), default_table_slice::make_builder,
-                slice_size);
+  auto slice_type = get_or(self->system().config(), "vast.table-slice-type",
+                           defaults::system::table_slice_type);
+  typename source_state<Reader>::factory_type factory;
+  if (slice_type == caf::atom("TS_Default")) {
+    factory = default_table_slice::make_builder;
+  } else if (slice_type == caf::atom("TS_Columnar")) {
+    factory = columnar_table_slice::make_builder;
+  } else {
+    self->quit(make_error(ec::invalid_configuration,
+                          "invalid vast.table-slice-type",
+                          to_string(slice_type)));
+    return {};
+  }
+  return source(self, std::move(reader), factory, slice_size);
 }
 
 } // namespace vast::system
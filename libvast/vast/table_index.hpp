@@ -14,6 +14,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string_view>
 #include <utility>
 #include <vector>
@@ -24,9 +25,12 @@
 #include "vast/column_index.hpp"
 #include "vast/filesystem.hpp"
 #include "vast/ids.hpp"
+#include "vast/journal.hpp"
+#include "vast/time.hpp"
 #include "vast/type.hpp"
 
 #include "vast/detail/range.hpp"
+#include "vast/detail/thread_pool.hpp"
 
 namespace vast {
 
@@ -133,7 +137,16 @@ public:
   /// @returns the base directory for data column indexes.
   path data_dir() const;
 
-  /// Indexes a slice for all columns.
+  /// @returns the time spent appending to each column since the last call.
+  std::vector<timespan> take_append_times();
+
+  /// Distributes the columns of slices in `add` over a pool of threads.
+  /// @param pool The threads for indexing columns or `nullptr` to index all
+  ///             columns on the calling thread.
+  void parallelize(std::shared_ptr<detail::thread_pool> pool);
+
+  /// Indexes a slice for all columns. Each column receives the slices in the
+  /// order of calls to this function, regardless of parallelization.
   /// @param x Table slice for ingestion.
   caf::error add(const table_slice_ptr& x);
 
@@ -159,6 +172,11 @@ private:
   caf::expected<bitmap> lookup_impl(const predicate& pred,
                                     const data_extractor& dx, const data& x);
 
+  /// Estimates the relative cost of evaluating an expression, which allows
+  /// lookups to evaluate the cheap operands of a conjunction or disjunction
+  /// first.
+  size_t estimate_cost(const expression& expr) const;
+
   // -- constructors, destructors, and assignment operators --------------------
 
   table_index(caf::actor_system& sys, record_type layout, path base_dir);
@@ -182,6 +200,18 @@ private:
   /// Stores what IDs are present in this table.
   ids row_ids_;
 
+  /// The size of `row_ids_` at the last flush.
+  ids::size_type last_flush_ = 0;
+
+  /// Persists `row_ids_` and the IDs added since its last snapshot.
+  journal row_ids_journal_;
+
+  /// Indexes columns in parallel if set.
+  std::shared_ptr<detail::thread_pool> pool_;
+
+  /// Accumulates the time spent in `column_index::add` per column.
+  std::vector<timespan> append_times_;
+
   /// Hosting actor system.
   caf::actor_system& sys_;
 };
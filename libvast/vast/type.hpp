@@ -15,6 +15,7 @@
 
 #include <functional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -804,6 +805,18 @@ inline bool has_skip_attribute(const type& t) {
   return std::any_of(attrs.begin(), attrs.end(), pred);
 }
 
+/// Tests whether a type has an "index" attribute with a given value, e.g.,
+/// `#index=dictionary`.
+/// @relates type
+template <class Type>
+bool has_index_attribute(const Type& t, std::string_view value) {
+  auto& attrs = t.attributes();
+  auto pred = [&](auto& x) {
+    return x.key == "index" && x.value && *x.value == value;
+  };
+  return std::any_of(attrs.begin(), attrs.end(), pred);
+}
+
 /// @relates type
 bool convert(const type& t, json& j);
 
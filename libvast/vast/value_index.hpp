@@ -14,8 +14,15 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <limits>
 #include <memory>
+#include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <caf/meta/load_callback.hpp>
 
 #include "vast/ewah_bitmap.hpp"
 #include "vast/ids.hpp"
@@ -25,11 +32,13 @@
 #include "vast/die.hpp"
 #include "vast/error.hpp"
 #include "vast/expected.hpp"
+#include "vast/table_slice.hpp"
 #include "vast/type.hpp"
 #include "vast/view.hpp"
 
 #include "vast/detail/assert.hpp"
 #include "vast/detail/overload.hpp"
+#include "vast/detail/radix_tree.hpp"
 
 namespace vast {
 
@@ -43,9 +52,20 @@ public:
 
   using size_type = typename ids::size_type;
 
+  /// The version of the mapping from types to concrete value indexes. The
+  /// mapping determines the persistent format of an index, so persisted
+  /// indexes must be read back with the version they were written with.
+  /// Version 0 indexes timestamps with an `arithmetic_index<timestamp>` and
+  /// sets and vectors with a `sequence_index`, and has no index for
+  /// enumerations and maps. Before version 2, the `subnet_index` has no
+  /// radix tree and patterns have no index.
+  static constexpr uint32_t current_version = 2;
+
   /// Constructs a value index from a given type.
   /// @param t The type to construct a value index for.
-  static std::unique_ptr<value_index> make(const type& t);
+  /// @param version The version of the mapping from types to indexes.
+  static std::unique_ptr<value_index>
+  make(const type& t, uint32_t version = current_version);
 
   /// Appends a data value.
   /// @param x The data to append to the index.
@@ -58,6 +78,17 @@ public:
   /// @returns `true` if appending succeeded.
   expected<void> append(data_view x, id pos);
 
+  /// Appends all values of a column in a table slice at the IDs of the
+  /// slice. This amortizes the per-value overhead of the other overloads by
+  /// appending runs of equal values at once.
+  /// @param slice The table slice to append.
+  /// @param column The column of *slice* to append.
+  /// @returns An error if a value in *column* has an unexpected type. The
+  ///          index then contains all runs of equal values up to the failing
+  ///          one.
+  /// @pre `column < slice.columns()`
+  expected<void> append(const table_slice& slice, size_t column);
+
   /// Looks up data under a relational operator. If the value to look up is
   /// `nil`, only `==` and `!=` are valid operations. The concrete index
   /// type determines validity of other values.
@@ -75,6 +106,17 @@ public:
   /// @returns The largest ID in the index.
   size_type offset() const;
 
+  /// Selects the concrete bitmap type of the IDs that an index keeps per
+  /// distinct value, such as the postings of a `dictionary_index`. Coders
+  /// always use EWAH bitmaps. The selection is not persisted and applies to
+  /// postings created afterwards.
+  /// @param type The bitmap type.
+  /// @pre `bitmap::valid_type(type)`
+  virtual void select_bitmap_type(caf::atom_value type);
+
+  /// @returns the bitmap type for new postings.
+  caf::atom_value bitmap_type() const;
+
   template <class Inspector>
   friend auto inspect(Inspector& f, value_index& vi) {
     return f(vi.mask_, vi.none_);
@@ -83,62 +125,118 @@ public:
 protected:
   value_index() = default;
 
+  /// Calls `f(x, pos, n)` for each run of *n* equal values *x* starting at ID
+  /// *pos* in a column of a table slice. Records `nil` values directly and
+  /// extends the mask after each run, so that the index stays consistent
+  /// when *f* fails.
+  /// @returns `false` if *f* returned `false`.
+  template <class F>
+  bool for_each_run(const table_slice& slice, size_t column, F f) {
+    auto first = slice.offset();
+    auto flush = [&](data_view x, size_t row, size_t n) {
+      if (caf::holds_alternative<caf::none_t>(x)) {
+        none_.append_bits(false, first + row - none_.size());
+        none_.append_bits(true, n);
+      } else if (!f(x, first + row, n)) {
+        return false;
+      }
+      mask_.append_bits(false, first + row - mask_.size());
+      mask_.append_bits(true, n);
+      return true;
+    };
+    auto rows = slice.rows();
+    if (rows == 0)
+      return true;
+    auto x = slice.at(0, column);
+    size_t begin = 0;
+    for (size_t row = 1; row < rows; ++row) {
+      auto y = slice.at(row, column);
+      if (y == x)
+        continue;
+      if (!flush(x, begin, row - begin))
+        return false;
+      x = y;
+      begin = row;
+    }
+    return flush(x, begin, rows - begin);
+  }
+
 private:
   virtual bool append_impl(data_view x, id pos) = 0;
 
+  /// Appends a column of a table slice. Implementations must go through
+  /// ::for_each_run, which maintains the mask. The default implementation
+  /// appends the values of each run one by one.
+  virtual bool append_column_impl(const table_slice& slice, size_t column);
+
   virtual expected<ids>
   lookup_impl(relational_operator op, data_view x) const = 0;
 
   ewah_bitmap mask_;
   ewah_bitmap none_;
+  caf::atom_value bitmap_type_ = caf::atom("ewah");
 };
 
 namespace detail {
 
-template <class Index, class Sequence>
+/// The minimum number of elements for which a lookup of the form
+/// `x in [...]` probes the index with all elements at once, if the index
+/// supports it.
+constexpr size_t bulk_lookup_threshold = 16;
+
+/// Looks up the elements of a container and combines the hits.
+/// @param idx The index to look up the elements in.
+/// @param op Either `in` or `not_in`.
+/// @param xs The elements to look up.
+/// @param bulk An optional function that maps a `std::vector<data_view>` to
+///             the IDs of all values equal to any of its elements. For
+///             containers with at least `bulk_lookup_threshold` elements,
+///             it replaces the equality lookups of each element.
+template <class Index, class Sequence, class Bulk = std::nullptr_t>
 expected<ids> container_lookup_impl(const Index& idx, relational_operator op,
-                               const Sequence& xs) {
-  ids result;
-  if (op == in) {
-    result = bitmap{idx.offset(), false};
-    for (auto x : xs) {
-      auto r = idx.lookup(equal, x);
-      if (r)
-        result |= *r;
-      else
-        return r;
-      if (all<1>(result)) // short-circuit
-        return result;
-    }
-  } else if (op == not_in) {
-    result = bitmap{idx.offset(), true};
-    for (auto x : xs) {
-      auto r = idx.lookup(equal, x);
-      if (r)
-        result -= *r;
-      else
-        return r;
-      if (all<0>(result)) // short-circuit
-        return result;
-    }
-  } else {
+                                    const Sequence& xs, Bulk bulk = nullptr) {
+  if (op != in && op != not_in)
     return make_error(ec::unsupported_operator, op);
+  auto finish = [&](const ids& matches) -> expected<ids> {
+    if (op == in)
+      return bitmap{idx.offset(), false} | matches;
+    return bitmap{idx.offset(), true} - matches;
+  };
+  if constexpr (!std::is_same_v<Bulk, std::nullptr_t>) {
+    if (xs.size() >= bulk_lookup_threshold) {
+      std::vector<data_view> elements;
+      elements.reserve(xs.size());
+      for (auto x : xs)
+        elements.push_back(x);
+      auto matches = bulk(elements);
+      if (!matches)
+        return matches;
+      return finish(*matches);
+    }
   }
-  return result;
+  // Combine the hits of all elements at once rather than one at a time.
+  std::vector<ids> hits;
+  for (auto x : xs) {
+    auto r = idx.lookup(equal, x);
+    if (!r)
+      return r;
+    hits.push_back(std::move(*r));
+  }
+  return finish(nary_or(hits.begin(), hits.end()));
 }
 
-template <class Index>
+template <class Index, class Bulk = std::nullptr_t>
 expected<ids> container_lookup(const Index& idx, relational_operator op,
-                               view<vector> xs) {
+                               view<vector> xs, Bulk bulk = nullptr) {
   VAST_ASSERT(xs);
-  return container_lookup_impl(idx, op, *xs);
+  return container_lookup_impl(idx, op, *xs, std::move(bulk));
 }
 
-template <class Index>
+template <class Index, class Bulk = std::nullptr_t>
 expected<ids> container_lookup(const Index& idx, relational_operator op,
-                               view<set> xs) {
+                               view<set> xs, Bulk bulk = nullptr) {
   VAST_ASSERT(xs);
-  return container_lookup_impl(idx, op, *xs);
+  return container_lookup_impl(idx, op, *xs, std::move(bulk));
 }
 
 } // namespace detail
@@ -203,9 +301,19 @@ public:
 
 private:
   bool append_impl(data_view d, id pos) override {
+    return append_run(d, pos, 1);
+  }
+
+  bool append_column_impl(const table_slice& slice, size_t column) override {
+    return for_each_run(slice, column, [&](data_view d, id pos, size_t n) {
+      return append_run(d, pos, n);
+    });
+  }
+
+  bool append_run(data_view d, id pos, size_t n) {
     auto append = [&](auto x) {
       bmi_.skip(pos - bmi_.size());
-      bmi_.append(x);
+      bmi_.append(x, n);
       return true;
     };
     return caf::visit(detail::overload(
@@ -243,6 +351,70 @@ private:
   bitmap_index_type bmi_;
 };
 
+/// An index for timestamps that exploits their mostly ascending order. The
+/// index stores the values in blocks of consecutive IDs, along with the
+/// minimum and maximum of each block. A lookup emits blocks that match as a
+/// whole as runs of IDs, skips blocks that cannot match, and decodes only the
+/// remaining blocks. In blocks of ascending values, a binary search finds the
+/// boundaries of the matching values. Unlike an `arithmetic_index<timestamp>`,
+/// the index retains the full precision of the timestamps. Each block stores
+/// the differences between consecutive values in variable-byte encoding.
+/// Timestamp types with a `#base` attribute get an
+/// `arithmetic_index<timestamp>` instead.
+class time_index : public value_index {
+public:
+  /// The number of values per block.
+  static constexpr size_t block_size = 4096;
+
+  time_index() = default;
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, time_index& idx) {
+    return f(static_cast<value_index&>(idx), idx.blocks_, idx.runs_);
+  }
+
+private:
+  using rep = timestamp::rep;
+
+  /// A sequence of up to `block_size` values.
+  struct block {
+    rep min = 0;
+    rep max = 0;
+    rep last = 0;
+    uint32_t size = 0;
+    bool ascending = true;
+    std::vector<uint8_t> bytes;
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, block& x) {
+      return f(x.min, x.max, x.last, x.size, x.ascending, x.bytes);
+    }
+  };
+
+  bool append_impl(data_view x, id pos) override;
+
+  bool append_column_impl(const table_slice& slice, size_t column) override;
+
+  bool append_run(data_view x, id pos, size_t n);
+
+  expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  /// Looks up many timestamps at once. Only blocks whose bounds enclose one
+  /// of the timestamps need decoding.
+  expected<ids> bulk_lookup(const std::vector<data_view>& xs) const;
+
+  /// Decodes the values of a block.
+  static void decode(const block& x, std::vector<rep>& out);
+
+  /// The values in order of their IDs.
+  std::vector<block> blocks_;
+
+  /// Runs of consecutive IDs as pairs of first ID and length. The i-th value
+  /// in `blocks_` has the i-th ID in these runs.
+  std::vector<std::pair<id, uint64_t>> runs_;
+};
+
 /// An index for strings.
 class string_index : public value_index {
 public:
@@ -268,6 +440,10 @@ private:
 
   bool append_impl(data_view x, id pos) override;
 
+  bool append_column_impl(const table_slice& slice, size_t column) override;
+
+  bool append_run(data_view x, id pos, size_t n);
+
   expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
@@ -276,6 +452,79 @@ private:
   std::vector<char_bitmap_index> chars_;
 };
 
+/// An index for strings that maps each distinct value to the bitmap of its
+/// occurrences. Equality lookups cost a single hash table probe, independent
+/// of the string length. Substring lookups scan all distinct values. Select
+/// this index for a string type with the attribute `#index=dictionary`.
+class dictionary_index : public value_index {
+public:
+  dictionary_index() = default;
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, dictionary_index& idx) {
+    auto load = [&]() -> caf::error {
+      idx.rebuild_codes();
+      return caf::none;
+    };
+    return f(static_cast<value_index&>(idx), idx.values_, idx.postings_,
+             caf::meta::load_callback(load));
+  }
+
+private:
+  /// @returns the position of *x* in `values_` or `values_.size()` if *x* is
+  ///          not in the dictionary.
+  size_t find(std::string_view x) const;
+
+  /// Restores `codes_` from `values_`.
+  void rebuild_codes();
+
+  bool append_impl(data_view x, id pos) override;
+
+  bool append_column_impl(const table_slice& slice, size_t column) override;
+
+  bool append_run(data_view x, id pos, size_t n);
+
+  expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  /// Looks up many strings at once with a single hash table probe each.
+  expected<ids> bulk_lookup(const std::vector<data_view>& xs) const;
+
+  /// Maps the hash of a value to its positions in `values_`.
+  std::unordered_multimap<size_t, size_t> codes_;
+
+  /// The distinct values in order of appearance.
+  std::vector<std::string> values_;
+
+  /// The occurrences of each value in `values_`. The postings have the
+  /// selected bitmap type, such that lookup results combine with other IDs
+  /// of that type without converting between encodings.
+  std::vector<ids> postings_;
+};
+
+/// An index for patterns that answers equality with a pattern. Columns tend
+/// to hold few distinct patterns, so a dictionary over the pattern strings
+/// keeps their occurrences.
+class pattern_index : public value_index {
+public:
+  pattern_index() = default;
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, pattern_index& idx) {
+    return f(static_cast<value_index&>(idx), idx.dictionary_);
+  }
+
+  void select_bitmap_type(caf::atom_value type) override;
+
+private:
+  bool append_impl(data_view x, id pos) override;
+
+  expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  dictionary_index dictionary_;
+};
+
 /// An index for IP addresses.
 class address_index : public value_index {
 public:
@@ -294,6 +543,10 @@ private:
 
   bool append_impl(data_view x, id pos) override;
 
+  bool append_column_impl(const table_slice& slice, size_t column) override;
+
+  bool append_run(data_view x, id pos, size_t n);
+
   expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
@@ -301,21 +554,106 @@ private:
   type_index v4_;
 };
 
-/// An index for subnets.
+/// An index for IP addresses that groups IDs by address prefix. For every
+/// prefix length from 1 to 16 bytes, the index keeps a radix tree that maps
+/// each distinct prefix to the IDs of all addresses with that prefix, so an
+/// address appears in 16 bitmaps. A subnet lookup picks the shortest prefix
+/// length in bytes at least as long as the subnet and unions the bitmaps of
+/// the at most 128 prefixes inside the subnet. A range lookup decomposes the
+/// range into at most 128 subnets. Select this index for an address type with
+/// the attribute `#index=radix`.
+class radix_address_index : public value_index {
+public:
+  /// The number of prefix lengths in bytes for which the index keeps IDs.
+  static constexpr size_t num_levels = 16;
+
+  radix_address_index() = default;
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, radix_address_index& idx) {
+    auto load = [&]() -> caf::error {
+      idx.rebuild_trees();
+      return caf::none;
+    };
+    return f(static_cast<value_index&>(idx), idx.levels_,
+             caf::meta::load_callback(load));
+  }
+
+private:
+  /// The distinct prefixes of a single length.
+  struct level {
+    /// The prefixes in order of appearance.
+    std::vector<std::string> prefixes;
+
+    /// The IDs of the addresses with each prefix.
+    std::vector<ids> postings;
+
+    /// Maps a prefix to its position in `prefixes`.
+    detail::radix_tree<size_t> tree;
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, level& x) {
+      return f(x.prefixes, x.postings);
+    }
+  };
+
+  /// Restores the radix trees from the prefixes of all levels.
+  void rebuild_trees();
+
+  /// @returns the IDs of all addresses whose first *bits* bits equal the
+  ///          ones of *bytes*.
+  ids lookup_prefix(const std::array<uint8_t, 16>& bytes, size_t bits) const;
+
+  bool append_impl(data_view x, id pos) override;
+
+  bool append_column_impl(const table_slice& slice, size_t column) override;
+
+  bool append_run(data_view x, id pos, size_t n);
+
+  expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  /// Looks up many addresses at once with a single tree probe each.
+  expected<ids> bulk_lookup(const std::vector<data_view>& xs) const;
+
+  /// The prefixes of *i + 1* bytes at position *i*.
+  std::array<level, num_levels> levels_;
+};
+
+/// An index for subnets. From version 2 on, the index also keeps a radix
+/// tree over the distinct subnets, so that a `ni` lookup collects the
+/// subnets that include its operand with a single walk down the tree.
 class subnet_index : public value_index {
 public:
   using prefix_index = bitmap_index<uint8_t, equality_coder<ewah_bitmap>>;
 
-  subnet_index() = default;
+  /// Constructs a subnet index.
+  /// @param version The version of the mapping from types to indexes.
+  explicit subnet_index(uint32_t version = current_version);
 
   template <class Inspector>
   friend auto inspect(Inspector& f, subnet_index& idx) {
-    return f(static_cast<value_index&>(idx), idx.network_, idx.length_);
+    if (!idx.has_tree())
+      return f(static_cast<value_index&>(idx), idx.network_, idx.length_);
+    auto load = [&]() -> caf::error {
+      idx.rebuild_tree();
+      return caf::none;
+    };
+    return f(static_cast<value_index&>(idx), idx.network_, idx.length_,
+             idx.prefixes_, idx.postings_, caf::meta::load_callback(load));
   }
 
 private:
+  /// @returns the prefix bits of *x*, one character per bit.
+  static std::string key(const subnet& x);
+
   void init();
 
+  bool has_tree() const;
+
+  /// Restores the radix tree from the prefixes.
+  void rebuild_tree();
+
   bool append_impl(data_view x, id pos) override;
 
   expected<ids>
@@ -323,6 +661,17 @@ private:
 
   address_index network_;
   prefix_index length_;
+
+  /// The distinct subnets in order of appearance.
+  std::vector<std::string> prefixes_;
+
+  /// The IDs of each subnet in `prefixes_`.
+  std::vector<ids> postings_;
+
+  /// Maps a subnet to its position in `prefixes_`.
+  detail::radix_tree<size_t> tree_;
+
+  uint32_t version_;
 };
 
 /// An index for ports.
@@ -352,6 +701,10 @@ private:
 
   bool append_impl(data_view x, id pos) override;
 
+  bool append_column_impl(const table_slice& slice, size_t column) override;
+
+  bool append_run(data_view x, id pos, size_t n);
+
   expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
@@ -359,6 +712,40 @@ private:
   protocol_index proto_;
 };
 
+/// An equality-coded index for enumerations. The type defines the domain of
+/// the values, so the index holds one bitmap per field. Views represent
+/// enumeration values as counts. Lookups accept the numeric value of a field
+/// as well as its name.
+class enumeration_index : public value_index {
+public:
+  using index_type = bitmap_index<enumeration, equality_coder<ewah_bitmap>>;
+
+  /// Constructs an enumeration index.
+  /// @param fields The names of the enumeration fields.
+  explicit enumeration_index(std::vector<std::string> fields = {});
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, enumeration_index& idx) {
+    return f(static_cast<value_index&>(idx), idx.fields_, idx.index_);
+  }
+
+private:
+  bool append_impl(data_view x, id pos) override;
+
+  bool append_column_impl(const table_slice& slice, size_t column) override;
+
+  bool append_run(data_view x, id pos, size_t n);
+
+  expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  /// Looks up the field with numeric value *x*.
+  expected<ids> lookup_field(relational_operator op, enumeration x) const;
+
+  std::vector<std::string> fields_;
+  index_type index_;
+};
+
 /// An index for vectors and sets.
 class sequence_index : public value_index {
 public:
@@ -366,7 +753,10 @@ public:
   /// @param t The element type of the sequence.
   /// @param max_size The maximum number of elements permitted per sequence.
   ///                 Longer sequences will be trimmed at the end.
-  sequence_index(vast::type t = {}, size_t max_size = 128);
+  /// @param version The version of the mapping from types to indexes for
+  ///                the elements.
+  sequence_index(vast::type t = {}, size_t max_size = 128,
+                 uint32_t version = current_version);
 
   /// The bitmap index holding the sequence size.
   using size_bitmap_index =
@@ -375,6 +765,8 @@ public:
   friend void serialize(caf::serializer& sink, const sequence_index& idx);
   friend void serialize(caf::deserializer& source, sequence_index& idx);
 
+  void select_bitmap_type(caf::atom_value type) override;
+
 private:
   void init();
 
@@ -388,8 +780,9 @@ private:
       auto old = elements_.size();
       elements_.resize(seq_size);
       for (auto i = old; i < elements_.size(); ++i) {
-        elements_[i] = value_index::make(value_type_);
+        elements_[i] = value_index::make(value_type_, version_);
         VAST_ASSERT(elements_[i]);
+        elements_[i]->select_bitmap_type(bitmap_type());
       }
     }
     auto x = c.begin();
@@ -409,19 +802,119 @@ private:
   size_bitmap_index size_;
   size_t max_size_;
   vast::type value_type_;
+  uint32_t version_;
+};
+
+/// An inverted index for the elements of sets and vectors and the keys of
+/// maps. Unlike a `sequence_index`, which keeps one value index per element
+/// position, this index maps each distinct element to the IDs of the
+/// containers that include it. Its size grows with the number of distinct
+/// elements rather than with the length of the longest container, and a
+/// membership lookup costs a single hash table probe. A separate bitmap
+/// index holds the container sizes, which answers equality with the empty
+/// container.
+class membership_index : public value_index {
+public:
+  /// The bitmap index holding the container size.
+  using size_bitmap_index = sequence_index::size_bitmap_index;
+
+  membership_index();
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, membership_index& idx) {
+    return f(static_cast<value_index&>(idx), idx.postings_, idx.size_);
+  }
+
+private:
+  template <class Container>
+  bool container_append(Container& c, id pos) {
+    for (auto element : c) {
+      data_view x;
+      if constexpr (std::is_same_v<decltype(element), data_view>)
+        x = element;
+      else
+        x = element.first;
+      auto& bm = postings_.try_emplace(key(x), bitmap_type()).first->second;
+      // Vectors may contain an element more than once.
+      if (bm.size() > pos)
+        continue;
+      bm.append_bits(false, pos - bm.size());
+      bm.append_bit(true);
+    }
+    auto n = std::min(c.size(), size_t{std::numeric_limits<uint32_t>::max()});
+    size_.skip(pos - size_.size());
+    size_.append(n);
+    return true;
+  }
+
+  /// @returns the normalized hash table key for *x*. Integers and counts
+  ///          with the same value map to the same key, so that the index
+  ///          answers lookups regardless of the numeric type of the query.
+  static data key(data_view x);
+
+  /// @returns whether *x* is a vector, set, or map without elements.
+  static bool is_empty_container(data_view x);
+
+  bool append_impl(data_view x, id pos) override;
+
+  expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  /// Maps each distinct element to the IDs of the containers with it.
+  std::unordered_map<data, ids> postings_;
+
+  size_bitmap_index size_;
 };
 
 namespace detail {
 
+/// Tests whether a set or vector type selects the positional
+/// `sequence_index` instead of the `membership_index`, either with
+/// `#index=sequence` or by limiting the container size with `#max_size`.
+/// Version 0 always uses the `sequence_index`.
+template <class Type>
+bool has_sequence_index(const Type& t, uint32_t version) {
+  if (version == 0 || has_index_attribute(t, "sequence"))
+    return true;
+  auto& attrs = t.attributes();
+  auto pred = [](auto& x) { return x.key == "max_size"; };
+  return std::any_of(attrs.begin(), attrs.end(), pred);
+}
+
+/// Tests whether a string type selects the `dictionary_index` with
+/// `#index=dictionary`. Version 0 always uses the `string_index`.
+inline bool has_dictionary_index(const string_type& t, uint32_t version) {
+  return version > 0 && has_index_attribute(t, "dictionary");
+}
+
+/// Tests whether an address type selects the `radix_address_index` with
+/// `#index=radix`. Version 0 always uses the `address_index`.
+inline bool has_radix_index(const address_type& t, uint32_t version) {
+  return version > 0 && has_index_attribute(t, "radix");
+}
+
+/// Tests whether a timestamp type selects the `time_index`. Version 0 and
+/// types with a `#base` attribute use an `arithmetic_index<timestamp>`,
+/// which honors the base.
+inline bool has_time_index(const timestamp_type& t, uint32_t version) {
+  if (version == 0)
+    return false;
+  auto& attrs = t.attributes();
+  auto pred = [](auto& x) { return x.key == "base"; };
+  return std::none_of(attrs.begin(), attrs.end(), pred);
+}
+
 struct value_index_inspect_helper {
   const vast::type& type;
   std::unique_ptr<value_index>& idx;
+  uint32_t version = value_index::current_version;
 
   template <class Inspector>
   struct down_cast {
     using result_type = typename Inspector::result_type;
 
-    down_cast(value_index& idx, Inspector& f) : idx_{idx}, f_{f} {
+    down_cast(value_index& idx, Inspector& f, uint32_t version)
+      : idx_{idx}, f_{f}, version_{version} {
       // nop
     }
 
@@ -450,15 +943,25 @@ struct value_index_inspect_helper {
       return f_(static_cast<arithmetic_index<timespan>&>(idx_));
     }
 
-    result_type operator()(const timestamp_type&) const {
-      return f_(static_cast<arithmetic_index<timestamp>&>(idx_));
+    result_type operator()(const timestamp_type& t) const {
+      if (!has_time_index(t, version_))
+        return f_(static_cast<arithmetic_index<timestamp>&>(idx_));
+      return f_(static_cast<time_index&>(idx_));
     }
 
-    result_type operator()(const string_type&) const {
+    result_type operator()(const string_type& t) const {
+      if (has_dictionary_index(t, version_))
+        return f_(static_cast<dictionary_index&>(idx_));
       return f_(static_cast<string_index&>(idx_));
     }
 
-    result_type operator()(const address_type&) const {
+    result_type operator()(const pattern_type&) const {
+      return f_(static_cast<pattern_index&>(idx_));
+    }
+
+    result_type operator()(const address_type& t) const {
+      if (has_radix_index(t, version_))
+        return f_(static_cast<radix_address_index&>(idx_));
       return f_(static_cast<address_index&>(idx_));
     }
 
@@ -470,12 +973,24 @@ struct value_index_inspect_helper {
       return f_(static_cast<port_index&>(idx_));
     }
 
-    result_type operator()(const vector_type&) const {
-      return f_(static_cast<sequence_index&>(idx_));
+    result_type operator()(const enumeration_type&) const {
+      return f_(static_cast<enumeration_index&>(idx_));
     }
 
-    result_type operator()(const set_type&) const {
-      return f_(static_cast<sequence_index&>(idx_));
+    result_type operator()(const vector_type& t) const {
+      if (has_sequence_index(t, version_))
+        return f_(static_cast<sequence_index&>(idx_));
+      return f_(static_cast<membership_index&>(idx_));
+    }
+
+    result_type operator()(const set_type& t) const {
+      if (has_sequence_index(t, version_))
+        return f_(static_cast<sequence_index&>(idx_));
+      return f_(static_cast<membership_index&>(idx_));
+    }
+
+    result_type operator()(const map_type&) const {
+      return f_(static_cast<membership_index&>(idx_));
     }
 
     result_type operator()(const alias_type& t) const {
@@ -484,6 +999,7 @@ struct value_index_inspect_helper {
 
     value_index& idx_;
     Inspector& f_;
+    uint32_t version_;
   };
 
   struct default_construct {
@@ -514,45 +1030,70 @@ struct value_index_inspect_helper {
       return std::make_unique<arithmetic_index<timespan>>();
     }
 
-    result_type operator()(const timestamp_type&) const {
-      return std::make_unique<arithmetic_index<timestamp>>();
+    result_type operator()(const timestamp_type& t) const {
+      if (!has_time_index(t, version))
+        return std::make_unique<arithmetic_index<timestamp>>();
+      return std::make_unique<time_index>();
     }
 
-    result_type operator()(const string_type&) const {
+    result_type operator()(const string_type& t) const {
+      if (has_dictionary_index(t, version))
+        return std::make_unique<dictionary_index>();
       return std::make_unique<string_index>();
     }
 
-    result_type operator()(const address_type&) const {
+    result_type operator()(const pattern_type&) const {
+      return std::make_unique<pattern_index>();
+    }
+
+    result_type operator()(const address_type& t) const {
+      if (has_radix_index(t, version))
+        return std::make_unique<radix_address_index>();
       return std::make_unique<address_index>();
     }
 
     result_type operator()(const subnet_type&) const {
-      return std::make_unique<subnet_index>();
+      return std::make_unique<subnet_index>(version);
     }
 
     result_type operator()(const port_type&) const {
       return std::make_unique<port_index>();
     }
 
-    result_type operator()(const vector_type&) const {
-      return std::make_unique<sequence_index>();
+    result_type operator()(const enumeration_type& t) const {
+      return std::make_unique<enumeration_index>(t.fields);
     }
 
-    result_type operator()(const set_type&) const {
-      return std::make_unique<sequence_index>();
+    result_type operator()(const vector_type& t) const {
+      if (has_sequence_index(t, version))
+        return std::make_unique<sequence_index>(vast::type{}, 128, version);
+      return std::make_unique<membership_index>();
+    }
+
+    result_type operator()(const set_type& t) const {
+      if (has_sequence_index(t, version))
+        return std::make_unique<sequence_index>(vast::type{}, 128, version);
+      return std::make_unique<membership_index>();
+    }
+
+    result_type operator()(const map_type&) const {
+      return std::make_unique<membership_index>();
     }
 
     result_type operator()(const alias_type& t) const {
       return caf::visit(*this, t.value_type);
     }
+
+    uint32_t version;
   };
 
   template <class Inspector>
   friend auto inspect(Inspector& f, value_index_inspect_helper& helper) {
     if (Inspector::writes_state)
-      helper.idx = caf::visit(default_construct{}, helper.type);
+      helper.idx = caf::visit(default_construct{helper.version}, helper.type);
     VAST_ASSERT(helper.idx);
-    return caf::visit(down_cast<Inspector>{*helper.idx, f}, helper.type);
+    down_cast<Inspector> g{*helper.idx, f, helper.version};
+    return caf::visit(g, helper.type);
   }
 };
 
@@ -144,6 +144,67 @@ private:
 
 wah_bitmap_range bit_range(const wah_bitmap& bm);
 
+/// Walks the blocks of a WAH bitmap at word granularity. In contrast to
+/// ::wah_bitmap_range, the cursor exposes stretches of literal words in place
+/// so that algorithms can process them in bulk.
+/// @relates wah_bitmap
+class wah_bitmap_cursor {
+public:
+  using block_type = wah_bitmap::block_type;
+  using size_type = wah_bitmap::size_type;
+  using word_type = wah_bitmap::word_type;
+
+  static constexpr size_type width = word_type::literal_word_size;
+
+  explicit wah_bitmap_cursor(const wah_bitmap& bm);
+
+  /// @returns the number of fill words at the current position.
+  size_type clean() const {
+    return clean_;
+  }
+
+  /// @returns the value of the fill words at the current position.
+  bool fill() const {
+    return fill_;
+  }
+
+  /// @returns the number of consecutive literal words at the current
+  ///          position.
+  size_type dirty() const {
+    return dirty_;
+  }
+
+  /// @returns a pointer to the first literal word at the current position.
+  const block_type* literals() const {
+    return literals_;
+  }
+
+  /// Advances the cursor within the current fill or literal stretch.
+  /// @param n The number of words to skip.
+  /// @pre `n <= clean()` or `clean() == 0 && n <= dirty()`
+  void skip(size_type n);
+
+private:
+  void scan();
+
+  const block_type* next_;
+  const block_type* end_;
+  const block_type* literals_ = nullptr;
+  size_type clean_ = 0;
+  size_type dirty_ = 0;
+  bool fill_ = false;
+};
+
+// -- algorithms ---------------------------------------------------------------
+
+/// Applies a bitwise operation on two WAH bitmaps directly on their blocks.
+/// @relates wah_bitmap
+template <bool FillLHS, bool FillRHS, class Operation>
+wah_bitmap binary_eval(const wah_bitmap& lhs, const wah_bitmap& rhs,
+                       Operation op) {
+  return detail::word_eval<FillLHS, FillRHS, wah_bitmap_cursor>(lhs, rhs, op);
+}
+
 } // namespace vast
 
 
@@ -15,9 +15,12 @@
 
 #include <caf/all.hpp>
 
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/detail/spawn_container_source.hpp"
+#include "vast/ids.hpp"
 #include "vast/query_options.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/to_events.hpp"
 #include "vast/uuid.hpp"
 
 #include "vast/system/node.hpp"
@@ -85,10 +88,10 @@ std::vector<event> node::query(std::string expr) {
   std::vector<event> result;
   auto done = false;
   self->do_receive(
-    [&](std::vector<event>& xs) {
-      MESSAGE("... got " << xs.size() << " events");
-      result.insert(result.end(), std::make_move_iterator(xs.begin()),
-                    std::make_move_iterator(xs.end()));
+    [&](const std::vector<table_slice_ptr>& slices, const ids& rows) {
+      MESSAGE("... got " << rank(rows) << " events");
+      for (auto& slice : slices)
+        to_events(result, *slice, rows);
     },
     [&](const uuid&, const system::query_statistics&) {
       // ignore
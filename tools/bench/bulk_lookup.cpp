@@ -0,0 +1,113 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/columnar_table_slice.hpp"
+#include "vast/evaluate.hpp"
+#include "vast/expression.hpp"
+#include "vast/expression_visitors.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/table_slice_builder.hpp"
+#include "vast/type.hpp"
+#include "vast/value_index.hpp"
+
+using namespace caf;
+using namespace std;
+using namespace vast;
+
+namespace {
+
+// Runs *f*, which returns the IDs of all matches, and prints its runtime.
+template <class F>
+void measure(const char* name, size_t n, F f) {
+  auto start = chrono::steady_clock::now();
+  auto result = f();
+  auto stop = chrono::steady_clock::now();
+  auto ms = chrono::duration<double, milli>(stop - start).count();
+  cout << left << setw(36) << name << right << setw(8) << n << " elements"
+       << setw(12) << fixed << setprecision(2) << ms << " ms" << setw(10)
+       << rank(result) << " hits" << endl;
+}
+
+std::string make_domain(size_t i) {
+  return "host" + std::to_string(i) + ".example.com";
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  auto rows = size_t{1} << 18;
+  auto distinct = size_t{100000};
+  auto seed = size_t{42};
+  auto r = message_builder{argv + 1, argv + argc}.extract_opts({
+    {"rows,r", "number of indexed values", rows},
+    {"distinct,d", "number of distinct values", distinct},
+    {"seed,s", "seed for the random values", seed},
+  });
+  if (!r.error.empty() || r.opts.count("help") > 0) {
+    cerr << r.error << "\n\n" << r.helptext;
+    return 1;
+  }
+  mt19937_64 gen{seed};
+  uniform_int_distribution<size_t> pick{0, distinct - 1};
+  cout << "indexing " << rows << " values with " << distinct
+       << " distinct domains" << endl;
+  auto idx = value_index::make(
+    string_type{}.attributes({{"index", "dictionary"}}));
+  type event_layout = record_type{{"s", string_type{}}}.name("bench");
+  auto layout = caf::get<record_type>(event_layout);
+  layout.fields.insert(layout.fields.begin(),
+                       record_field{"timestamp", timestamp_type{}});
+  auto builder = columnar_table_slice::make_builder(layout);
+  for (size_t i = 0; i < rows; ++i) {
+    auto domain = make_domain(pick(gen));
+    idx->append(make_data_view(domain));
+    builder->add(make_data_view(timestamp{}));
+    builder->add(make_data_view(domain));
+  }
+  auto slice = builder->finish();
+  // Half of the elements of each list occur in the data.
+  for (auto n : {size_t{1000}, size_t{10000}, size_t{100000}}) {
+    vast::vector xs;
+    for (size_t i = 0; i < n; ++i)
+      xs.emplace_back(make_domain(i % 2 == 0 ? pick(gen) : distinct + i));
+    measure("index: one lookup per element", n, [&] {
+      std::vector<ids> hits;
+      for (auto& x : xs)
+        hits.push_back(*idx->lookup(equal, make_view(x)));
+      return nary_or(hits.begin(), hits.end());
+    });
+    measure("index: bulk lookup", n, [&] {
+      return *idx->lookup(in, make_data_view(xs));
+    });
+    auto ast = expression{predicate{key_extractor{"s"}, in, data{xs}}};
+    auto expr = caf::visit(type_resolver{event_layout}, ast);
+    if (!expr) {
+      cerr << "failed to resolve expression" << endl;
+      return 1;
+    }
+    measure("column: hash probing", n, [&] {
+      return evaluate(*expr, *slice);
+    });
+  }
+}
@@ -0,0 +1,146 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/columnar_table_slice.hpp"
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/evaluate.hpp"
+#include "vast/event.hpp"
+#include "vast/expression.hpp"
+#include "vast/expression_visitors.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/table_slice_builder.hpp"
+#include "vast/to_events.hpp"
+#include "vast/type.hpp"
+
+using namespace caf;
+using namespace std;
+using namespace vast;
+
+namespace {
+
+// Runs *f*, which returns the number of matching rows, and prints its
+// throughput.
+template <class F>
+void measure(const char* name, size_t rows, F f) {
+  auto start = chrono::steady_clock::now();
+  auto hits = f();
+  auto stop = chrono::steady_clock::now();
+  auto ms = chrono::duration<double, milli>(stop - start).count();
+  cout << left << setw(40) << name << right << setw(10) << fixed
+       << setprecision(2) << ms << " ms" << setw(14) << setprecision(0)
+       << (rows / ms * 1e3) << " rows/s" << setw(10) << hits << " hits"
+       << endl;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  auto num_slices = size_t{100};
+  auto slice_size = size_t{1024};
+  auto query = "c > 1000 && r < 0.5 || s == \"foo\""s;
+  auto r = message_builder{argv + 1, argv + argc}.extract_opts({
+    {"slices,n", "number of table slices", num_slices},
+    {"rows,r", "number of rows per table slice", slice_size},
+    {"query,q", "expression to evaluate", query},
+  });
+  if (!r.error.empty() || r.opts.count("help") > 0) {
+    cerr << r.error << "\n\n" << r.helptext;
+    return 1;
+  }
+  // Events and expressions refer to the layout without the timestamp column.
+  type event_layout = record_type{
+    {"c", count_type{}},
+    {"i", integer_type{}},
+    {"r", real_type{}},
+    {"s", string_type{}}
+  }.name("bench");
+  auto layout = caf::get<record_type>(event_layout);
+  layout.fields.insert(layout.fields.begin(),
+                       record_field{"timestamp", timestamp_type{}});
+  cout << "generating " << num_slices << " table slices with " << slice_size
+       << " rows" << endl;
+  auto slices = make_random_table_slices(num_slices, slice_size, layout);
+  if (!slices) {
+    cerr << "failed to generate table slices" << endl;
+    return 1;
+  }
+  std::vector<table_slice_ptr> columnar_slices;
+  for (auto& slice : *slices) {
+    auto builder = columnar_table_slice::make_builder(layout);
+    for (size_t row = 0; row < slice->rows(); ++row)
+      for (size_t col = 0; col < slice->columns(); ++col)
+        builder->add(slice->at(row, col));
+    auto copy = builder->finish();
+    copy.unshared().offset(slice->offset());
+    columnar_slices.push_back(std::move(copy));
+  }
+  std::vector<event> events;
+  for (auto& slice : *slices)
+    to_events(events, *slice);
+  auto ast = to<expression>(query);
+  if (!ast) {
+    cerr << "invalid query: " << query << endl;
+    return 1;
+  }
+  auto expr = caf::visit(type_resolver{event_layout}, *ast);
+  if (!expr) {
+    cerr << "failed to resolve query: " << query << endl;
+    return 1;
+  }
+  auto rows = num_slices * slice_size;
+  cout << "evaluating " << query << endl;
+  measure("to_events + event_evaluator", rows, [&] {
+    size_t hits = 0;
+    for (auto& slice : *slices)
+      for (auto& e : to_events(*slice))
+        hits += caf::visit(event_evaluator{e}, *expr);
+    return hits;
+  });
+  measure("event_evaluator", rows, [&] {
+    size_t hits = 0;
+    for (auto& e : events)
+      hits += caf::visit(event_evaluator{e}, *expr);
+    return hits;
+  });
+  measure("table_slice_row_evaluator", rows, [&] {
+    size_t hits = 0;
+    for (auto& slice : *slices)
+      for (size_t row = 0; row < slice->rows(); ++row)
+        hits += caf::visit(
+          table_slice_row_evaluator{*slice, row, event_layout}, *expr);
+    return hits;
+  });
+  measure("evaluate (default_table_slice)", rows, [&] {
+    size_t hits = 0;
+    for (auto& slice : *slices)
+      hits += rank(evaluate(*expr, *slice));
+    return hits;
+  });
+  measure("evaluate (columnar_table_slice)", rows, [&] {
+    size_t hits = 0;
+    for (auto& slice : columnar_slices)
+      hits += rank(evaluate(*expr, *slice));
+    return hits;
+  });
+}
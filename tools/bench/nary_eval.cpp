@@ -0,0 +1,101 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/ewah_bitmap.hpp"
+
+using namespace caf;
+using namespace vast;
+
+namespace {
+
+// Runs *f*, which returns a bitmap, and prints its runtime.
+template <class F>
+void measure(const char* name, size_t n, F f) {
+  auto start = std::chrono::steady_clock::now();
+  auto result = f();
+  auto stop = std::chrono::steady_clock::now();
+  auto ms = std::chrono::duration<double, std::milli>(stop - start).count();
+  std::cout << std::left << std::setw(30) << name << std::right
+            << std::setw(8) << n << " bitmaps" << std::setw(12) << std::fixed
+            << std::setprecision(2) << ms << " ms" << std::setw(12)
+            << rank(result) << " hits" << std::endl;
+}
+
+// Generates the bitmaps of an equality-coded index over *rows* values, where
+// each bitmap has a few clusters of ones.
+std::vector<ewah_bitmap> make_bitmaps(size_t n, size_t rows, size_t seed) {
+  std::mt19937_64 gen{seed};
+  std::uniform_int_distribution<size_t> offset{0, rows - 1};
+  std::uniform_int_distribution<size_t> length{1, 256};
+  std::vector<ewah_bitmap> result(n);
+  for (auto& bm : result) {
+    std::vector<std::pair<size_t, size_t>> clusters(4);
+    for (auto& [first, last] : clusters) {
+      first = offset(gen);
+      last = std::min(rows, first + length(gen));
+    }
+    std::sort(clusters.begin(), clusters.end());
+    for (auto& [first, last] : clusters) {
+      if (first < bm.size())
+        first = bm.size();
+      if (first >= last)
+        continue;
+      bm.append_bits(false, first - bm.size());
+      for (auto i = first; i < last; ++i)
+        bm.append_bit(gen() % 3 != 0);
+    }
+    bm.append_bits(false, rows - bm.size());
+  }
+  return result;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  auto rows = size_t{1} << 20;
+  auto seed = size_t{42};
+  auto r = message_builder{argv + 1, argv + argc}.extract_opts({
+    {"rows,r", "number of bits per bitmap", rows},
+    {"seed,s", "seed for the random bitmaps", seed},
+  });
+  if (!r.error.empty() || r.opts.count("help") > 0) {
+    std::cerr << r.error << "\n\n" << r.helptext;
+    return 1;
+  }
+  auto or_op = [](const auto& x, const auto& y) { return x | y; };
+  auto and_op = [](const auto& x, const auto& y) { return x & y; };
+  for (auto n : {size_t{100}, size_t{1000}, size_t{10000}}) {
+    auto bitmaps = make_bitmaps(n, rows, seed);
+    auto first = bitmaps.begin();
+    auto last = bitmaps.end();
+    measure("OR (pairwise)", n, [&] { return nary_eval(first, last, or_op); });
+    measure("OR (multiway)", n, [&] { return nary_or(first, last); });
+    // Flip the bitmaps so that the AND has a non-trivial result.
+    for (auto& bm : bitmaps)
+      bm.flip();
+    measure("AND (pairwise)", n,
+            [&] { return nary_eval(first, last, and_op); });
+    measure("AND (multiway)", n, [&] { return nary_and(first, last); });
+  }
+}